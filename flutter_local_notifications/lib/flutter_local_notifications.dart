@@ -32,10 +32,16 @@ export 'src/platform_specifics/ios/enums.dart';
 export 'src/platform_specifics/ios/initialization_settings.dart';
 export 'src/platform_specifics/ios/notification_attachment.dart';
 export 'src/platform_specifics/ios/notification_details.dart';
+export 'src/platform_specifics/linux/admission_stats.dart';
 export 'src/platform_specifics/linux/enums.dart';
 export 'src/platform_specifics/linux/icon.dart';
 export 'src/platform_specifics/linux/initialization_settings.dart';
 export 'src/platform_specifics/linux/notification_details.dart';
+export 'src/platform_specifics/linux/notification_request.dart';
+export 'src/platform_specifics/linux/notification_selection.dart';
+export 'src/platform_specifics/linux/plugin_stats.dart';
+export 'src/platform_specifics/linux/recurrence_rule.dart';
+export 'src/platform_specifics/linux/simulated_fire.dart';
 export 'src/platform_specifics/macos/initialization_settings.dart';
 export 'src/platform_specifics/macos/notification_attachment.dart';
 export 'src/platform_specifics/macos/notification_details.dart';
@@ -17,9 +17,16 @@ import 'platform_specifics/ios/enums.dart';
 import 'platform_specifics/ios/initialization_settings.dart';
 import 'platform_specifics/ios/method_channel_mappers.dart';
 import 'platform_specifics/ios/notification_details.dart';
+import 'platform_specifics/linux/admission_stats.dart';
+import 'platform_specifics/linux/binary_codec.dart';
 import 'platform_specifics/linux/initialization_settings.dart';
 import 'platform_specifics/linux/method_channel_mappers.dart';
 import 'platform_specifics/linux/notification_details.dart';
+import 'platform_specifics/linux/notification_request.dart';
+import 'platform_specifics/linux/notification_selection.dart';
+import 'platform_specifics/linux/plugin_stats.dart';
+import 'platform_specifics/linux/recurrence_rule.dart';
+import 'platform_specifics/linux/simulated_fire.dart';
 import 'platform_specifics/macos/initialization_settings.dart';
 import 'platform_specifics/macos/method_channel_mappers.dart';
 import 'platform_specifics/macos/notification_details.dart';
@@ -669,7 +676,13 @@ class MacOSFlutterLocalNotificationsPlugin
 class LinuxFlutterLocalNotificationsPlugin
     extends MethodChannelFlutterLocalNotificationsPlugin {
   SelectNotificationCallback _onSelectNotification;
+  LinuxSelectNotificationsCallback _onSelectNotifications;
   LinuxNotificationNotifier _notificationNotifier;
+  bool _useBinaryChannel = false;
+
+  static const BasicMessageChannel<ByteData> _binaryChannel =
+      BasicMessageChannel<ByteData>(
+          'dexterous.com/flutter/local_notifications/binary', BinaryCodec());
 
   /// Initializes the plugin.
   ///
@@ -677,12 +690,20 @@ class LinuxFlutterLocalNotificationsPlugin
   /// This should only be done once. When a notification created by this plugin
   /// was used to launch the app, calling `initialize` is what will trigger to
   /// the `onSelectNotification` callback to be fire.
+  ///
+  /// Selections are buffered by the plugin until then, and delivered in
+  /// batches. [onSelectNotifications] receives each batch, including which
+  /// button was selected, while [onSelectNotification] is triggered with the
+  /// payload of each selection.
   Future<bool> initialize(
     LinuxInitializationSettings initializationSettings, {
     SelectNotificationCallback onSelectNotification,
+    LinuxSelectNotificationsCallback onSelectNotifications,
   }) async {
     _onSelectNotification = onSelectNotification;
+    _onSelectNotifications = onSelectNotifications;
     _notificationNotifier = initializationSettings.notificationNotifier;
+    _useBinaryChannel = initializationSettings.useBinaryChannel ?? false;
     _channel.setMethodCallHandler(_handleMethod);
     return await _channel.invokeMethod(
         'initialize', initializationSettings?.toMap());
@@ -697,6 +718,12 @@ class LinuxFlutterLocalNotificationsPlugin
     String payload,
   }) async {
     validateId(id);
+    if (_useBinaryChannel) {
+      await _sendBinary(
+          encodeShow(id, title, body, payload, notificationDetails));
+      _notificationNotifier?.onNewNotificationCreated(id);
+      return;
+    }
     await _channel.invokeMethod('show', <String, Object>{
       'id': id,
       'title': title,
@@ -707,6 +734,31 @@ class LinuxFlutterLocalNotificationsPlugin
     _notificationNotifier?.onNewNotificationCreated(id);
   }
 
+  /// Shows a notification like [show], or updates the one shown with the same
+  /// id, for notifications updated frequently like progress.
+  ///
+  /// The update is dropped if nothing changed since the notification was
+  /// last sent, and updates of the same id are sent at most once per
+  /// [LinuxInitializationSettings.updateCoalescingWindow], with only the
+  /// last of the updates received meanwhile being sent.
+  Future<void> update(
+    int id,
+    String title,
+    String body, {
+    LinuxNotificationDetails notificationDetails,
+    String payload,
+  }) async {
+    validateId(id);
+    await _channel.invokeMethod('update', <String, Object>{
+      'id': id,
+      'title': title,
+      'body': body,
+      'payload': payload ?? '',
+      'platformSpecifics': notificationDetails?.toMap(),
+    });
+    _notificationNotifier?.onNewNotificationCreated(id);
+  }
+
   @override
   Future<void> periodicallyShow(
     int id,
@@ -717,6 +769,12 @@ class LinuxFlutterLocalNotificationsPlugin
     String payload,
   }) async {
     validateId(id);
+    if (_useBinaryChannel) {
+      await _sendBinary(encodePeriodicallyShow(id, title, body, payload,
+          notificationDetails, repeatInterval.index));
+      _notificationNotifier?.onNewNotificationCreated(id);
+      return;
+    }
     await _channel.invokeMethod('periodicallyShow', <String, Object>{
       'id': id,
       'title': title,
@@ -730,6 +788,10 @@ class LinuxFlutterLocalNotificationsPlugin
 
   /// Schedules a notification to be shown at the specified date and time
   /// relative to a specific time zone.
+  ///
+  /// The notification repeats according to either [matchDateTimeComponents]
+  /// or [recurrence], which allows rules like every weekday or the first
+  /// Monday of every month with a single id.
   Future<void> zonedSchedule(
     int id,
     String title,
@@ -738,9 +800,25 @@ class LinuxFlutterLocalNotificationsPlugin
     LinuxNotificationDetails notificationDetails, {
     String payload,
     DateTimeComponents matchDateTimeComponents,
+    LinuxRecurrenceRule recurrence,
   }) async {
     validateId(id);
     validateDateIsInTheFuture(scheduledDate);
+    assert(matchDateTimeComponents == null || recurrence == null);
+    if (_useBinaryChannel && recurrence == null) {
+      final Map<String, Object> serializedDate = scheduledDate.toMap();
+      await _sendBinary(encodeZonedSchedule(
+          id,
+          title,
+          body,
+          payload,
+          notificationDetails,
+          serializedDate['timeZoneName'],
+          serializedDate['scheduledDateTime'],
+          matchDateTimeComponents?.index));
+      _notificationNotifier?.onNewNotificationCreated(id);
+      return;
+    }
     final Map<String, Object> serializedPlatformSpecifics =
         notificationDetails?.toMap();
     await _channel.invokeMethod(
@@ -752,7 +830,8 @@ class LinuxFlutterLocalNotificationsPlugin
           'platformSpecifics': serializedPlatformSpecifics,
           'payload': payload ?? '',
           if (matchDateTimeComponents != null)
-            'matchDateTimeComponents': matchDateTimeComponents.index
+            'matchDateTimeComponents': matchDateTimeComponents.index,
+          if (recurrence != null) 'recurrence': recurrence.toMap(),
         }..addAll(scheduledDate.toMap()));
     _notificationNotifier?.onNewNotificationCreated(id);
   }
@@ -760,7 +839,11 @@ class LinuxFlutterLocalNotificationsPlugin
   @override
   Future<void> cancel(int id) async {
     validateId(id);
-    await _channel.invokeMethod('cancel', id);
+    if (_useBinaryChannel) {
+      await _sendBinary(encodeCancel(id));
+    } else {
+      await _channel.invokeMethod('cancel', id);
+    }
     _notificationNotifier?.onNotificationDestroyed(id);
   }
 
@@ -774,15 +857,271 @@ class LinuxFlutterLocalNotificationsPlugin
     }
   }
 
+  /// Returns the list of active notifications shown by the application that
+  /// haven't been cancelled.
+  ///
+  /// On Linux, notifications dismissed by the user cannot always be told
+  /// apart from the ones still shown, so they may be reported as well.
+  Future<List<ActiveNotification>> getActiveNotifications() async {
+    final List<Map<Object, Object>> activeNotifications =
+        await _channel.invokeListMethod('getActiveNotifications');
+    return activeNotifications
+        // ignore: always_specify_types
+        ?.map((a) => ActiveNotification(
+              a['id'],
+              null,
+              a['title'],
+              a['body'],
+            ))
+        ?.toList();
+  }
+
+  /// Returns the counters of the queue rate limiting notifications, see
+  /// [LinuxAdmissionSettings].
+  Future<LinuxAdmissionStats> getAdmissionStats() async {
+    final Map<Object, Object> stats =
+        await _channel.invokeMapMethod('getAdmissionStats');
+    return LinuxAdmissionStats(
+      stats['queued'],
+      stats['sent'],
+      stats['deferred'],
+      stats['dropped'],
+    );
+  }
+
+  /// Returns the runtime metrics of the plugin.
+  ///
+  /// Latency histograms are only available if the plugin was built with
+  /// the `FLUTTER_LOCAL_NOTIFICATIONS_METRICS` CMake option, which is on by
+  /// default.
+  Future<LinuxPluginStats> getStats() async {
+    final Map<dynamic, dynamic> stats =
+        await _channel.invokeMethod('getStats');
+    final Map<dynamic, dynamic> gauges = stats['gauges'];
+    final Map<dynamic, dynamic> methods = stats['methods'];
+    return LinuxPluginStats(
+      enabled: stats['enabled'],
+      activeCount: gauges['active'],
+      scheduledCount: gauges['scheduled'],
+      repeatingCount: gauges['repeating'],
+      queuedCount: gauges['queued'],
+      inFlightCount: gauges['inFlight'],
+      droppedCount: stats['dropped'],
+      methods: methods?.map((dynamic k, dynamic v) =>
+          MapEntry<String, LinuxHistogram>(k, _histogramFromMap(v))),
+      send: _histogramFromMap(stats['send']),
+      fireLateness: _histogramFromMap(stats['fireLateness']),
+    );
+  }
+
+  LinuxHistogram _histogramFromMap(Map<dynamic, dynamic> map) => map == null
+      ? null
+      : LinuxHistogram(
+          map['unit'],
+          map['count'],
+          map['sum'],
+          map['max'],
+          List<int>.from(map['buckets']),
+        );
+
+  /// Returns the trace events recorded since `initialize` enabled tracing
+  /// with [LinuxInitializationSettings.traceEventCapacity], in the JSON
+  /// format of Chrome's trace viewer, which Perfetto loads as well.
+  ///
+  /// The events are written to [path] instead if it is given, and `null` is
+  /// returned. Their timestamps are from the same clock as the ones of
+  /// Flutter's timeline.
+  Future<String> dumpTrace({String path}) =>
+      _channel.invokeMethod<String>('dumpTrace', <String, Object>{
+        'path': path,
+      });
+
+  /// Switches the plugin to virtual time starting at [startTime], which is
+  /// meant for testing schedules.
+  ///
+  /// Afterwards scheduled notifications only fire when virtual time is moved
+  /// by [advanceSimulation], and notifications are recorded instead of being
+  /// sent to the notification server. Notifications scheduled before are
+  /// kept, schedules are no longer persisted and notifications are no longer
+  /// rate limited.
+  Future<void> enableSimulation(DateTime startTime) =>
+      _channel.invokeMethod('enableSimulation', <String, Object>{
+        'startTime': startTime.microsecondsSinceEpoch,
+      });
+
+  /// Moves virtual time to [until], firing every notification scheduled
+  /// until then as fast as possible.
+  ///
+  /// Returns the number of notifications fired.
+  Future<int> advanceSimulation(DateTime until) async {
+    final Map<dynamic, dynamic> result =
+        await _channel.invokeMethod('advanceSimulation', <String, Object>{
+      'until': until.microsecondsSinceEpoch,
+    });
+    return result['fired'];
+  }
+
+  /// Moves virtual time to [until] as if the system was suspended meanwhile,
+  /// then fires every notification which became due in one pass, following
+  /// their [LinuxNotificationDetails.misfirePolicy].
+  ///
+  /// Returns the number of notifications fired, which excludes skipped and
+  /// coalesced ones.
+  Future<int> suspendSimulation(DateTime until) async {
+    final Map<dynamic, dynamic> result =
+        await _channel.invokeMethod('suspendSimulation', <String, Object>{
+      'until': until.microsecondsSinceEpoch,
+    });
+    return result['fired'];
+  }
+
+  /// Changes the system time zone of the simulation to [timeZoneName], as if
+  /// the user travelled there.
+  ///
+  /// Notifications scheduled in the previous zone keep their local time, see
+  /// [LinuxInitializationSettings.followSystemTimeZone]. The first call only
+  /// sets the zone, unless it is already known from the system.
+  ///
+  /// Returns the number of notifications moved to the new zone.
+  Future<int> changeSimulatedTimeZone(String timeZoneName) async {
+    final Map<dynamic, dynamic> result = await _channel
+        .invokeMethod('changeSimulatedTimeZone', <String, Object>{
+      'timeZoneName': timeZoneName,
+    });
+    return result['moved'];
+  }
+
+  /// Returns the notifications fired by [advanceSimulation] and
+  /// [suspendSimulation] since the last call.
+  Future<List<LinuxSimulatedFire>> takeSimulatedFires() async {
+    final List<int> values =
+        await _channel.invokeMethod('takeSimulatedFires');
+    return List<LinuxSimulatedFire>.generate(
+        values.length ~/ 3,
+        (int i) => LinuxSimulatedFire(
+              values[i * 3],
+              DateTime.fromMicrosecondsSinceEpoch(values[i * 3 + 1]),
+              DateTime.fromMicrosecondsSinceEpoch(values[i * 3 + 2]),
+            ));
+  }
+
+  /// Shows all notifications in [requests] with a single platform channel
+  /// call.
+  ///
+  /// Returns the result of each request in the same order, which is `null`
+  /// if the notification was shown, or a [PlatformException] describing why
+  /// it was not.
+  Future<List<PlatformException>> showBatch(
+      List<LinuxNotificationRequest> requests) async {
+    requests.forEach((LinuxNotificationRequest r) => validateId(r.id));
+    final List<dynamic> results = await _channel.invokeMethod(
+        'showBatch',
+        requests
+            .map((LinuxNotificationRequest r) => r.toMap())
+            .toList(growable: false));
+    return _handleBatchResults(
+        results, requests.map((LinuxNotificationRequest r) => r.id),
+        created: true);
+  }
+
+  /// Schedules all notifications in [requests] with a single platform
+  /// channel call, see [zonedSchedule].
+  ///
+  /// Returns the result of each request in the same order, which is `null`
+  /// if the notification was scheduled, or a [PlatformException] describing
+  /// why it was not.
+  Future<List<PlatformException>> zonedScheduleBatch(
+      List<LinuxZonedScheduleRequest> requests) async {
+    for (final LinuxZonedScheduleRequest request in requests) {
+      validateId(request.id);
+      validateDateIsInTheFuture(request.scheduledDate);
+    }
+    final List<dynamic> results = await _channel.invokeMethod(
+        'zonedScheduleBatch',
+        requests
+            .map((LinuxZonedScheduleRequest r) => r.toMap())
+            .toList(growable: false));
+    return _handleBatchResults(
+        results, requests.map((LinuxZonedScheduleRequest r) => r.id),
+        created: true);
+  }
+
+  /// Cancels all notifications in [ids] with a single platform channel call.
+  ///
+  /// Returns the result of each id in the same order, which is `null` if the
+  /// notification was cancelled, or a [PlatformException] describing why it
+  /// was not.
+  Future<List<PlatformException>> cancelBatch(List<int> ids) async {
+    ids.forEach(validateId);
+    final List<dynamic> results =
+        await _channel.invokeMethod('cancelBatch', ids);
+    return _handleBatchResults(results, ids, created: false);
+  }
+
+  List<PlatformException> _handleBatchResults(
+      List<dynamic> results, Iterable<int> ids,
+      {@required bool created}) {
+    final List<PlatformException> errors = <PlatformException>[];
+    final Iterator<int> idIterator = ids.iterator;
+    for (final dynamic result in results) {
+      idIterator.moveNext();
+      if (result is Map) {
+        errors.add(PlatformException(
+            code: result['code'],
+            message: result['message'],
+            details: result['details']));
+        continue;
+      }
+      errors.add(null);
+      if (created) {
+        _notificationNotifier?.onNewNotificationCreated(idIterator.current);
+      } else {
+        _notificationNotifier?.onNotificationDestroyed(idIterator.current);
+      }
+    }
+    return errors;
+  }
+
+  Future<void> _sendBinary(ByteData message) async {
+    final PlatformException error =
+        decodeBinaryReply(await _binaryChannel.send(message));
+    if (error != null) {
+      throw error;
+    }
+  }
+
   Future<void> _handleMethod(MethodCall call) {
     switch (call.method) {
-      case 'selectNotification':
-        final Map<dynamic, dynamic> args = call.arguments;
-        _onSelectNotification(args['payload']);
-        break;
+      case 'selectNotifications':
+        return _selectNotifications(call.arguments);
+      case 'notificationsEvicted':
+        final List<int> ids = call.arguments;
+        if (_notificationNotifier != null) {
+          ids.forEach(_notificationNotifier.onNotificationDestroyed);
+        }
+        return Future<void>.value();
       default:
         return Future<void>.error('Method not defined');
     }
-    return Future<void>.value();
+  }
+
+  Future<void> _selectNotifications(Map<dynamic, dynamic> batch) async {
+    final List<int> ids = batch['ids'];
+    final List<dynamic> payloads = batch['payloads'];
+    final List<int> buttons = batch['buttons'];
+    final List<LinuxNotificationSelection> selections =
+        List<LinuxNotificationSelection>.generate(
+      ids.length,
+      (int i) => LinuxNotificationSelection(
+          ids[i], payloads[i], buttons[i] < 0 ? null : buttons[i]),
+    );
+    if (_onSelectNotifications != null) {
+      await _onSelectNotifications(selections);
+    }
+    if (_onSelectNotification != null) {
+      for (final LinuxNotificationSelection selection in selections) {
+        await _onSelectNotification(selection.payload);
+      }
+    }
   }
 }
@@ -0,0 +1,21 @@
+import 'initialization_settings.dart';
+
+/// Counters of the queue rate limiting notifications on Linux, see
+/// [LinuxAdmissionSettings].
+class LinuxAdmissionStats {
+  /// Constructs an instance of [LinuxAdmissionStats].
+  const LinuxAdmissionStats(
+      this.queued, this.sent, this.deferred, this.dropped);
+
+  /// Number of notifications currently waiting to be sent.
+  final int queued;
+
+  /// Number of notifications sent since the plugin was registered.
+  final int sent;
+
+  /// Number of notifications that had to wait before being sent.
+  final int deferred;
+
+  /// Number of notifications dropped because the queue was full.
+  final int dropped;
+}
@@ -0,0 +1,136 @@
+import 'dart:convert';
+import 'dart:typed_data';
+
+import 'package:flutter/foundation.dart';
+import 'package:flutter/services.dart';
+
+import 'notification_details.dart';
+
+// Operations of the binary channel, same values as BinaryOperation on native
+// side, which also describes the layout of the messages.
+const int _show = 1;
+const int _cancel = 2;
+const int _periodicallyShow = 3;
+const int _zonedSchedule = 4;
+
+const int _nullLength = 0xffffffff;
+
+const int _iconFlag = 1 << 0;
+const int _priorityFlag = 1 << 1;
+const int _misfirePolicyFlag = 1 << 2;
+const int _groupKeyFlag = 1 << 3;
+
+void _putUint32(WriteBuffer buffer, int value) =>
+    buffer.putUint32(value, endian: Endian.little);
+
+void _putBytes(WriteBuffer buffer, Uint8List bytes) {
+  _putUint32(buffer, bytes.length);
+  buffer.putUint8List(bytes);
+}
+
+void _putString(WriteBuffer buffer, String value) {
+  if (value == null) {
+    _putUint32(buffer, _nullLength);
+    return;
+  }
+  _putBytes(buffer, utf8.encoder.convert(value));
+  buffer.putUint8(0);
+}
+
+void _putDetails(WriteBuffer buffer, LinuxNotificationDetails details) {
+  final Object iconContent = details?.icon?.content;
+  final int flags = (iconContent != null ? _iconFlag : 0) |
+      (details?.priority != null ? _priorityFlag : 0) |
+      (details?.misfirePolicy != null ? _misfirePolicyFlag : 0) |
+      (details?.groupKey != null ? _groupKeyFlag : 0);
+  buffer.putUint8(flags);
+  if (iconContent != null) {
+    buffer.putUint8(details.icon.source.index);
+    _putBytes(
+        buffer,
+        iconContent is Uint8List
+            ? iconContent
+            : utf8.encoder.convert(iconContent.toString()));
+  }
+  if (details?.priority != null) {
+    buffer.putUint8(details.priority.index);
+  }
+  if (details?.misfirePolicy != null) {
+    buffer.putUint8(details.misfirePolicy.index);
+  }
+  if (details?.groupKey != null) {
+    _putString(buffer, details.groupKey);
+  }
+  final Set<LinuxNotificationButton> buttons =
+      details?.buttons ?? const <LinuxNotificationButton>{};
+  assert(buttons.length <= 0xff);
+  buffer.putUint8(buttons.length);
+  for (final LinuxNotificationButton button in buttons) {
+    _putString(buffer, button.label);
+    _putString(buffer, button.payload);
+  }
+}
+
+WriteBuffer _notification(int operation, int id, String title, String body,
+    String payload, LinuxNotificationDetails details) {
+  final WriteBuffer buffer = WriteBuffer()
+    ..putUint8(operation)
+    ..putInt32(id, endian: Endian.little);
+  _putString(buffer, title);
+  _putString(buffer, body);
+  _putString(buffer, payload ?? '');
+  _putDetails(buffer, details);
+  return buffer;
+}
+
+/// Encodes a message of the binary channel which shows a notification.
+ByteData encodeShow(int id, String title, String body, String payload,
+        LinuxNotificationDetails details) =>
+    _notification(_show, id, title, body, payload, details).done();
+
+/// Encodes a message of the binary channel which cancels a notification.
+ByteData encodeCancel(int id) => (WriteBuffer()
+      ..putUint8(_cancel)
+      ..putInt32(id, endian: Endian.little))
+    .done();
+
+/// Encodes a message of the binary channel which shows a notification
+/// periodically, repeatInterval is the index of `RepeatInterval`.
+ByteData encodePeriodicallyShow(int id, String title, String body,
+        String payload, LinuxNotificationDetails details, int repeatInterval) =>
+    (_notification(_periodicallyShow, id, title, body, payload, details)
+          ..putUint8(repeatInterval))
+        .done();
+
+/// Encodes a message of the binary channel which schedules a notification,
+/// matchDateTimeComponents is the index of `DateTimeComponents`, if any.
+ByteData encodeZonedSchedule(
+    int id,
+    String title,
+    String body,
+    String payload,
+    LinuxNotificationDetails details,
+    String timeZoneName,
+    String scheduledDateTime,
+    int matchDateTimeComponents) {
+  final WriteBuffer buffer =
+      _notification(_zonedSchedule, id, title, body, payload, details);
+  _putString(buffer, timeZoneName);
+  _putString(buffer, scheduledDateTime);
+  buffer.putUint8((matchDateTimeComponents ?? -1) & 0xff);
+  return buffer.done();
+}
+
+/// Decodes the reply to a message of the binary channel, which is empty on
+/// success, or the code and message of the error separated by a null
+/// character.
+PlatformException decodeBinaryReply(ByteData reply) {
+  if (reply == null || reply.lengthInBytes == 0) {
+    return null;
+  }
+  final Uint8List bytes =
+      reply.buffer.asUint8List(reply.offsetInBytes, reply.lengthInBytes);
+  final List<String> error = utf8.decode(bytes).split('\u0000');
+  return PlatformException(
+      code: error.first, message: error.length > 1 ? error[1] : null);
+}
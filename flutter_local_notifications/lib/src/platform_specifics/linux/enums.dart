@@ -9,3 +9,88 @@ enum LinuxIconSource {
   /// Icon from theme, with a name, see [ThemeLinuxIcon].
   theme,
 }
+
+/// Specifies how notifications are sent to the notification server.
+enum LinuxNotificationBackend {
+  /// Notifications are sent through `GApplication`, which picks the
+  /// notification portal or the `org.freedesktop.Notifications` server.
+  gApplication,
+
+  /// Notifications are sent to the `org.freedesktop.Notifications` server on
+  /// the session bus directly.
+  ///
+  /// Showing a notification with the id of a shown notification replaces it
+  /// in place, and notifications closed by the user are no longer reported
+  /// by `getActiveNotifications`. This backend is not available in sandboxes
+  /// without access to the session bus.
+  freedesktop,
+}
+
+/// Priority of a notification on Linux.
+///
+/// Besides being forwarded to the notification server, the priority decides
+/// the order in which rate limited notifications are sent, see
+/// [LinuxAdmissionSettings].
+enum LinuxNotificationPriority {
+  /// Low priority.
+  low,
+
+  /// Normal priority.
+  normal,
+
+  /// High priority.
+  high,
+
+  /// Urgent priority, these notifications are never rate limited.
+  urgent,
+}
+
+/// Unit of the interval of a [LinuxRecurrenceRule].
+enum LinuxRecurrenceFrequency {
+  /// Repeats every few minutes.
+  minutely,
+
+  /// Repeats every few hours.
+  hourly,
+
+  /// Repeats every few days.
+  daily,
+
+  /// Repeats every few weeks.
+  weekly,
+
+  /// Repeats every few months.
+  monthly,
+}
+
+/// What happens when a scheduled notification on Linux missed its time by
+/// more than [LinuxInitializationSettings.misfireThreshold], for example
+/// because the system was suspended.
+enum LinuxMisfirePolicy {
+  /// The notification is shown once, and later occurrences which were missed
+  /// as well are skipped.
+  fireOnce,
+
+  /// The notification fires once for every occurrence which was missed, up
+  /// to 16 in a row. Fires which wait for the rate limit of
+  /// [LinuxAdmissionSettings] replace each other.
+  fireAll,
+
+  /// The missed notification is not shown.
+  skip,
+
+  /// Missed notifications with this policy are summarized in one
+  /// notification, see [LinuxMisfireSummary].
+  coalesce,
+}
+
+/// What happens to the notifications evicted on Linux once a group has more
+/// than [LinuxActiveLimit.maxActivePerGroup] notifications shown.
+enum LinuxEvictionPolicy {
+  /// The notification is withdrawn.
+  withdraw,
+
+  /// The notification is withdrawn and listed by a summary notification of
+  /// its group.
+  summarize,
+}
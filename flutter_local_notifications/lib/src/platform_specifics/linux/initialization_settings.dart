@@ -1,4 +1,8 @@
+import 'package:meta/meta.dart';
+
+import 'enums.dart';
 import 'icon.dart';
+import 'notification_details.dart';
 
 /// Notify user when notifications are created and destroyed
 ///
@@ -14,13 +18,94 @@ abstract class LinuxNotificationNotifier {
   void onNotificationDestroyed(int notificationId);
 }
 
+/// Limits how fast notifications are sent to the notification server.
+///
+/// Notifications are sent at up to [rate] per second on average, with bursts
+/// of up to [burst] notifications. Notifications over the limit wait in a
+/// queue, ordered by their [LinuxNotificationDetails.priority], which holds
+/// at most [maxQueueDepth] notifications. When the queue is full, the
+/// oldest notification of the lowest priority is dropped.
+class LinuxAdmissionSettings {
+  /// Construct an instance of [LinuxAdmissionSettings].
+  const LinuxAdmissionSettings(
+      {this.rate = 20, this.burst = 20, this.maxQueueDepth = 512});
+
+  /// Average number of notifications sent per second, or zero to disable
+  /// rate limiting.
+  final double rate;
+
+  /// Maximum number of notifications sent at once.
+  final int burst;
+
+  /// Maximum number of notifications waiting to be sent.
+  final int maxQueueDepth;
+}
+
+/// The notification which summarizes scheduled notifications which missed
+/// their time with [LinuxMisfirePolicy.coalesce].
+///
+/// Its body lists the titles of the notifications summarized.
+class LinuxMisfireSummary {
+  /// Construct an instance of [LinuxMisfireSummary].
+  const LinuxMisfireSummary(
+      {this.id = 0x7fffffff, this.title = 'Missed notifications'});
+
+  /// Id of the summary, which must not be used by other notifications.
+  final int id;
+
+  /// Title of the summary.
+  final String title;
+}
+
+/// Limits how many notifications of a group are shown at once, see
+/// [LinuxNotificationDetails.groupKey].
+///
+/// Once a group has more than [maxActivePerGroup] notifications shown, the
+/// ones shown least recently are evicted as [policy] says. Evicted
+/// notifications are reported to
+/// [LinuxNotificationNotifier.onNotificationDestroyed] unless they are still
+/// pending.
+class LinuxActiveLimit {
+  /// Construct an instance of [LinuxActiveLimit].
+  const LinuxActiveLimit(
+      {@required this.maxActivePerGroup,
+      this.policy = LinuxEvictionPolicy.withdraw,
+      this.summaryTitle = 'Earlier notifications',
+      this.summaryBaseId = 0x7ffffffe});
+
+  /// Maximum number of notifications of a group which are shown at once.
+  final int maxActivePerGroup;
+
+  /// What happens to evicted notifications.
+  final LinuxEvictionPolicy policy;
+
+  /// Title of the summary of notifications without a group key, summaries of
+  /// other groups are titled by their group key.
+  final String summaryTitle;
+
+  /// Id of the first summary, the summaries of further groups count down
+  /// from it. These ids must not be used by other notifications.
+  final int summaryBaseId;
+}
+
 /// Plugin initialization settings for Linux.
 class LinuxInitializationSettings {
   /// Construct an instance of [LinuxInitializationSettings].
   const LinuxInitializationSettings(
       {this.defaultIcon,
       this.notificationNotifier,
-      this.knownShowingNotifications});
+      this.knownShowingNotifications,
+      this.admission,
+      this.backend = LinuxNotificationBackend.gApplication,
+      this.iconSize,
+      this.updateCoalescingWindow,
+      this.useBinaryChannel = false,
+      this.schedulerHelper = false,
+      this.misfireThreshold,
+      this.misfireSummary,
+      this.activeLimit,
+      this.followSystemTimeZone = true,
+      this.traceEventCapacity});
 
   /// Specifies the default icon for notifications.
   final LinuxIcon defaultIcon;
@@ -30,4 +115,70 @@ class LinuxInitializationSettings {
 
   /// Known currently showing notifications.
   final Set<int> knownShowingNotifications;
+
+  /// Rate limit of notifications sent to the notification server.
+  final LinuxAdmissionSettings admission;
+
+  /// How notifications are sent to the notification server.
+  final LinuxNotificationBackend backend;
+
+  /// Maximum width and height of icons in pixels.
+  ///
+  /// Icons from files or bytes which are larger are downscaled once, in the
+  /// background, before being sent to the notification server. Defaults to
+  /// 256.
+  final int iconSize;
+
+  /// Minimum time between two updates of the same notification sent by
+  /// `update`.
+  ///
+  /// Updates which arrive sooner are held until the window has passed, and
+  /// only the last of them is sent. Defaults to 100 milliseconds, i.e. at
+  /// most 10 updates per second per notification.
+  final Duration updateCoalescingWindow;
+
+  /// Whether `show`, `cancel`, `periodicallyShow` and `zonedSchedule` are
+  /// sent through a channel with a compact binary encoding instead of the
+  /// method channel, which is cheaper for apps sending many notifications.
+  ///
+  /// `zonedSchedule` with a recurrence rule always uses the method channel.
+  final bool useBinaryChannel;
+
+  /// Whether scheduled notifications also fire while the app is not running.
+  ///
+  /// Pending notifications are handed to a small helper process bundled with
+  /// the plugin, which sends them itself once the app has exited and launches
+  /// the app when one of them is selected. The selection is then delivered
+  /// to the callbacks passed to `initialize`.
+  final bool schedulerHelper;
+
+  /// How late a scheduled notification may fire before its
+  /// [LinuxNotificationDetails.misfirePolicy] applies.
+  ///
+  /// Defaults to one minute.
+  final Duration misfireThreshold;
+
+  /// The notification which summarizes missed notifications.
+  final LinuxMisfireSummary misfireSummary;
+
+  /// Limits how many notifications are shown at once, which is not limited by
+  /// default.
+  final LinuxActiveLimit activeLimit;
+
+  /// Whether notifications scheduled by `zonedSchedule` in the time zone of
+  /// the system keep their local time when the system time zone changes.
+  ///
+  /// For example a daily reminder at 8:00 scheduled in `Europe/Berlin` while
+  /// the system is in that zone fires at 8:00 in `America/New_York` once the
+  /// user travelled there and the system follows. Notifications scheduled in
+  /// other zones keep firing at the same instant.
+  final bool followSystemTimeZone;
+
+  /// Number of the last lifecycle events of notifications kept for
+  /// `dumpTrace`, which is disabled unless this is set.
+  ///
+  /// Method calls, schedules being armed and firing, notifications being
+  /// built and sent, and their activations are recorded with their
+  /// notification id.
+  final int traceEventCapacity;
 }
@@ -1,8 +1,12 @@
 import 'dart:typed_data';
 
+import '../../types.dart';
+import '../../tz_datetime_mapper.dart';
 import 'icon.dart';
 import 'initialization_settings.dart';
 import 'notification_details.dart';
+import 'notification_request.dart';
+import 'recurrence_rule.dart';
 
 // ignore_for_file: public_member_api_docs
 
@@ -19,6 +23,40 @@ extension LinuxInitializationSettingsMapper on LinuxInitializationSettings {
         'knownShowingNotifications': knownShowingNotifications == null
             ? null
             : Int64List.fromList(knownShowingNotifications.toList()),
+        'admission': admission?.toMap(),
+        'backend': backend?.index,
+        'iconSize': iconSize,
+        'updateCoalescingWindow': updateCoalescingWindow?.inMicroseconds,
+        'schedulerHelper': schedulerHelper,
+        'misfireThreshold': misfireThreshold?.inMicroseconds,
+        'misfireSummary': misfireSummary?.toMap(),
+        'activeLimit': activeLimit?.toMap(),
+        'followSystemTimeZone': followSystemTimeZone,
+        'traceEventCapacity': traceEventCapacity,
+      };
+}
+
+extension LinuxAdmissionSettingsMapper on LinuxAdmissionSettings {
+  Map<String, Object> toMap() => <String, Object>{
+        'rate': rate,
+        'burst': burst,
+        'maxQueueDepth': maxQueueDepth,
+      };
+}
+
+extension LinuxMisfireSummaryMapper on LinuxMisfireSummary {
+  Map<String, Object> toMap() => <String, Object>{
+        'id': id,
+        'title': title,
+      };
+}
+
+extension LinuxActiveLimitMapper on LinuxActiveLimit {
+  Map<String, Object> toMap() => <String, Object>{
+        'maxActivePerGroup': maxActivePerGroup,
+        'policy': policy.index,
+        'summaryTitle': summaryTitle,
+        'summaryBaseId': summaryBaseId,
       };
 }
 
@@ -34,5 +72,47 @@ extension LinuxNotificationDetailsMapper on LinuxNotificationDetails {
   Map<String, Object> toMap() => <String, Object>{
         'icon': icon?.toMap(),
         'buttons': buttons?.serializeToList(),
+        'priority': priority?.index,
+        'misfirePolicy': misfirePolicy?.index,
+        'groupKey': groupKey,
+      };
+}
+
+extension LinuxNotificationRequestMapper on LinuxNotificationRequest {
+  Map<String, Object> toMap() => <String, Object>{
+        'id': id,
+        'title': title,
+        'body': body,
+        'payload': payload ?? '',
+        'platformSpecifics': notificationDetails?.toMap(),
+      };
+}
+
+extension LinuxZonedScheduleRequestMapper on LinuxZonedScheduleRequest {
+  Map<String, Object> toMap() => <String, Object>{
+        'id': id,
+        'title': title,
+        'body': body,
+        'payload': payload ?? '',
+        'platformSpecifics': notificationDetails?.toMap(),
+        if (matchDateTimeComponents != null)
+          'matchDateTimeComponents': matchDateTimeComponents.index,
+        if (recurrence != null) 'recurrence': recurrence.toMap(),
+      }..addAll(scheduledDate.toMap());
+}
+
+extension LinuxRecurrenceRuleMapper on LinuxRecurrenceRule {
+  Map<String, Object> toMap() => <String, Object>{
+        'frequency': frequency.index,
+        'interval': interval,
+        // from 1 for Monday to 7 for Sunday, unlike Day
+        'weekdays': weekdays
+            ?.map((Day d) => d == Day.sunday ? 7 : d.value - 1)
+            ?.toList(growable: false),
+        'weekOfMonth': weekOfMonth,
+        'endTime': endTime == null
+            ? null
+            : endTime.hour * 3600 + endTime.minute * 60 + endTime.second,
+        'until': until?.microsecondsSinceEpoch,
       };
 }
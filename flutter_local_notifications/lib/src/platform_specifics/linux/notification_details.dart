@@ -1,5 +1,6 @@
 import 'package:meta/meta.dart';
 
+import 'enums.dart';
 import 'icon.dart';
 
 /// Details of notification button on Linux.
@@ -18,11 +19,32 @@ class LinuxNotificationButton {
 /// Configures notification details specific to Linux.
 class LinuxNotificationDetails {
   /// Construct an instance of [LinuxNotificationDetails].
-  const LinuxNotificationDetails({this.icon, this.buttons});
+  const LinuxNotificationDetails(
+      {this.icon,
+      this.buttons,
+      this.priority,
+      this.misfirePolicy,
+      this.groupKey});
 
   /// The icon used by this notification.
   final LinuxIcon icon;
 
   /// The buttons of this notification.
   final Set<LinuxNotificationButton> buttons;
+
+  /// The priority of this notification.
+  ///
+  /// Defaults to [LinuxNotificationPriority.normal].
+  final LinuxNotificationPriority priority;
+
+  /// What happens if this notification is scheduled and misses its time.
+  ///
+  /// Defaults to [LinuxMisfirePolicy.fireOnce].
+  final LinuxMisfirePolicy misfirePolicy;
+
+  /// The group of this notification, whose shown notifications are limited
+  /// by [LinuxInitializationSettings.activeLimit].
+  ///
+  /// Notifications without a group key share one group.
+  final String groupKey;
 }
@@ -0,0 +1,61 @@
+import 'package:timezone/timezone.dart';
+
+import '../../types.dart';
+import 'notification_details.dart';
+import 'recurrence_rule.dart';
+
+/// Details of a notification to be shown as part of a batch on Linux.
+class LinuxNotificationRequest {
+  /// Constructs an instance of [LinuxNotificationRequest].
+  const LinuxNotificationRequest(
+    this.id,
+    this.title,
+    this.body, {
+    this.notificationDetails,
+    this.payload,
+  });
+
+  /// The notification's id.
+  final int id;
+
+  /// The notification's title.
+  final String title;
+
+  /// The notification's content.
+  final String body;
+
+  /// Linux specific details of the notification.
+  final LinuxNotificationDetails notificationDetails;
+
+  /// Payload which will be passed to the callback when the notification
+  /// is selected.
+  final String payload;
+}
+
+/// Details of a notification to be scheduled as part of a batch on Linux.
+class LinuxZonedScheduleRequest extends LinuxNotificationRequest {
+  /// Constructs an instance of [LinuxZonedScheduleRequest].
+  const LinuxZonedScheduleRequest(
+    int id,
+    String title,
+    String body,
+    this.scheduledDate, {
+    LinuxNotificationDetails notificationDetails,
+    String payload,
+    this.matchDateTimeComponents,
+    this.recurrence,
+  })  : assert(matchDateTimeComponents == null || recurrence == null),
+        super(id, title, body,
+            notificationDetails: notificationDetails, payload: payload);
+
+  /// The date and time the notification should be shown.
+  final TZDateTime scheduledDate;
+
+  /// Indicates which date and time components of [scheduledDate] the
+  /// notification should repeat on, see [DateTimeComponents].
+  final DateTimeComponents matchDateTimeComponents;
+
+  /// How the notification repeats, instead of [matchDateTimeComponents], see
+  /// [LinuxRecurrenceRule].
+  final LinuxRecurrenceRule recurrence;
+}
@@ -0,0 +1,22 @@
+/// A notification, or one of its buttons, selected by the user on Linux.
+class LinuxNotificationSelection {
+  /// Constructs an instance of [LinuxNotificationSelection].
+  const LinuxNotificationSelection(this.id, this.payload, this.buttonIndex);
+
+  /// The notification's id.
+  final int id;
+
+  /// The payload of the notification, or of the button if one was selected.
+  final String payload;
+
+  /// The index of the selected button in `LinuxNotificationDetails.buttons`,
+  /// or `null` if the notification itself was selected.
+  final int buttonIndex;
+}
+
+/// Signature of the callback passed to
+/// `LinuxFlutterLocalNotificationsPlugin.initialize` that is triggered with
+/// the notifications selected since it was last triggered, in order of
+/// selection.
+typedef LinuxSelectNotificationsCallback = Future<dynamic> Function(
+    List<LinuxNotificationSelection> selections);
@@ -0,0 +1,95 @@
+import 'enums.dart';
+import 'initialization_settings.dart';
+
+/// Histogram of values recorded by the plugin on Linux.
+///
+/// Values are counted in power of two buckets, bucket 0 counts values below 1,
+/// and bucket i counts values from 2^(i-1) up to 2^i, exclusive.
+class LinuxHistogram {
+  /// Constructs an instance of [LinuxHistogram].
+  const LinuxHistogram(this.unit, this.count, this.sum, this.max, this.buckets);
+
+  /// Unit of the values, `ns` for nanoseconds or `us` for microseconds.
+  final String unit;
+
+  /// Number of recorded values.
+  final int count;
+
+  /// Sum of the recorded values.
+  final int sum;
+
+  /// Largest recorded value.
+  final int max;
+
+  /// Number of values in each bucket.
+  final List<int> buckets;
+
+  /// Average of the recorded values.
+  double get mean => count == 0 ? 0 : sum / count;
+
+  /// Returns the upper bound of the bucket which contains the [percentile]
+  /// of the recorded values, where [percentile] is between 0 and 100.
+  int percentile(double percentile) {
+    final double rank = count * percentile / 100;
+    int seen = 0;
+    for (int i = 0; i < buckets.length; i++) {
+      seen += buckets[i];
+      if (seen >= rank && seen > 0) {
+        return i == 0 ? 1 : 1 << i;
+      }
+    }
+    return max;
+  }
+}
+
+/// Runtime metrics of the plugin on Linux.
+class LinuxPluginStats {
+  /// Constructs an instance of [LinuxPluginStats].
+  const LinuxPluginStats({
+    this.enabled,
+    this.activeCount,
+    this.scheduledCount,
+    this.repeatingCount,
+    this.queuedCount,
+    this.inFlightCount,
+    this.droppedCount,
+    this.methods,
+    this.send,
+    this.fireLateness,
+  });
+
+  /// Whether the plugin was built with metrics, otherwise only the counts are
+  /// available.
+  final bool enabled;
+
+  /// Number of notifications shown.
+  final int activeCount;
+
+  /// Number of notifications waiting to fire.
+  final int scheduledCount;
+
+  /// Number of scheduled notifications which fire repeatedly.
+  final int repeatingCount;
+
+  /// Number of notifications waiting to be sent, see
+  /// [LinuxAdmissionSettings].
+  final int queuedCount;
+
+  /// Number of notifications sent to the notification server which it did
+  /// not acknowledge yet, only counted by
+  /// [LinuxNotificationBackend.freedesktop].
+  final int inFlightCount;
+
+  /// Number of notifications which the admission queue dropped, because it
+  /// was full, since the plugin was created.
+  final int droppedCount;
+
+  /// Time taken to handle each method call, by method name.
+  final Map<String, LinuxHistogram> methods;
+
+  /// Time taken to send a notification to the notification server.
+  final LinuxHistogram send;
+
+  /// How late scheduled notifications fired.
+  final LinuxHistogram fireLateness;
+}
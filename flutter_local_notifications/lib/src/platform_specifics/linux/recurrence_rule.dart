@@ -0,0 +1,77 @@
+import 'package:flutter/foundation.dart';
+
+import '../../types.dart';
+import 'enums.dart';
+
+/// Describes how a notification scheduled with `zonedSchedule` repeats on
+/// Linux, a subset of the recurrence rules of iCalendar.
+///
+/// The scheduled date is the first possible occurrence, and occurrences keep
+/// their wall clock time in the time zone of the scheduled date across
+/// daylight saving time transitions. An occurrence skipped by a transition
+/// is shown at the end of the transition, and one repeated by a transition
+/// is shown once.
+///
+/// A few examples, for a notification scheduled at 8:00:
+///
+/// ```dart
+/// // every weekday at 8:00
+/// LinuxRecurrenceRule(
+///   frequency: LinuxRecurrenceFrequency.daily,
+///   weekdays: <Day>{Day.monday, Day.tuesday, Day.wednesday, Day.thursday,
+///       Day.friday},
+/// );
+///
+/// // first Monday of every month at 8:00
+/// LinuxRecurrenceRule(
+///   frequency: LinuxRecurrenceFrequency.monthly,
+///   weekdays: <Day>{Day.monday},
+///   weekOfMonth: 1,
+/// );
+///
+/// // every 90 minutes from 8:00 to 20:00
+/// LinuxRecurrenceRule(
+///   frequency: LinuxRecurrenceFrequency.minutely,
+///   interval: 90,
+///   endTime: Time(20),
+/// );
+/// ```
+class LinuxRecurrenceRule {
+  /// Constructs an instance of [LinuxRecurrenceRule].
+  const LinuxRecurrenceRule({
+    @required this.frequency,
+    this.interval = 1,
+    this.weekdays,
+    this.weekOfMonth,
+    this.endTime,
+    this.until,
+  })  : assert(interval >= 1 && interval <= 65535),
+        assert(weekOfMonth == null || (weekOfMonth >= -1 && weekOfMonth <= 5));
+
+  /// Unit of [interval].
+  final LinuxRecurrenceFrequency frequency;
+
+  /// Number of minutes, hours, days, weeks or months between occurrences.
+  final int interval;
+
+  /// Days of the week on which the notification is shown.
+  ///
+  /// Weekly rules default to the day of the week of the scheduled date, and
+  /// other rules to every day.
+  final Set<Day> weekdays;
+
+  /// Which of [weekdays] in the month a monthly rule is shown on, from 1 for
+  /// the first to 5 for the fifth, or -1 for the last.
+  ///
+  /// Monthly rules without [weekdays] are shown on the day of the month of
+  /// the scheduled date, and skip the months without that day.
+  final int weekOfMonth;
+
+  /// The last time of the day minutely and hourly rules are shown at.
+  ///
+  /// These rules restart every day at the time of the scheduled date.
+  final Time endTime;
+
+  /// The rule is not shown after this date.
+  final DateTime until;
+}
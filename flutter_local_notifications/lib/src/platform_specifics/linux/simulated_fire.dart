@@ -0,0 +1,18 @@
+/// A scheduled notification fired while simulating on Linux, see
+/// `LinuxFlutterLocalNotificationsPlugin.enableSimulation`.
+class LinuxSimulatedFire {
+  /// Constructs an instance of [LinuxSimulatedFire].
+  const LinuxSimulatedFire(this.id, this.intended, this.actual);
+
+  /// The notification's id.
+  final int id;
+
+  /// The time the notification was scheduled to fire at.
+  final DateTime intended;
+
+  /// The virtual time the notification fired at.
+  final DateTime actual;
+
+  /// How late the notification fired.
+  Duration get lateness => actual.difference(intended);
+}
@@ -0,0 +1,98 @@
+#include "active_set.h"
+
+namespace flutter_local_notifications {
+  namespace {
+    // titles listed in the body of a summary, the others are counted
+    inline constexpr std::size_t MaxSummaryLines = 8;
+  }
+
+  void ActiveSet::touch(std::int64_t id, const std::string& group, std::vector<std::int64_t>& evicted) {
+    auto& entry = *groups.try_emplace(group).first;
+    const auto iter = items.find(id);
+    if (iter != items.end()) {
+      if (iter->second.group == &entry) {
+        entry.second.splice(entry.second.begin(), entry.second, iter->second.position);
+        return;
+      }
+      unlink(iter->second);
+      items.erase(iter);
+    }
+    entry.second.push_front(id);
+    items.emplace(id, Item{ &entry, entry.second.begin() });
+    if (capacity == 0) {
+      return;
+    }
+    while (entry.second.size() > capacity) {
+      const auto victim = entry.second.back();
+      entry.second.pop_back();
+      items.erase(victim);
+      evicted.push_back(victim);
+    }
+  }
+
+  void ActiveSet::remove(std::int64_t id) {
+    const auto iter = items.find(id);
+    if (iter == items.end()) {
+      return;
+    }
+    unlink(iter->second);
+    items.erase(iter);
+  }
+
+  void ActiveSet::clear() {
+    groups.clear();
+    items.clear();
+  }
+
+  void ActiveSet::unlink(const Item& item) {
+    item.group->second.erase(item.position);
+    if (item.group->second.empty()) {
+      groups.erase(item.group->first);
+    }
+  }
+
+  const EvictionSummaries::Summary& EvictionSummaries::add(const std::string& group, const std::string& title) {
+    auto iter = summaries.find(group);
+    if (iter == summaries.end()) {
+      iter = summaries.emplace(group, Summary{ next_id-- }).first;
+      groups_by_id.emplace(iter->second.id, group);
+    }
+    auto& summary = iter->second;
+    ++summary.count;
+    summary.titles.push_front(title);
+    if (summary.titles.size() > MaxSummaryLines) {
+      summary.titles.pop_back();
+    }
+    return summary;
+  }
+
+  void EvictionSummaries::reset(std::int64_t id) {
+    const auto iter = groups_by_id.find(id);
+    if (iter == groups_by_id.end()) {
+      return;
+    }
+    auto& summary = summaries.at(iter->second);
+    summary.count = 0;
+    summary.titles.clear();
+  }
+
+  void EvictionSummaries::clear() {
+    summaries.clear();
+    groups_by_id.clear();
+    next_id = base_id;
+  }
+
+  std::string EvictionSummaryBody(const EvictionSummaries::Summary& summary) {
+    std::string body;
+    for (const auto& title : summary.titles) {
+      if (!body.empty()) {
+        body.push_back('\n');
+      }
+      body.append(title);
+    }
+    if (summary.count > summary.titles.size()) {
+      body.append("\n…");
+    }
+    return body;
+  }
+}
@@ -0,0 +1,127 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_ACTIVE_SET_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_ACTIVE_SET_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace flutter_local_notifications {
+  // What happens to the notifications evicted from a full group of ActiveSet. Same order
+  // as LinuxEvictionPolicy on Dart side.
+  enum class EvictionPolicy : std::uint8_t {
+    Withdraw,
+    // withdrawn and listed by a summary of their group, see EvictionSummaries
+    Summarize,
+  };
+
+  // Shown notifications by group, in the order they were last shown, so that the ones
+  // shown least recently are evicted once a group has more than capacity. Notifications
+  // without a group share the group of the empty name. All operations are O(1), besides
+  // the evictions.
+  class ActiveSet {
+  public:
+    // capacity of 0 does not limit groups
+    explicit ActiveSet(std::size_t capacity = 0) : capacity(capacity) {
+    }
+
+    ActiveSet(const ActiveSet&) = delete;
+    ActiveSet& operator=(const ActiveSet&) = delete;
+
+    // Does not evict from groups which are already over value, until they are shown to.
+    void setCapacity(std::size_t value) {
+      capacity = value;
+    }
+
+    std::size_t getCapacity() const {
+      return capacity;
+    }
+
+    // Records that id was shown in group, leaving the group it was in before. Appends the
+    // ids evicted from group to evicted, least recently shown first.
+    void touch(std::int64_t id, const std::string& group, std::vector<std::int64_t>& evicted);
+    void remove(std::int64_t id);
+    void clear();
+
+    std::size_t size() const {
+      return items.size();
+    }
+
+  private:
+    // most recently shown first, pointers to the entries of groups stay valid on rehash
+    using Group = std::pair<const std::string, std::list<std::int64_t>>;
+
+    struct Item {
+      Group* group;
+      std::list<std::int64_t>::iterator position;
+    };
+
+    std::size_t capacity;
+    std::unordered_map<std::string, std::list<std::int64_t>> groups;
+    std::unordered_map<std::int64_t, Item> items;
+
+    void unlink(const Item& item);
+  };
+
+  // Summaries of the notifications evicted from each group with EvictionPolicy::Summarize.
+  // Each group gets a summary id of its own, counting down from the base id, which it keeps
+  // when the summary is dismissed.
+  class EvictionSummaries {
+  public:
+    struct Summary {
+      std::int64_t id;
+      // notifications evicted since the summary was last dismissed
+      std::size_t count = 0;
+      // titles of the last ones, most recent first
+      std::deque<std::string> titles;
+    };
+
+    // Summaries of notifications without a group are titled by title, the ones of other
+    // groups by their group.
+    EvictionSummaries(std::int64_t baseId, std::string title) : title(std::move(title)), base_id(baseId), next_id(baseId) {
+    }
+
+    EvictionSummaries(const EvictionSummaries&) = delete;
+    EvictionSummaries& operator=(const EvictionSummaries&) = delete;
+
+    // Groups summarized before keep their ids.
+    void setBaseId(std::int64_t value) {
+      base_id = next_id = value;
+    }
+
+    // Adds a notification evicted from group to its summary, which is returned.
+    const Summary& add(const std::string& group, const std::string& title);
+    // Starts the summary of id over, once it is dismissed or cancelled.
+    void reset(std::int64_t id);
+    void clear();
+
+    void setTitle(std::string value) {
+      title = std::move(value);
+    }
+
+    const std::string& titleOf(const std::string& group) const {
+      return group.empty() ? title : group;
+    }
+
+    bool isSummary(std::int64_t id) const {
+      return groups_by_id.find(id) != groups_by_id.end();
+    }
+
+  private:
+    std::string title;
+    std::int64_t base_id;
+    std::int64_t next_id;
+    std::unordered_map<std::string, Summary> summaries;
+    // Key: summary id, Value: group
+    std::unordered_map<std::int64_t, std::string> groups_by_id;
+  };
+
+  // Lists the titles of summary, one per line.
+  std::string EvictionSummaryBody(const EvictionSummaries::Summary& summary);
+}
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_ACTIVE_SET_H_
@@ -0,0 +1,164 @@
+#include "admission_queue.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace flutter_local_notifications {
+  AdmissionQueue::AdmissionQueue(SendCallback send, DropCallback drop, Config config)
+    : send(std::move(send)), drop(std::move(drop)), config(config), stats{}, tokens(config.burst),
+      last_refill_time(g_get_monotonic_time()), drain_source_id(0) {
+  }
+
+  AdmissionQueue::~AdmissionQueue() {
+    if (drain_source_id) {
+      g_source_remove(drain_source_id);
+    }
+  }
+
+  void AdmissionQueue::configure(Config newConfig) {
+    refill();
+    config = newConfig;
+    tokens = std::min(tokens, config.burst);
+    if (drain_source_id) {
+      g_source_remove(std::exchange(drain_source_id, 0));
+    }
+    drain();
+  }
+
+  void AdmissionQueue::submit(std::int64_t id, GNotification* notification, Priority priority) {
+    const auto iter = queued.find(id);
+    const auto requeued = iter != queued.end();
+    if (requeued) {
+      if (iter->second->priority == priority) {
+        // the older content is obsolete anyway, keep its place in the queue
+        iter->second->notification.reset(G_NOTIFICATION(g_object_ref(notification)));
+        return;
+      }
+      // leave a tombstone in the queue of the former priority
+      iter->second->notification.reset();
+      queued.erase(iter);
+    }
+
+    if (priority == Priority::Urgent || (queued.empty() && takeToken())) {
+      ++stats.sent;
+      send(id, notification);
+      return;
+    }
+
+    if (queued.size() >= config.maxDepth && !dropLowerThan(priority)) {
+      ++stats.dropped;
+      drop(id);
+      return;
+    }
+
+    auto& queue = queues[static_cast<std::size_t>(priority)];
+    queue.push_back(Item{ id, priority, GObjectPtr<GNotification>(G_NOTIFICATION(g_object_ref(notification))) });
+    queued.emplace(id, &queue.back());
+    if (!requeued) {
+      ++stats.deferred;
+    }
+    scheduleDrain();
+  }
+
+  bool AdmissionQueue::remove(std::int64_t id) {
+    const auto iter = queued.find(id);
+    if (iter == queued.end()) {
+      return false;
+    }
+    // leave a tombstone, which is skipped by drain
+    iter->second->notification.reset();
+    queued.erase(iter);
+    return true;
+  }
+
+  void AdmissionQueue::clear() {
+    for (auto& queue : queues) {
+      queue.clear();
+    }
+    queued.clear();
+  }
+
+  void AdmissionQueue::refill() {
+    const auto now = g_get_monotonic_time();
+    if (config.rate > 0) {
+      tokens = std::min(config.burst, tokens + (now - last_refill_time) * config.rate / G_USEC_PER_SEC);
+    }
+    last_refill_time = now;
+  }
+
+  bool AdmissionQueue::takeToken() {
+    if (config.rate <= 0) {
+      return true;
+    }
+    refill();
+    if (tokens < 1) {
+      return false;
+    }
+    tokens -= 1;
+    return true;
+  }
+
+  bool AdmissionQueue::dropLowerThan(Priority priority) {
+    for (std::size_t i = 0; i < static_cast<std::size_t>(priority); ++i) {
+      auto& queue = queues[i];
+      while (!queue.empty()) {
+        auto& item = queue.front();
+        const auto id = item.id;
+        const auto live = static_cast<bool>(item.notification);
+        if (live) {
+          queued.erase(id);
+        }
+        queue.pop_front();
+        if (live) {
+          ++stats.dropped;
+          drop(id);
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  void AdmissionQueue::scheduleDrain() {
+    if (drain_source_id || queued.empty()) {
+      return;
+    }
+    guint delayMs = 0;
+    if (config.rate > 0) {
+      refill();
+      if (tokens < 1) {
+        delayMs = static_cast<guint>(std::ceil((1 - tokens) * 1000 / config.rate));
+      }
+    }
+    drain_source_id = g_timeout_add_full(G_PRIORITY_DEFAULT, delayMs, [](gpointer p) -> gboolean {
+      const auto self = static_cast<AdmissionQueue*>(p);
+      self->drain_source_id = 0;
+      self->drain();
+      return G_SOURCE_REMOVE;
+    }, this, nullptr);
+  }
+
+  void AdmissionQueue::drain() {
+    // highest priority first
+    for (auto queue = queues.rbegin(); queue != queues.rend(); ++queue) {
+      while (!queue->empty()) {
+        auto& item = queue->front();
+        if (!item.notification) {
+          queue->pop_front();
+          continue;
+        }
+        if (!takeToken()) {
+          scheduleDrain();
+          return;
+        }
+        const auto id = item.id;
+        const auto notification = std::move(item.notification);
+        queued.erase(id);
+        queue->pop_front();
+        ++stats.sent;
+        send(id, notification.get());
+      }
+    }
+  }
+}
@@ -0,0 +1,111 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_ADMISSION_QUEUE_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_ADMISSION_QUEUE_H_
+
+#include <gio/gio.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+
+#include "gobject_ptr.h"
+
+namespace flutter_local_notifications {
+  // Same order as LinuxNotificationPriority on Dart side.
+  enum class NotificationPriority : std::uint8_t {
+    Low,
+    Normal,
+    High,
+    // never rate limited
+    Urgent,
+  };
+
+  // Sits in front of the notification server and limits how fast notifications are sent
+  // with a token bucket. Notifications which exceed the rate are queued by priority and
+  // sent once tokens are available, the queue is bounded and drops the oldest notification
+  // of the lowest priority when it is full, which is reported by the DropCallback.
+  class AdmissionQueue {
+  public:
+    using Priority = NotificationPriority;
+
+    struct Config {
+      // tokens refilled per second, 0 for unlimited
+      double rate;
+      // capacity of the token bucket, i.e. how many notifications can be sent at once
+      double burst;
+      std::size_t maxDepth;
+    };
+
+    struct Stats {
+      std::uint64_t sent;
+      // notifications which had to wait in the queue
+      std::uint64_t deferred;
+      std::uint64_t dropped;
+    };
+
+    using SendCallback = std::function<void(std::int64_t id, GNotification* notification)>;
+    // Invoked for a notification which will not be sent, either when it is submitted to a
+    // full queue or when it is evicted by one of higher priority.
+    using DropCallback = std::function<void(std::int64_t id)>;
+
+    AdmissionQueue(SendCallback send, DropCallback drop, Config config);
+    ~AdmissionQueue();
+
+    AdmissionQueue(const AdmissionQueue&) = delete;
+    AdmissionQueue& operator=(const AdmissionQueue&) = delete;
+
+    void configure(Config config);
+
+    // Sends notification at once if the rate allows, otherwise queues it. A queued
+    // notification with the same id is replaced, in its place if it has the same priority,
+    // otherwise it is moved to the queue of priority, or sent at once if it became urgent.
+    // Takes a new reference of notification.
+    void submit(std::int64_t id, GNotification* notification, Priority priority);
+    // Removes the queued notification of id, returns whether there was one.
+    bool remove(std::int64_t id);
+    void clear();
+
+    bool contains(std::int64_t id) const {
+      return queued.find(id) != queued.end();
+    }
+
+    std::size_t depth() const {
+      return queued.size();
+    }
+
+    const Stats& getStats() const {
+      return stats;
+    }
+
+  private:
+    struct Item {
+      std::int64_t id;
+      Priority priority;
+      // null if the item has been removed
+      GObjectPtr<GNotification> notification;
+    };
+
+    SendCallback send;
+    DropCallback drop;
+    Config config;
+    Stats stats;
+
+    double tokens;
+    gint64 last_refill_time;
+    guint drain_source_id;
+
+    std::array<std::deque<Item>, 4> queues;
+    // Key: notification id, Value: its item in queues, which stays valid as items are only
+    // added to and removed from the ends of the deques
+    std::unordered_map<std::int64_t, Item*> queued;
+
+    void refill();
+    bool takeToken();
+    bool dropLowerThan(Priority priority);
+    void scheduleDrain();
+    void drain();
+  };
+}
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_ADMISSION_QUEUE_H_
@@ -0,0 +1,114 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_ARGUMENT_DECODER_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_ARGUMENT_DECODER_H_
+
+#include <flutter_linux/flutter_linux.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+
+namespace flutter_local_notifications {
+  inline FlMethodResponse* RequiredArgumentAbsentError(std::string methodName, std::string requiredArgName, FlValue* detail = nullptr) {
+    methodName += "_error";
+    requiredArgName += " is absent, which is required for this operation";
+    return FL_METHOD_RESPONSE(fl_method_error_response_new(methodName.data(), requiredArgName.data(), detail));
+  }
+
+  inline FlMethodResponse* RequiredArgumentTypeError(std::string methodName, std::string requiredArgName, FlValue* detail = nullptr) {
+    methodName += "_error";
+    requiredArgName += " has wrong type, which is required for this operation";
+    return FL_METHOD_RESPONSE(fl_method_error_response_new(methodName.data(), requiredArgName.data(), detail));
+  }
+
+  inline FlMethodResponse* OptionalArgument(const char* funcName, const char* argName, FlValue*& arg, FlValueType requiredType) {
+    if (arg) {
+      const auto type = fl_value_get_type(arg);
+      if (type == FL_VALUE_TYPE_NULL) {
+        arg = nullptr;
+        return nullptr;
+      }
+      return type == requiredType ? nullptr : RequiredArgumentTypeError(funcName, argName);
+    }
+    return nullptr;
+  }
+
+  inline FlMethodResponse* RequireArgument(const char* funcName, const char* argName, FlValue* arg, FlValueType requiredType) {
+    if (!arg) {
+      return RequiredArgumentAbsentError(funcName, argName);
+    }
+    if (fl_value_get_type(arg) != requiredType) {
+      return RequiredArgumentTypeError(funcName, argName);
+    }
+    return nullptr;
+  }
+
+  // Describes how the entry with key name of an argument map is decoded into a member of T.
+  template <typename T>
+  struct ArgumentField {
+    using Member = std::variant<std::int64_t T::*, std::optional<std::int64_t> T::*, const char* T::*, FlValue* T::*>;
+
+    std::string_view name;
+    FlValueType type;
+    bool required;
+    Member member;
+  };
+
+  inline void AssignArgument(std::int64_t& target, FlValue* value) {
+    target = fl_value_get_int(value);
+  }
+
+  inline void AssignArgument(std::optional<std::int64_t>& target, FlValue* value) {
+    target = fl_value_get_int(value);
+  }
+
+  inline void AssignArgument(const char*& target, FlValue* value) {
+    target = fl_value_get_string(value);
+  }
+
+  inline void AssignArgument(FlValue*& target, FlValue* value) {
+    target = value;
+  }
+
+  // Decodes map into out by walking its entries once, instead of looking up every field.
+  // Absent or null optional fields keep their value in out.
+  // Returns the same error as RequireArg/OptionalArg for the first field in fields which is
+  // absent while required, or has wrong type, or nullptr if map has been decoded.
+  template <typename T, std::size_t N>
+  FlMethodResponse* DecodeArguments(const char* funcName, FlValue* map, const ArgumentField<T> (&fields)[N], T& out) {
+    std::array<FlValue*, N> values{};
+    const auto size = fl_value_get_length(map);
+    for (std::size_t i = 0; i < size; ++i) {
+      const auto key = fl_value_get_map_key(map, i);
+      if (fl_value_get_type(key) != FL_VALUE_TYPE_STRING) {
+        continue;
+      }
+      const std::string_view keyName = fl_value_get_string(key);
+      for (std::size_t j = 0; j < N; ++j) {
+        if (fields[j].name == keyName) {
+          values[j] = fl_value_get_map_value(map, i);
+          break;
+        }
+      }
+    }
+
+    for (std::size_t j = 0; j < N; ++j) {
+      const auto& field = fields[j];
+      auto value = values[j];
+      // names in fields are string literals, which are null terminated
+      const auto resp = field.required ? RequireArgument(funcName, field.name.data(), value, field.type)
+        : OptionalArgument(funcName, field.name.data(), value, field.type);
+      if (resp) {
+        return resp;
+      }
+      if (value) {
+        std::visit([&](auto member) { AssignArgument(out.*member, value); }, field.member);
+      }
+    }
+    return nullptr;
+  }
+}
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_ARGUMENT_DECODER_H_
@@ -0,0 +1,1008 @@
+// Benchmarks of the method calls of the plugin, driven without a Flutter engine through
+// a headless GApplication.
+//
+// Notifications are really sent, so run it on a private session bus to keep them away
+// from the desktop:
+//   dbus-run-session -- ./flutter_local_notifications_benchmark
+#include <benchmark/benchmark.h>
+#include <flutter_linux/flutter_linux.h>
+#include <gio/gio.h>
+#include <sys/resource.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../argument_decoder.h"
+#include "../binary_codec.h"
+#include "../flutter_local_notifications_plugin_private.h"
+#include "../local_time.h"
+#include "../recurrence.h"
+#include "../time_zone_monitor.h"
+
+namespace {
+  std::atomic<std::uint64_t> allocations{ 0 };
+}
+
+#ifdef __GLIBC__
+// Counts every allocation, including the ones of GLib, by wrapping the allocator of glibc.
+extern "C" {
+  void* __libc_malloc(size_t size);
+  void* __libc_calloc(size_t count, size_t size);
+  void* __libc_realloc(void* pointer, size_t size);
+
+  void* malloc(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+  }
+
+  void* calloc(size_t count, size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+  }
+
+  void* realloc(void* pointer, size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(pointer, size);
+  }
+}
+#endif
+
+namespace {
+  // Far enough in the future to never fire while benchmarking.
+  inline constexpr const char ScheduledDateTime[] = "2100-01-01T00:00:00";
+
+  FlValue* NotificationArguments(std::int64_t id, bool withButtons = false) {
+    const auto args = fl_value_new_map();
+    fl_value_set_string_take(args, "id", fl_value_new_int(id));
+    fl_value_set_string_take(args, "title", fl_value_new_string("Title"));
+    fl_value_set_string_take(args, "body", fl_value_new_string("Body of the notification"));
+    fl_value_set_string_take(args, "payload", fl_value_new_string("payload"));
+    if (withButtons) {
+      const auto buttons = fl_value_new_list();
+      for (const auto label : { "Reply", "Archive", "Dismiss" }) {
+        const auto button = fl_value_new_map();
+        fl_value_set_string_take(button, "buttonLabel", fl_value_new_string(label));
+        fl_value_set_string_take(button, "payload", fl_value_new_string(label));
+        fl_value_append_take(buttons, button);
+      }
+      const auto platformSpecifics = fl_value_new_map();
+      fl_value_set_string_take(platformSpecifics, "buttons", buttons);
+      fl_value_set_string_take(args, "platformSpecifics", platformSpecifics);
+    }
+    return args;
+  }
+
+  FlValue* PeriodicallyShowArguments(std::int64_t id) {
+    const auto args = NotificationArguments(id);
+    // every minute
+    fl_value_set_string_take(args, "repeatInterval", fl_value_new_int(0));
+    return args;
+  }
+
+  // Repeats every minute with the misfire policy of index policy.
+  FlValue* MisfiringArguments(std::int64_t id, std::int64_t policy) {
+    const auto args = PeriodicallyShowArguments(id);
+    const auto platformSpecifics = fl_value_new_map();
+    fl_value_set_string_take(platformSpecifics, "misfirePolicy", fl_value_new_int(policy));
+    fl_value_set_string_take(args, "platformSpecifics", platformSpecifics);
+    return args;
+  }
+
+  FlValue* ZonedScheduleArguments(std::int64_t id) {
+    const auto args = NotificationArguments(id);
+    fl_value_set_string_take(args, "timeZoneName", fl_value_new_string("UTC"));
+    fl_value_set_string_take(args, "scheduledDateTime", fl_value_new_string(ScheduledDateTime));
+    return args;
+  }
+
+  // Like ZonedScheduleArguments, with a title which no other notification has.
+  FlValue* DistinctZonedScheduleArguments(std::int64_t id) {
+    const auto args = ZonedScheduleArguments(id);
+    g_autofree gchar* title = g_strdup_printf("Title %" G_GINT64_FORMAT, id);
+    fl_value_set_string_take(args, "title", fl_value_new_string(title));
+    return args;
+  }
+
+  FlValue* DailyReminderArgumentsIn(std::int64_t id, const char* timeZoneName) {
+    const auto args = NotificationArguments(id);
+    // spread over the day
+    g_autofree gchar* scheduledDateTime = g_strdup_printf("2030-01-01T%02d:%02d:00",
+      static_cast<int>(id / 60 % 24), static_cast<int>(id % 60));
+    fl_value_set_string_take(args, "timeZoneName", fl_value_new_string(timeZoneName));
+    fl_value_set_string_take(args, "scheduledDateTime", fl_value_new_string(scheduledDateTime));
+    // DateTimeComponents.time
+    fl_value_set_string_take(args, "matchDateTimeComponents", fl_value_new_int(0));
+    return args;
+  }
+
+  FlValue* DailyReminderArguments(std::int64_t id) {
+    return DailyReminderArgumentsIn(id, "UTC");
+  }
+
+  // A zone with daylight saving time, so that next occurrences cross transitions.
+  inline constexpr const char DaylightSavingTimeZone[] = "America/New_York";
+
+  FlValue* DaylightSavingDailyReminderArguments(std::int64_t id) {
+    return DailyReminderArgumentsIn(id, DaylightSavingTimeZone);
+  }
+
+  // Message of the binary channel equivalent to NotificationArguments.
+  FlValue* BinaryShowMessage(std::int64_t id, bool withButtons = false) {
+    std::string message;
+    const auto putInt32 = [&message](guint32 value) {
+      for (int i = 0; i < 4; ++i) {
+        message.push_back(static_cast<char>(value >> (8 * i)));
+      }
+    };
+    const auto putString = [&message, &putInt32](std::string_view value) {
+      putInt32(value.size());
+      message.append(value);
+      message.push_back('\0');
+    };
+    message.push_back(static_cast<char>(flutter_local_notifications::BinaryOperation::Show));
+    putInt32(static_cast<guint32>(id));
+    putString("Title");
+    putString("Body of the notification");
+    putString("payload");
+    // no icon nor priority
+    message.push_back(0);
+    if (withButtons) {
+      message.push_back(3);
+      for (const auto label : { "Reply", "Archive", "Dismiss" }) {
+        putString(label);
+        putString(label);
+      }
+    } else {
+      message.push_back(0);
+    }
+    return fl_value_new_uint8_list(reinterpret_cast<const uint8_t*>(message.data()), message.size());
+  }
+
+  FlValue* BinaryCancelMessage(std::int64_t id) {
+    const guint8 message[] = {
+      static_cast<guint8>(flutter_local_notifications::BinaryOperation::Cancel),
+      static_cast<guint8>(id), static_cast<guint8>(id >> 8), static_cast<guint8>(id >> 16), static_cast<guint8>(id >> 24),
+    };
+    return fl_value_new_uint8_list(message, sizeof(message));
+  }
+
+  // Id of an application no benchmark used before, whose schedule journal is empty.
+  std::string NewApplicationId() {
+    static int runs = 0;
+    return "com.dexterous.flutter_local_notifications.benchmark.run" + std::to_string(runs++);
+  }
+
+  // A fresh plugin with its own application, so that notifications scheduled by earlier
+  // benchmarks are not restored from the schedule journal, unless it is given the id of
+  // an earlier application.
+  class Harness {
+  public:
+    explicit Harness(benchmark::State& state) : Harness(state, NewApplicationId()) {
+    }
+
+    // Initializes the plugin right away unless initialized is false.
+    Harness(benchmark::State& state, const std::string& appId, bool initialized = true) : state(state) {
+      application = g_application_new(appId.data(), G_APPLICATION_NON_UNIQUE);
+      g_autoptr(GError) error = nullptr;
+      if (!g_application_register(application, nullptr, &error)) {
+        state.SkipWithError(error->message);
+      }
+      plugin = flutter_local_notifications_plugin_new_headless(application);
+      if (initialized) {
+        initialize();
+      }
+    }
+
+    // Restores the notifications scheduled by earlier plugins of the same application.
+    void initialize() {
+      // the rate limit is not what is measured
+      g_autoptr(FlValue) admission = fl_value_new_map();
+      fl_value_set_string_take(admission, "rate", fl_value_new_float(0));
+      g_autoptr(FlValue) settings = fl_value_new_map();
+      fl_value_set_string(settings, "admission", admission);
+      call("initialize", settings);
+    }
+
+    ~Harness() {
+      pump();
+      g_object_unref(plugin);
+      g_object_unref(application);
+    }
+
+    Harness(const Harness&) = delete;
+    Harness& operator=(const Harness&) = delete;
+
+    void call(const char* method, FlValue* args) {
+      if (const auto result = callForResult(method, args)) {
+        fl_value_unref(result);
+      }
+    }
+
+    // Returns the result of method, null if it failed.
+    FlValue* callForResult(const char* method, FlValue* args) {
+      g_autoptr(FlMethodResponse) response = flutter_local_notifications_plugin_handle_method(plugin, method, args);
+      if (FL_IS_METHOD_ERROR_RESPONSE(response)) {
+        state.SkipWithError(fl_method_error_response_get_message(FL_METHOD_ERROR_RESPONSE(response)));
+        return nullptr;
+      }
+      const auto result = fl_method_success_response_get_result(FL_METHOD_SUCCESS_RESPONSE(response));
+      return result ? fl_value_ref(result) : nullptr;
+    }
+
+    void send(FlValue* message) {
+      g_autoptr(FlValue) reply = flutter_local_notifications_plugin_handle_binary_message(plugin, message);
+      if (fl_value_get_length(reply) > 0) {
+        state.SkipWithError("binary message failed");
+      }
+    }
+
+    // Lets the notification backend of GApplication process the notifications sent so far.
+    void pump() {
+      while (g_main_context_iteration(nullptr, FALSE)) {
+      }
+    }
+
+  private:
+    benchmark::State& state;
+    GApplication* application;
+    FlutterLocalNotificationsPlugin* plugin;
+  };
+
+  // Arguments of count notifications with ids from 0.
+  template <typename Factory>
+  std::vector<FlValue*> ArgumentsOf(std::int64_t count, Factory&& factory) {
+    std::vector<FlValue*> arguments;
+    arguments.reserve(count);
+    for (std::int64_t id = 0; id < count; ++id) {
+      arguments.push_back(factory(id));
+    }
+    return arguments;
+  }
+
+  void Release(std::vector<FlValue*>& arguments) {
+    for (const auto args : arguments) {
+      fl_value_unref(args);
+    }
+    arguments.clear();
+  }
+
+  void Populate(Harness& harness, const char* method, const std::vector<FlValue*>& arguments) {
+    for (const auto args : arguments) {
+      harness.call(method, args);
+    }
+    harness.pump();
+  }
+
+  void ReportCounters(benchmark::State& state, std::uint64_t measuredAllocations) {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    state.counters["allocs/op"] = benchmark::Counter(static_cast<double>(measuredAllocations), benchmark::Counter::kAvgIterations);
+    // ru_maxrss is in kilobytes on Linux
+    state.counters["peak_rss_mb"] = usage.ru_maxrss / 1024.0;
+  }
+
+  // Bytes of heap in use, 0 if the allocator cannot tell.
+  std::size_t HeapInUse() {
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+  }
+
+  // Calls method on already registered notifications, each with arguments made by factory,
+  // with state.range(0) notifications registered.
+  template <typename Factory>
+  void RunOnRegistered(benchmark::State& state, const char* method, Factory&& factory) {
+    const auto count = state.range(0);
+    Harness harness(state);
+    auto arguments = ArgumentsOf(count, factory);
+    Populate(harness, method, arguments);
+
+    std::size_t next = 0;
+    const auto startAllocations = allocations.load(std::memory_order_relaxed);
+    for (auto _ : state) {
+      harness.call(method, arguments[next]);
+      next = next + 1 == arguments.size() ? 0 : next + 1;
+    }
+    ReportCounters(state, allocations.load(std::memory_order_relaxed) - startAllocations);
+    Release(arguments);
+  }
+
+  void BM_Show(benchmark::State& state) {
+    RunOnRegistered(state, "show", [](std::int64_t id) { return NotificationArguments(id); });
+  }
+
+  // Like BM_Show with tracing enabled, which records the method call, the build and the
+  // send of every notification into a ring that is full after the first iterations.
+  void BM_ShowTraced(benchmark::State& state) {
+    const auto count = state.range(0);
+    Harness harness(state);
+    g_autoptr(FlValue) settings = fl_value_new_map();
+    fl_value_set_string_take(settings, "traceEventCapacity", fl_value_new_int(1 << 16));
+    harness.call("initialize", settings);
+    auto arguments = ArgumentsOf(count, [](std::int64_t id) { return NotificationArguments(id); });
+    Populate(harness, "show", arguments);
+
+    std::size_t next = 0;
+    const auto startAllocations = allocations.load(std::memory_order_relaxed);
+    for (auto _ : state) {
+      harness.call("show", arguments[next]);
+      next = next + 1 == arguments.size() ? 0 : next + 1;
+    }
+    ReportCounters(state, allocations.load(std::memory_order_relaxed) - startAllocations);
+    Release(arguments);
+  }
+
+  void BM_ShowWithButtons(benchmark::State& state) {
+    RunOnRegistered(state, "show", [](std::int64_t id) { return NotificationArguments(id, true); });
+  }
+
+  // Arguments of show with the platformSpecifics the plugin reads, as decoded by
+  // BM_DecodeShowLookup and BM_DecodeShowSinglePass.
+  struct DecodedShowArguments {
+    std::int64_t id;
+    const char* title = "";
+    const char* body = nullptr;
+    const char* payload;
+    FlValue* platformSpecifics = nullptr;
+    FlValue* icon = nullptr;
+    FlValue* buttons = nullptr;
+    std::optional<std::int64_t> priority;
+    std::optional<std::int64_t> misfirePolicy;
+    const char* groupKey = nullptr;
+    std::vector<std::pair<const char*, const char*>> buttonTargets;
+  };
+
+  // Decodes args the way show did before ArgumentField tables, with a lookup per key, each
+  // of which walks the map from its start.
+  FlMethodResponse* DecodeShowLookup(FlValue* args, DecodedShowArguments& out) {
+    using flutter_local_notifications::OptionalArgument;
+    using flutter_local_notifications::RequireArgument;
+    constexpr auto funcName = "show";
+
+    const auto id = fl_value_lookup_string(args, "id");
+    if (const auto resp = RequireArgument(funcName, "id", id, FL_VALUE_TYPE_INT)) {
+      return resp;
+    }
+    auto title = fl_value_lookup_string(args, "title");
+    if (const auto resp = OptionalArgument(funcName, "title", title, FL_VALUE_TYPE_STRING)) {
+      return resp;
+    }
+    auto body = fl_value_lookup_string(args, "body");
+    if (const auto resp = OptionalArgument(funcName, "body", body, FL_VALUE_TYPE_STRING)) {
+      return resp;
+    }
+    const auto payload = fl_value_lookup_string(args, "payload");
+    if (const auto resp = RequireArgument(funcName, "payload", payload, FL_VALUE_TYPE_STRING)) {
+      return resp;
+    }
+    auto platformSpecifics = fl_value_lookup_string(args, "platformSpecifics");
+    if (const auto resp = OptionalArgument(funcName, "platformSpecifics", platformSpecifics, FL_VALUE_TYPE_MAP)) {
+      return resp;
+    }
+    out.id = fl_value_get_int(id);
+    out.title = title ? fl_value_get_string(title) : "";
+    out.body = body ? fl_value_get_string(body) : nullptr;
+    out.payload = fl_value_get_string(payload);
+    out.platformSpecifics = platformSpecifics;
+    if (!platformSpecifics) {
+      return nullptr;
+    }
+
+    const auto icon = fl_value_lookup_string(platformSpecifics, "icon");
+    out.icon = icon && fl_value_get_type(icon) == FL_VALUE_TYPE_MAP ? icon : nullptr;
+    const auto priority = fl_value_lookup_string(platformSpecifics, "priority");
+    if (priority && fl_value_get_type(priority) == FL_VALUE_TYPE_INT) {
+      out.priority = fl_value_get_int(priority);
+    }
+    const auto misfirePolicy = fl_value_lookup_string(platformSpecifics, "misfirePolicy");
+    if (misfirePolicy && fl_value_get_type(misfirePolicy) == FL_VALUE_TYPE_INT) {
+      out.misfirePolicy = fl_value_get_int(misfirePolicy);
+    }
+    const auto groupKey = fl_value_lookup_string(platformSpecifics, "groupKey");
+    out.groupKey = groupKey && fl_value_get_type(groupKey) == FL_VALUE_TYPE_STRING ? fl_value_get_string(groupKey) : nullptr;
+    const auto buttons = fl_value_lookup_string(platformSpecifics, "buttons");
+    if (buttons && fl_value_get_type(buttons) == FL_VALUE_TYPE_LIST) {
+      out.buttons = buttons;
+      const auto buttonSize = fl_value_get_length(buttons);
+      out.buttonTargets.reserve(buttonSize);
+      for (std::size_t i = 0; i < buttonSize; ++i) {
+        const auto button = fl_value_get_list_value(buttons, i);
+        const auto label = fl_value_get_string(fl_value_lookup_string(button, "buttonLabel"));
+        const auto buttonPayload = fl_value_get_string(fl_value_lookup_string(button, "payload"));
+        out.buttonTargets.emplace_back(label, buttonPayload);
+      }
+    }
+    return nullptr;
+  }
+
+  struct DecodedButton {
+    const char* buttonLabel;
+    const char* payload;
+  };
+
+  // Same fields as the tables of the plugin for show, its platformSpecifics and buttons.
+  inline constexpr flutter_local_notifications::ArgumentField<DecodedShowArguments> DecodedShowArgumentFields[] = {
+    { "id", FL_VALUE_TYPE_INT, true, &DecodedShowArguments::id },
+    { "title", FL_VALUE_TYPE_STRING, false, &DecodedShowArguments::title },
+    { "body", FL_VALUE_TYPE_STRING, false, &DecodedShowArguments::body },
+    { "payload", FL_VALUE_TYPE_STRING, true, &DecodedShowArguments::payload },
+    { "platformSpecifics", FL_VALUE_TYPE_MAP, false, &DecodedShowArguments::platformSpecifics },
+  };
+
+  inline constexpr flutter_local_notifications::ArgumentField<DecodedShowArguments> DecodedDetailsFields[] = {
+    { "icon", FL_VALUE_TYPE_MAP, false, &DecodedShowArguments::icon },
+    { "buttons", FL_VALUE_TYPE_LIST, false, &DecodedShowArguments::buttons },
+    { "priority", FL_VALUE_TYPE_INT, false, &DecodedShowArguments::priority },
+    { "misfirePolicy", FL_VALUE_TYPE_INT, false, &DecodedShowArguments::misfirePolicy },
+    { "groupKey", FL_VALUE_TYPE_STRING, false, &DecodedShowArguments::groupKey },
+  };
+
+  inline constexpr flutter_local_notifications::ArgumentField<DecodedButton> DecodedButtonFields[] = {
+    { "buttonLabel", FL_VALUE_TYPE_STRING, true, &DecodedButton::buttonLabel },
+    { "payload", FL_VALUE_TYPE_STRING, true, &DecodedButton::payload },
+  };
+
+  // Decodes args the way show does, walking every map once with DecodeArguments.
+  FlMethodResponse* DecodeShowSinglePass(FlValue* args, DecodedShowArguments& out) {
+    using flutter_local_notifications::DecodeArguments;
+    if (const auto resp = DecodeArguments("show", args, DecodedShowArgumentFields, out)) {
+      return resp;
+    }
+    if (!out.platformSpecifics) {
+      return nullptr;
+    }
+    if (const auto resp = DecodeArguments("show", out.platformSpecifics, DecodedDetailsFields, out)) {
+      // invalid platformSpecifics are ignored by the plugin
+      g_object_unref(resp);
+      return nullptr;
+    }
+    if (out.buttons) {
+      const auto buttonSize = fl_value_get_length(out.buttons);
+      out.buttonTargets.reserve(buttonSize);
+      for (std::size_t i = 0; i < buttonSize; ++i) {
+        DecodedButton button;
+        if (const auto resp = DecodeArguments("show", fl_value_get_list_value(out.buttons, i), DecodedButtonFields, button)) {
+          g_object_unref(resp);
+          continue;
+        }
+        out.buttonTargets.emplace_back(button.buttonLabel, button.payload);
+      }
+    }
+    return nullptr;
+  }
+
+  // Decodes the arguments of BM_ShowWithButtons without showing them, so that the decoders
+  // are compared on their own.
+  template <typename Decoder>
+  void RunDecodeShow(benchmark::State& state, Decoder&& decode) {
+    g_autoptr(FlValue) args = NotificationArguments(0, true);
+    for (auto _ : state) {
+      DecodedShowArguments decoded;
+      if (const auto resp = decode(args, decoded)) {
+        g_object_unref(resp);
+        state.SkipWithError("Failed to decode the arguments of show");
+        break;
+      }
+      benchmark::DoNotOptimize(decoded);
+    }
+  }
+
+  void BM_DecodeShowLookup(benchmark::State& state) {
+    RunDecodeShow(state, DecodeShowLookup);
+  }
+
+  void BM_DecodeShowSinglePass(benchmark::State& state) {
+    RunDecodeShow(state, DecodeShowSinglePass);
+  }
+
+  // Updates with the content already sent, which are dropped without rebuilding the
+  // notification.
+  void BM_UpdateUnchanged(benchmark::State& state) {
+    RunOnRegistered(state, "update", [](std::int64_t id) { return NotificationArguments(id, true); });
+  }
+
+  // Updates of one notification with a new body each time, most of them coalesced.
+  void BM_UpdateProgress(benchmark::State& state) {
+    Harness harness(state);
+    std::int64_t progress = 0;
+    for (auto _ : state) {
+      state.PauseTiming();
+      g_autoptr(FlValue) args = NotificationArguments(0, true);
+      g_autofree gchar* body = g_strdup_printf("%" G_GINT64_FORMAT "%%", progress++ % 100);
+      fl_value_set_string_take(args, "body", fl_value_new_string(body));
+      state.ResumeTiming();
+      harness.call("update", args);
+    }
+    harness.pump();
+  }
+
+  // Same as BM_ShowWithButtons, through the binary channel.
+  void BM_ShowBinary(benchmark::State& state) {
+    const auto count = state.range(0);
+    Harness harness(state);
+    auto messages = ArgumentsOf(count, [](std::int64_t id) { return BinaryShowMessage(id, true); });
+    for (const auto message : messages) {
+      harness.send(message);
+    }
+    harness.pump();
+
+    std::size_t next = 0;
+    const auto startAllocations = allocations.load(std::memory_order_relaxed);
+    for (auto _ : state) {
+      harness.send(messages[next]);
+      next = next + 1 == messages.size() ? 0 : next + 1;
+    }
+    ReportCounters(state, allocations.load(std::memory_order_relaxed) - startAllocations);
+    Release(messages);
+  }
+
+  void BM_PeriodicallyShow(benchmark::State& state) {
+    RunOnRegistered(state, "periodicallyShow", PeriodicallyShowArguments);
+  }
+
+  void BM_ZonedSchedule(benchmark::State& state) {
+    RunOnRegistered(state, "zonedSchedule", ZonedScheduleArguments);
+  }
+
+  // Schedules daily reminders in a zone with daylight saving time. The zone is parsed once
+  // and then taken from the TimeZoneCache, so every call measures the lookup in the cache
+  // and the computation of the next local occurrence across transitions.
+  void BM_ZonedScheduleDaily(benchmark::State& state) {
+    RunOnRegistered(state, "zonedSchedule", DaylightSavingDailyReminderArguments);
+  }
+
+  void BM_TimeZoneNew(benchmark::State& state) {
+    for (auto _ : state) {
+      g_autoptr(GTimeZone) timeZone = g_time_zone_new(DaylightSavingTimeZone);
+      benchmark::DoNotOptimize(timeZone);
+    }
+  }
+
+  void BM_TimeZoneCache(benchmark::State& state) {
+    flutter_local_notifications::TimeZoneCache timeZones;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(timeZones.get(DaylightSavingTimeZone));
+    }
+  }
+
+  // Next daily occurrence of value the way zonedSchedule used to compute it, modulo a
+  // day of Unix time, which is an hour off once a transition is in between.
+  gint64 NextDailyModulo(GDateTime* value, gint64 now) {
+    const auto day = G_TIME_SPAN_DAY / G_USEC_PER_SEC;
+    const auto diff = (g_date_time_to_unix(value) - now / G_USEC_PER_SEC) % day;
+    return (now / G_USEC_PER_SEC + (diff < 0 ? diff + day : diff)) * G_USEC_PER_SEC;
+  }
+
+  // Times of the benchmarks of next occurrences, one every 7 hours through 2030.
+  std::vector<gint64> NowsOf2030() {
+    // 2030-01-01T00:00:00Z
+    const gint64 start = G_GINT64_CONSTANT(1893456000) * G_USEC_PER_SEC;
+    std::vector<gint64> nows;
+    for (auto now = start; now < start + 365 * G_TIME_SPAN_DAY; now += 7 * G_TIME_SPAN_HOUR) {
+      nows.push_back(now);
+    }
+    return nows;
+  }
+
+  void BM_NextDailyModulo(benchmark::State& state) {
+    g_autoptr(GTimeZone) timeZone = g_time_zone_new(DaylightSavingTimeZone);
+    g_autoptr(GDateTime) value = g_date_time_new(timeZone, 2030, 1, 1, 9, 30, 0);
+    const flutter_local_notifications::Recurrence daily({}, timeZone, value);
+    const auto nows = NowsOf2030();
+
+    std::size_t next = 0;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(NextDailyModulo(value, nows[next]));
+      next = next + 1 == nows.size() ? 0 : next + 1;
+    }
+    std::size_t wrong = 0;
+    for (const auto now : nows) {
+      wrong += NextDailyModulo(value, now) != daily.next(now);
+    }
+    // share of the results which are not at 09:30 local time
+    state.counters["wrong"] = static_cast<double>(wrong) / nows.size();
+  }
+
+  // Rules of BM_RecurrenceNext by its argument.
+  flutter_local_notifications::RecurrenceRule BenchmarkedRule(std::int64_t index) {
+    using Frequency = flutter_local_notifications::RecurrenceRule::Frequency;
+    flutter_local_notifications::RecurrenceRule rule;
+    switch (index) {
+    case 1:
+      // every weekday
+      rule.weekdays = 0x1f;
+      break;
+    case 2:
+      // first Monday of month
+      rule.frequency = Frequency::Monthly;
+      rule.weekdays = 0x01;
+      rule.weekOfMonth = 1;
+      break;
+    case 3:
+      // every 90 minutes until 20:00
+      rule.frequency = Frequency::Minutely;
+      rule.interval = 90;
+      rule.endOfDay = 20 * 60 * 60;
+      break;
+    default:
+      // every day
+      break;
+    }
+    return rule;
+  }
+
+  // Next occurrence of a rule starting 2030-01-01T08:00 from times through 2030, the
+  // daily rule of argument 0 is the one of BM_NextDailyModulo.
+  void BM_RecurrenceNext(benchmark::State& state) {
+    g_autoptr(GTimeZone) timeZone = g_time_zone_new(DaylightSavingTimeZone);
+    g_autoptr(GDateTime) start = g_date_time_new(timeZone, 2030, 1, 1, 8, 0, 0);
+    const flutter_local_notifications::Recurrence recurrence(BenchmarkedRule(state.range(0)), timeZone, start);
+    const auto nows = NowsOf2030();
+
+    std::size_t next = 0;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(recurrence.next(nows[next]));
+      next = next + 1 == nows.size() ? 0 : next + 1;
+    }
+  }
+
+  // Cancels one of state.range(0) scheduled notifications, which is scheduled again
+  // without being measured.
+  void BM_Cancel(benchmark::State& state) {
+    const auto count = state.range(0);
+    Harness harness(state);
+    auto arguments = ArgumentsOf(count, ZonedScheduleArguments);
+    Populate(harness, "zonedSchedule", arguments);
+
+    std::int64_t next = 0;
+    std::uint64_t measuredAllocations = 0;
+    for (auto _ : state) {
+      g_autoptr(FlValue) id = fl_value_new_int(next);
+      const auto startAllocations = allocations.load(std::memory_order_relaxed);
+      harness.call("cancel", id);
+      measuredAllocations += allocations.load(std::memory_order_relaxed) - startAllocations;
+
+      state.PauseTiming();
+      harness.call("zonedSchedule", arguments[next]);
+      next = next + 1 == count ? 0 : next + 1;
+      state.ResumeTiming();
+    }
+    ReportCounters(state, measuredAllocations);
+    Release(arguments);
+  }
+
+  // Same as BM_Cancel, through the binary channel.
+  void BM_CancelBinary(benchmark::State& state) {
+    const auto count = state.range(0);
+    Harness harness(state);
+    auto arguments = ArgumentsOf(count, ZonedScheduleArguments);
+    auto messages = ArgumentsOf(count, BinaryCancelMessage);
+    Populate(harness, "zonedSchedule", arguments);
+
+    std::int64_t next = 0;
+    std::uint64_t measuredAllocations = 0;
+    for (auto _ : state) {
+      const auto startAllocations = allocations.load(std::memory_order_relaxed);
+      harness.send(messages[next]);
+      measuredAllocations += allocations.load(std::memory_order_relaxed) - startAllocations;
+
+      state.PauseTiming();
+      harness.call("zonedSchedule", arguments[next]);
+      next = next + 1 == count ? 0 : next + 1;
+      state.ResumeTiming();
+    }
+    ReportCounters(state, measuredAllocations);
+    Release(messages);
+    Release(arguments);
+  }
+
+  // Cancels all of state.range(0) scheduled notifications, which are scheduled again
+  // without being measured.
+  void BM_CancelAll(benchmark::State& state) {
+    const auto count = state.range(0);
+    Harness harness(state);
+    auto arguments = ArgumentsOf(count, ZonedScheduleArguments);
+
+    std::uint64_t measuredAllocations = 0;
+    for (auto _ : state) {
+      state.PauseTiming();
+      Populate(harness, "zonedSchedule", arguments);
+      state.ResumeTiming();
+
+      const auto startAllocations = allocations.load(std::memory_order_relaxed);
+      harness.call("cancelAll", nullptr);
+      measuredAllocations += allocations.load(std::memory_order_relaxed) - startAllocations;
+    }
+    ReportCounters(state, measuredAllocations);
+    Release(arguments);
+  }
+
+  // Shows through the native API from state.range(0) threads at once, while the main
+  // context runs the calls, 100000 calls per iteration over 1000 ids.
+  void BM_NativeShowContention(benchmark::State& state) {
+    const auto producers = state.range(0);
+    constexpr std::int64_t calls = 100000;
+    Harness harness(state);
+
+    std::int64_t run = 0;
+    for (auto _ : state) {
+      std::atomic<std::int64_t> running{ producers };
+      std::vector<std::thread> threads;
+      for (std::int64_t producer = 0; producer < producers; ++producer) {
+        threads.emplace_back([&running, producer, producers] {
+          for (std::int64_t i = producer; i < calls; i += producers) {
+            flutter_local_notifications_show(static_cast<gint32>(i % 1000), "Title", "Body of the notification", "payload");
+          }
+          running.fetch_sub(1);
+        });
+      }
+      while (running.load() > 0) {
+        g_main_context_iteration(nullptr, FALSE);
+      }
+      for (auto& thread : threads) {
+        thread.join();
+      }
+      harness.pump();
+      run += calls;
+    }
+    state.counters["calls/s"] = benchmark::Counter(static_cast<double>(run), benchmark::Counter::kIsRate);
+  }
+
+  // Heap taken per pending notification with state.range(0) scheduled by zonedSchedule,
+  // which all have the same title unless state.range(1) is 1.
+  void BM_PendingFootprint(benchmark::State& state) {
+    const auto count = state.range(0);
+    Harness harness(state);
+    auto arguments = ArgumentsOf(count, state.range(1) ? DistinctZonedScheduleArguments : ZonedScheduleArguments);
+
+    double bytes = 0;
+    for (auto _ : state) {
+      const auto startHeap = static_cast<double>(HeapInUse());
+      Populate(harness, "zonedSchedule", arguments);
+      bytes += static_cast<double>(HeapInUse()) - startHeap;
+      state.PauseTiming();
+      harness.call("cancelAll", nullptr);
+      state.ResumeTiming();
+    }
+    state.counters["bytes/entry"] = benchmark::Counter(bytes / count, benchmark::Counter::kAvgIterations);
+    Release(arguments);
+  }
+
+  // Startup of an application with state.range(0) notifications in its schedule journal,
+  // i.e. initialize replaying the journal and scheduling every notification again.
+  void BM_InitializeRestore(benchmark::State& state) {
+    const auto count = state.range(0);
+    const auto appId = NewApplicationId();
+    {
+      Harness harness(state, appId);
+      auto arguments = ArgumentsOf(count, ZonedScheduleArguments);
+      Populate(harness, "zonedSchedule", arguments);
+      Release(arguments);
+    }
+
+    std::int64_t restored = 0;
+    for (auto _ : state) {
+      state.PauseTiming();
+      auto harness = std::make_unique<Harness>(state, appId, false);
+      state.ResumeTiming();
+      harness->initialize();
+      state.PauseTiming();
+      harness.reset();
+      state.ResumeTiming();
+      restored += count;
+    }
+    state.counters["schedules/s"] = benchmark::Counter(static_cast<double>(restored), benchmark::Counter::kIsRate);
+  }
+
+  // Fires state.range(0) daily reminders for a week of virtual time per iteration.
+  void BM_SimulateDailyReminders(benchmark::State& state) {
+    const auto count = state.range(0);
+    Harness harness(state);
+    // 2030-01-01T00:00:00Z
+    const gint64 startTime = G_GINT64_CONSTANT(1893456000) * G_USEC_PER_SEC;
+    g_autoptr(FlValue) simulationArgs = fl_value_new_map();
+    fl_value_set_string_take(simulationArgs, "startTime", fl_value_new_int(startTime));
+    harness.call("enableSimulation", simulationArgs);
+    auto arguments = ArgumentsOf(count, DailyReminderArguments);
+    Populate(harness, "zonedSchedule", arguments);
+
+    gint64 until = startTime;
+    std::int64_t fires = 0;
+    for (auto _ : state) {
+      until += 7 * G_TIME_SPAN_DAY;
+      g_autoptr(FlValue) advanceArgs = fl_value_new_map();
+      fl_value_set_string_take(advanceArgs, "until", fl_value_new_int(until));
+      harness.call("advanceSimulation", advanceArgs);
+      harness.call("takeSimulatedFires", nullptr);
+      fires += 7 * count;
+    }
+    state.counters["fires/s"] = benchmark::Counter(static_cast<double>(fires), benchmark::Counter::kIsRate);
+    Release(arguments);
+  }
+
+  // Moves state.range(0) daily reminders in the system time zone back and forth between
+  // it and another zone, one change of the simulated system time zone per iteration.
+  void BM_SimulateTimeZoneChange(benchmark::State& state) {
+    const auto count = state.range(0);
+    Harness harness(state);
+    // 2030-01-01T00:00:00Z
+    const gint64 startTime = G_GINT64_CONSTANT(1893456000) * G_USEC_PER_SEC;
+    g_autoptr(FlValue) simulationArgs = fl_value_new_map();
+    fl_value_set_string_take(simulationArgs, "startTime", fl_value_new_int(startTime));
+    harness.call("enableSimulation", simulationArgs);
+    const char* const timeZones[] = { DaylightSavingTimeZone, "Europe/Berlin" };
+    const auto changeTimeZone = [&harness](const char* timeZoneName) {
+      g_autoptr(FlValue) timeZoneArgs = fl_value_new_map();
+      fl_value_set_string_take(timeZoneArgs, "timeZoneName", fl_value_new_string(timeZoneName));
+      harness.call("changeSimulatedTimeZone", timeZoneArgs);
+    };
+    changeTimeZone(timeZones[0]);
+    auto arguments = ArgumentsOf(count, DaylightSavingDailyReminderArguments);
+    Populate(harness, "zonedSchedule", arguments);
+
+    std::size_t changes = 0;
+    std::int64_t moved = 0;
+    for (auto _ : state) {
+      changeTimeZone(timeZones[++changes % std::size(timeZones)]);
+      moved += count;
+    }
+    state.counters["schedules/s"] = benchmark::Counter(static_cast<double>(moved), benchmark::Counter::kIsRate);
+    Release(arguments);
+  }
+
+  // Restores state.range(0) daily reminders scheduled in the system time zone from the
+  // schedule journal, then moves them back and forth between it and another zone, one
+  // change of the simulated system time zone per iteration.
+  void BM_SimulateTimeZoneChangeAfterRestore(benchmark::State& state) {
+    const auto count = state.range(0);
+    const auto systemTimeZone = flutter_local_notifications::SystemTimeZoneName();
+    if (systemTimeZone.empty()) {
+      state.SkipWithError("the system time zone is not known");
+      return;
+    }
+    const auto appId = NewApplicationId();
+    {
+      Harness harness(state, appId);
+      auto arguments = ArgumentsOf(count, [&systemTimeZone](std::int64_t id) {
+        return DailyReminderArgumentsIn(id, systemTimeZone.data());
+      });
+      Populate(harness, "zonedSchedule", arguments);
+      Release(arguments);
+    }
+
+    Harness harness(state, appId);
+    g_autoptr(FlValue) simulationArgs = fl_value_new_map();
+    fl_value_set_string_take(simulationArgs, "startTime", fl_value_new_int(g_get_real_time()));
+    harness.call("enableSimulation", simulationArgs);
+    const char* const timeZones[] = {
+      systemTimeZone == DaylightSavingTimeZone ? "Europe/Berlin" : DaylightSavingTimeZone,
+      systemTimeZone.data(),
+    };
+
+    std::size_t changes = 0;
+    std::int64_t moved = 0;
+    for (auto _ : state) {
+      g_autoptr(FlValue) timeZoneArgs = fl_value_new_map();
+      fl_value_set_string_take(timeZoneArgs, "timeZoneName", fl_value_new_string(timeZones[changes++ % std::size(timeZones)]));
+      g_autoptr(FlValue) result = harness.callForResult("changeSimulatedTimeZone", timeZoneArgs);
+      const auto movedValue = result ? fl_value_lookup_string(result, "moved") : nullptr;
+      if (!movedValue || fl_value_get_int(movedValue) != count) {
+        state.SkipWithError("restored notifications did not follow the system time zone");
+        break;
+      }
+      moved += count;
+    }
+    state.counters["schedules/s"] = benchmark::Counter(static_cast<double>(moved), benchmark::Counter::kIsRate);
+  }
+
+  // Resumes after an hour of suspend with state.range(0) notifications repeating every
+  // minute, all overdue with the misfire policy of index state.range(1).
+  void BM_SimulateResume(benchmark::State& state) {
+    const auto count = state.range(0);
+    const auto policy = state.range(1);
+    Harness harness(state);
+    // 2030-01-01T00:00:00Z
+    gint64 until = G_GINT64_CONSTANT(1893456000) * G_USEC_PER_SEC;
+    g_autoptr(FlValue) simulationArgs = fl_value_new_map();
+    fl_value_set_string_take(simulationArgs, "startTime", fl_value_new_int(until));
+    harness.call("enableSimulation", simulationArgs);
+    auto arguments = ArgumentsOf(count, [policy](std::int64_t id) {
+      return MisfiringArguments(id, policy);
+    });
+    Populate(harness, "periodicallyShow", arguments);
+
+    std::int64_t resumed = 0;
+    for (auto _ : state) {
+      until += G_TIME_SPAN_HOUR;
+      g_autoptr(FlValue) suspendArgs = fl_value_new_map();
+      fl_value_set_string_take(suspendArgs, "until", fl_value_new_int(until));
+      harness.call("suspendSimulation", suspendArgs);
+      state.PauseTiming();
+      harness.call("takeSimulatedFires", nullptr);
+      state.ResumeTiming();
+      resumed += count;
+    }
+    state.counters["schedules/s"] = benchmark::Counter(static_cast<double>(resumed), benchmark::Counter::kIsRate);
+    Release(arguments);
+  }
+
+  // Deletes file, and everything in it if it is a directory, without following symbolic
+  // links.
+  void DeleteRecursively(GFile* file) {
+    g_autoptr(GFileEnumerator) children = g_file_enumerate_children(file, G_FILE_ATTRIBUTE_STANDARD_NAME,
+      G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS, nullptr, nullptr);
+    if (children) {
+      GFile* child;
+      while (g_file_enumerator_iterate(children, nullptr, &child, nullptr, nullptr) && child) {
+        DeleteRecursively(child);
+      }
+    }
+    g_autoptr(GError) error = nullptr;
+    if (!g_file_delete(file, nullptr, &error)) {
+      g_autofree gchar* path = g_file_get_path(file);
+      g_warning("Failed to delete %s: %s", path, error->message);
+    }
+  }
+}
+
+BENCHMARK(BM_Show)->RangeMultiplier(10)->Range(1, 100000);
+BENCHMARK(BM_ShowTraced)->RangeMultiplier(10)->Range(1, 100000);
+BENCHMARK(BM_ShowWithButtons)->RangeMultiplier(10)->Range(1, 100000);
+BENCHMARK(BM_DecodeShowLookup);
+BENCHMARK(BM_DecodeShowSinglePass);
+BENCHMARK(BM_ShowBinary)->RangeMultiplier(10)->Range(1, 100000);
+BENCHMARK(BM_UpdateUnchanged)->RangeMultiplier(10)->Range(1, 100000);
+BENCHMARK(BM_UpdateProgress);
+BENCHMARK(BM_PeriodicallyShow)->RangeMultiplier(10)->Range(1, 100000);
+BENCHMARK(BM_ZonedSchedule)->RangeMultiplier(10)->Range(1, 100000);
+BENCHMARK(BM_ZonedScheduleDaily)->RangeMultiplier(10)->Range(1, 100000);
+BENCHMARK(BM_TimeZoneNew);
+BENCHMARK(BM_TimeZoneCache);
+BENCHMARK(BM_NextDailyModulo);
+BENCHMARK(BM_RecurrenceNext)->DenseRange(0, 3);
+BENCHMARK(BM_Cancel)->RangeMultiplier(10)->Range(1, 100000);
+BENCHMARK(BM_CancelBinary)->RangeMultiplier(10)->Range(1, 100000);
+BENCHMARK(BM_PendingFootprint)->Args({ 100000, 0 })->Args({ 100000, 1 })->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_NativeShowContention)->RangeMultiplier(2)->Range(1, 16)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CancelAll)->RangeMultiplier(10)->Range(1, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_InitializeRestore)->RangeMultiplier(10)->Range(1, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SimulateDailyReminders)->Arg(50000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SimulateTimeZoneChange)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SimulateTimeZoneChangeAfterRestore)->Arg(100000)->Unit(benchmark::kMillisecond);
+// policies fireOnce, fireAll, skip and coalesce
+BENCHMARK(BM_SimulateResume)->Args({ 10000, 0 })->Args({ 10000, 1 })->Args({ 10000, 2 })->Args({ 10000, 3 })
+  ->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv) {
+  // keep the schedule journals of the benchmark out of the user data directory
+  g_autofree gchar* dataDir = g_dir_make_tmp("flutter_local_notifications_benchmark-XXXXXX", nullptr);
+  if (dataDir) {
+    g_setenv("XDG_DATA_HOME", dataDir, TRUE);
+  }
+
+  benchmark::Initialize(&argc, argv);
+  const auto unrecognized = benchmark::ReportUnrecognizedArguments(argc, argv);
+  if (!unrecognized) {
+    benchmark::RunSpecifiedBenchmarks();
+  }
+  benchmark::Shutdown();
+
+  if (dataDir) {
+    g_autoptr(GFile) dir = g_file_new_for_path(dataDir);
+    DeleteRecursively(dir);
+  }
+  return unrecognized ? 1 : 0;
+}
@@ -0,0 +1,232 @@
+#include "binary_codec.h"
+
+#include <cstring>
+#include <string>
+
+namespace flutter_local_notifications {
+  namespace {
+    inline constexpr guint32 NullLength = 0xffffffff;
+
+    inline constexpr guint8 IconFlag = 1 << 0;
+    inline constexpr guint8 PriorityFlag = 1 << 1;
+    inline constexpr guint8 MisfirePolicyFlag = 1 << 2;
+    inline constexpr guint8 GroupKeyFlag = 1 << 3;
+
+    // Reads values from a message in place, once a read fails every later read fails too.
+    class Reader {
+    public:
+      Reader(const guint8* data, std::size_t size) : data(data), size(size) {
+      }
+
+      bool ok() const {
+        return !failed;
+      }
+
+      bool atEnd() const {
+        return offset == size;
+      }
+
+      guint8 readUint8() {
+        guint8 value = 0;
+        read(&value, sizeof(value));
+        return value;
+      }
+
+      gint8 readInt8() {
+        gint8 value = 0;
+        read(&value, sizeof(value));
+        return value;
+      }
+
+      gint32 readInt32() {
+        gint32 value = 0;
+        read(&value, sizeof(value));
+        return GINT32_FROM_LE(value);
+      }
+
+      guint32 readUint32() {
+        guint32 value = 0;
+        read(&value, sizeof(value));
+        return GUINT32_FROM_LE(value);
+      }
+
+      std::string_view readBytes() {
+        const auto length = readUint32();
+        if (failed || length > size - offset) {
+          failed = true;
+          return {};
+        }
+        const std::string_view value(reinterpret_cast<const char*>(data + offset), length);
+        offset += length;
+        return value;
+      }
+
+      // Returns a string of the message, which is null terminated in the message itself.
+      const char* readString() {
+        const auto length = readUint32();
+        if (failed || length == NullLength) {
+          return nullptr;
+        }
+        if (length >= size - offset || data[offset + length] != 0) {
+          failed = true;
+          return nullptr;
+        }
+        const auto value = reinterpret_cast<const char*>(data + offset);
+        offset += length + 1;
+        return value;
+      }
+
+      // Like readString, but null is not allowed.
+      const char* readRequiredString() {
+        const auto value = readString();
+        if (!value) {
+          failed = true;
+        }
+        return value;
+      }
+
+    private:
+      const guint8* data;
+      std::size_t size;
+      std::size_t offset = 0;
+      bool failed = false;
+
+      void read(void* value, std::size_t length) {
+        if (failed || length > size - offset) {
+          failed = true;
+          return;
+        }
+        std::memcpy(value, data + offset, length);
+        offset += length;
+      }
+    };
+
+    void ReadDetails(Reader& reader, NotificationDetailsView& details) {
+      const auto flags = reader.readUint8();
+      if (flags & IconFlag) {
+        const auto source = reader.readUint8();
+        if (source > static_cast<guint8>(IconSource::Theme)) {
+          reader.readBytes();
+        } else {
+          details.iconSource = static_cast<IconSource>(source);
+          details.icon = reader.readBytes();
+        }
+      }
+      if (flags & PriorityFlag) {
+        details.priority = reader.readUint8();
+      }
+      if (flags & MisfirePolicyFlag) {
+        details.misfirePolicy = reader.readUint8();
+      }
+      if (flags & GroupKeyFlag) {
+        details.groupKey = reader.readRequiredString();
+      }
+      const auto buttonCount = reader.readUint8();
+      details.buttons.reserve(buttonCount);
+      for (guint8 i = 0; i < buttonCount && reader.ok(); ++i) {
+        const auto label = reader.readRequiredString();
+        const auto payload = reader.readRequiredString();
+        details.buttons.push_back({ label, payload });
+      }
+    }
+
+    FlValue* DetailsToFlValue(const NotificationDetailsView& details) {
+      const auto result = fl_value_new_map();
+      if (details.iconSource) {
+        const auto icon = fl_value_new_map();
+        if (*details.iconSource == IconSource::Bytes) {
+          fl_value_set_string_take(icon, "icon", fl_value_new_uint8_list(
+            reinterpret_cast<const uint8_t*>(details.icon.data()), details.icon.size()));
+        } else {
+          fl_value_set_string_take(icon, "icon", fl_value_new_string_sized(details.icon.data(), details.icon.size()));
+        }
+        fl_value_set_string_take(icon, "iconSource", fl_value_new_int(static_cast<std::int64_t>(*details.iconSource)));
+        fl_value_set_string_take(result, "icon", icon);
+      }
+      if (details.priority) {
+        fl_value_set_string_take(result, "priority", fl_value_new_int(*details.priority));
+      }
+      if (details.misfirePolicy) {
+        fl_value_set_string_take(result, "misfirePolicy", fl_value_new_int(*details.misfirePolicy));
+      }
+      if (details.groupKey) {
+        fl_value_set_string_take(result, "groupKey", fl_value_new_string(details.groupKey));
+      }
+      if (!details.buttons.empty()) {
+        const auto buttons = fl_value_new_list();
+        for (const auto& button : details.buttons) {
+          const auto buttonValue = fl_value_new_map();
+          fl_value_set_string_take(buttonValue, "buttonLabel", fl_value_new_string(button.label));
+          fl_value_set_string_take(buttonValue, "payload", fl_value_new_string(button.payload));
+          fl_value_append_take(buttons, buttonValue);
+        }
+        fl_value_set_string_take(result, "buttons", buttons);
+      }
+      return result;
+    }
+  }
+
+  bool ReadBinaryMessage(const guint8* data, std::size_t size, BinaryMessage& message) {
+    Reader reader(data, size);
+    message.operation = static_cast<BinaryOperation>(reader.readUint8());
+    message.id = reader.readInt32();
+    switch (message.operation) {
+    case BinaryOperation::Cancel:
+      return reader.ok() && reader.atEnd();
+    case BinaryOperation::Show:
+    case BinaryOperation::PeriodicallyShow:
+    case BinaryOperation::ZonedSchedule:
+      break;
+    default:
+      return false;
+    }
+
+    message.title = reader.readString();
+    message.body = reader.readString();
+    message.payload = reader.readRequiredString();
+    ReadDetails(reader, message.details);
+    if (message.operation == BinaryOperation::PeriodicallyShow) {
+      message.repeatInterval = reader.readUint8();
+    } else if (message.operation == BinaryOperation::ZonedSchedule) {
+      message.timeZoneName = reader.readRequiredString();
+      message.scheduledDateTime = reader.readRequiredString();
+      message.matchDateTimeComponents = reader.readInt8();
+    }
+    return reader.ok() && reader.atEnd();
+  }
+
+  FlValue* BinaryMessageToArguments(const BinaryMessage& message) {
+    const auto args = fl_value_new_map();
+    fl_value_set_string_take(args, "id", fl_value_new_int(message.id));
+    if (message.title) {
+      fl_value_set_string_take(args, "title", fl_value_new_string(message.title));
+    }
+    if (message.body) {
+      fl_value_set_string_take(args, "body", fl_value_new_string(message.body));
+    }
+    fl_value_set_string_take(args, "payload", fl_value_new_string(message.payload));
+    fl_value_set_string_take(args, "platformSpecifics", DetailsToFlValue(message.details));
+    if (message.operation == BinaryOperation::PeriodicallyShow) {
+      fl_value_set_string_take(args, "repeatInterval", fl_value_new_int(message.repeatInterval));
+    } else if (message.operation == BinaryOperation::ZonedSchedule) {
+      fl_value_set_string_take(args, "timeZoneName", fl_value_new_string(message.timeZoneName));
+      fl_value_set_string_take(args, "scheduledDateTime", fl_value_new_string(message.scheduledDateTime));
+      if (message.matchDateTimeComponents >= 0) {
+        fl_value_set_string_take(args, "matchDateTimeComponents", fl_value_new_int(message.matchDateTimeComponents));
+      }
+    }
+    return args;
+  }
+
+  FlValue* BinaryReply(FlMethodResponse* response) {
+    if (!FL_IS_METHOD_ERROR_RESPONSE(response)) {
+      return fl_value_new_uint8_list(nullptr, 0);
+    }
+    const auto error = FL_METHOD_ERROR_RESPONSE(response);
+    const auto message = fl_method_error_response_get_message(error);
+    std::string reply = fl_method_error_response_get_code(error);
+    reply.push_back('\0');
+    reply.append(message ? message : "");
+    return fl_value_new_uint8_list(reinterpret_cast<const uint8_t*>(reply.data()), reply.size());
+  }
+}
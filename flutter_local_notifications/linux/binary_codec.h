@@ -0,0 +1,76 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_BINARY_CODEC_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_BINARY_CODEC_H_
+
+#include <flutter_linux/flutter_linux.h>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "icon_decoder.h"
+
+namespace flutter_local_notifications {
+  // Content of platformSpecifics of a notification. Strings and icon content refer to the
+  // memory of the message it was read from.
+  struct NotificationDetailsView {
+    struct Button {
+      const char* label;
+      const char* payload;
+    };
+
+    std::optional<IconSource> iconSource;
+    std::string_view icon;
+    std::optional<std::int64_t> priority;
+    std::optional<std::int64_t> misfirePolicy;
+    const char* groupKey = nullptr;
+    std::vector<Button> buttons;
+  };
+
+  // Operations of the binary channel, same values as on Dart side.
+  enum class BinaryOperation : guint8 {
+    Show = 1,
+    Cancel = 2,
+    PeriodicallyShow = 3,
+    ZonedSchedule = 4,
+  };
+
+  // A message of the binary channel. Integers are little endian, strings are a uint32
+  // byte length, 0xffffffff for null, followed by the UTF-8 bytes and a null character.
+  //
+  //   cancel: operation:u8 id:i32
+  //   show: operation:u8 id:i32 title:str body:str payload:str details
+  //   periodicallyShow: show repeatInterval:u8
+  //   zonedSchedule: show timeZoneName:str scheduledDateTime:str matchDateTimeComponents:i8
+  //   details: flags:u8, then if flags & 1: iconSource:u8 icon:bytes, if flags & 2:
+  //     priority:u8, if flags & 4: misfirePolicy:u8, if flags & 8: groupKey:str, and
+  //     buttonCount:u8 with label:str payload:str per button
+  //
+  // where bytes is a uint32 length followed by the bytes.
+  struct BinaryMessage {
+    BinaryOperation operation;
+    std::int64_t id;
+    const char* title;
+    const char* body;
+    const char* payload;
+    NotificationDetailsView details;
+    std::int64_t repeatInterval;
+    const char* timeZoneName;
+    const char* scheduledDateTime;
+    // -1 if the notification does not repeat
+    std::int64_t matchDateTimeComponents;
+  };
+
+  // Reads the message of size bytes at data into message, which refers to data.
+  // Returns false if the message is malformed.
+  bool ReadBinaryMessage(const guint8* data, std::size_t size, BinaryMessage& message);
+
+  // Arguments of the method call equivalent to message, for operations other than cancel.
+  FlValue* BinaryMessageToArguments(const BinaryMessage& message);
+
+  // Reply to a message, which is empty on success and the code and message of the error
+  // separated by a null character otherwise.
+  FlValue* BinaryReply(FlMethodResponse* response);
+}
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_BINARY_CODEC_H_
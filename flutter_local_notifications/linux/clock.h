@@ -0,0 +1,52 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_CLOCK_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_CLOCK_H_
+
+#include <glib.h>
+
+namespace flutter_local_notifications {
+  // Source of real time, in microseconds since the Unix epoch like g_get_real_time.
+  class Clock {
+  public:
+    virtual ~Clock() = default;
+
+    virtual gint64 now() const = 0;
+  };
+
+  class SystemClock final : public Clock {
+  public:
+    gint64 now() const override {
+      return g_get_real_time();
+    }
+  };
+
+  // Clock which only moves when it is told to, used by simulations.
+  class VirtualClock final : public Clock {
+  public:
+    explicit VirtualClock(gint64 time) : time(time) {
+    }
+
+    gint64 now() const override {
+      return time;
+    }
+
+    // Moves the clock to time, the clock never goes back.
+    void advanceTo(gint64 newTime) {
+      if (newTime > time) {
+        time = newTime;
+      }
+    }
+
+  private:
+    gint64 time;
+  };
+
+  // Returns a new reference of the time of clock in timeZone.
+  inline GDateTime* NowInTimeZone(const Clock& clock, GTimeZone* timeZone) {
+    const auto now = clock.now();
+    g_autoptr(GDateTime) seconds = g_date_time_new_from_unix_utc(now / G_USEC_PER_SEC);
+    g_autoptr(GDateTime) utc = g_date_time_add(seconds, now % G_USEC_PER_SEC);
+    return g_date_time_to_timezone(utc, timeZone);
+  }
+}
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_CLOCK_H_
@@ -0,0 +1,332 @@
+#include "fdo_backend.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <memory>
+#include <utility>
+
+namespace flutter_local_notifications {
+  namespace {
+    inline constexpr const char BusName[] = "org.freedesktop.Notifications";
+    inline constexpr const char ObjectPath[] = "/org/freedesktop/Notifications";
+    inline constexpr const char InterfaceName[] = "org.freedesktop.Notifications";
+
+    inline constexpr const char FdoNotificationKey[] = "flutter-local-notifications-fdo";
+    inline constexpr const char DefaultActionKey[] = "default";
+    inline constexpr const char ButtonActionKeyPrefix[] = "button-";
+
+    // urgency hint of the specification, which only knows low, normal and critical
+    guchar Urgency(NotificationPriority priority) {
+      switch (priority) {
+      case NotificationPriority::Low:
+        return 0;
+      case NotificationPriority::Urgent:
+        return 2;
+      default:
+        return 1;
+      }
+    }
+
+    // Writes the icon to a file in the runtime directory, since the server can only
+    // take raw pixels otherwise. Files are named by content, so each icon is written once.
+    std::string WriteBytesIcon(GBytes* bytes) {
+      gsize size;
+      const auto data = static_cast<const char*>(g_bytes_get_data(bytes, &size));
+      const auto hash = std::hash<std::string_view>{}(std::string_view(data, size));
+
+      g_autofree gchar* directory = g_build_filename(g_get_user_runtime_dir(), "flutter_local_notifications", "icons", nullptr);
+      g_autofree gchar* name = g_strdup_printf("%016" G_GINT64_MODIFIER "x", static_cast<guint64>(hash));
+      g_autofree gchar* path = g_build_filename(directory, name, nullptr);
+      if (!g_file_test(path, G_FILE_TEST_EXISTS)) {
+        g_autoptr(GError) error = nullptr;
+        if (g_mkdir_with_parents(directory, 0700) != 0 || !g_file_set_contents(path, data, size, &error)) {
+          g_warning("Failed to write notification icon to %s: %s", path, error ? error->message : g_strerror(errno));
+          return {};
+        }
+      }
+      return path;
+    }
+  }
+
+  void AttachFdoNotification(GNotification* notification, FdoNotification content) {
+    g_object_set_data_full(G_OBJECT(notification), FdoNotificationKey, new FdoNotification(std::move(content)),
+      [](gpointer data) { delete static_cast<FdoNotification*>(data); });
+  }
+
+  const FdoNotification* GetFdoNotification(GNotification* notification) {
+    return static_cast<const FdoNotification*>(g_object_get_data(G_OBJECT(notification), FdoNotificationKey));
+  }
+
+  void SetFdoNotificationIcon(GNotification* notification, GIcon* icon) {
+    if (const auto content = static_cast<FdoNotification*>(g_object_get_data(G_OBJECT(notification), FdoNotificationKey))) {
+      content->icon.reset(G_ICON(g_object_ref(icon)));
+    }
+  }
+
+  struct FdoNotificationBackend::CallData {
+    FdoNotificationBackend* backend;
+    std::int64_t id;
+    gint64 startTime;
+  };
+
+  FdoNotificationBackend::FdoNotificationBackend(std::string appName, std::string desktopEntry, ActionCallback onAction, ClosedCallback onClosed)
+    : app_name(std::move(appName)), desktop_entry(std::move(desktopEntry)), on_action(std::move(onAction)),
+      on_closed(std::move(onClosed)), cancellable(g_cancellable_new()) {
+    g_bus_get(G_BUS_TYPE_SESSION, cancellable, onBusReady, this);
+  }
+
+  FdoNotificationBackend::~FdoNotificationBackend() {
+    // pending callbacks see the cancellation and do not touch this anymore
+    g_cancellable_cancel(cancellable);
+    if (connection) {
+      g_dbus_connection_signal_unsubscribe(connection, closed_subscription);
+      g_dbus_connection_signal_unsubscribe(connection, action_subscription);
+      g_object_unref(connection);
+    }
+    g_object_unref(cancellable);
+  }
+
+  void FdoNotificationBackend::notify(std::int64_t id, const FdoNotification& notification) {
+    Request request{
+      notification.summary,
+      notification.body,
+      notification.icon ? iconString(notification.icon.get()) : std::string(),
+      notification.buttons,
+      notification.payload,
+      notification.priority,
+    };
+
+    auto& record = records[id];
+    record.closeRequested = false;
+    if (!connection || record.inFlight) {
+      // dispatched later with the server id of the call in flight, so that it replaces in place
+      record.next = std::move(request);
+      return;
+    }
+    dispatch(id, record, std::move(request));
+  }
+
+  void FdoNotificationBackend::close(std::int64_t id) {
+    const auto iter = records.find(id);
+    if (iter == records.end()) {
+      return;
+    }
+    auto& record = iter->second;
+    if (record.inFlight) {
+      record.closeRequested = true;
+      record.next.reset();
+      return;
+    }
+    if (record.serverId) {
+      closeOnServer(record.serverId);
+      ids.erase(record.serverId);
+    }
+    records.erase(iter);
+  }
+
+  bool FdoNotificationBackend::hasCapability(std::string_view capability) const {
+    return capabilities.find(std::string(capability)) != capabilities.end();
+  }
+
+  void FdoNotificationBackend::dispatch(std::int64_t id, Record& record, Request request) {
+    // before the capabilities are known, assume actions are supported
+    const auto withActions = !capabilities_known || hasCapability("actions");
+
+    GVariantBuilder actions;
+    g_variant_builder_init(&actions, G_VARIANT_TYPE("as"));
+    record.payloads.clear();
+    record.payloads.emplace_back(std::move(request.payload));
+    if (withActions) {
+      g_variant_builder_add(&actions, "s", DefaultActionKey);
+      g_variant_builder_add(&actions, "s", "");
+      for (std::size_t i = 0; i < request.buttons.size(); ++i) {
+        const auto key = ButtonActionKeyPrefix + std::to_string(i);
+        g_variant_builder_add(&actions, "s", key.data());
+        g_variant_builder_add(&actions, "s", request.buttons[i].label.data());
+        record.payloads.emplace_back(std::move(request.buttons[i].payload));
+      }
+    }
+
+    GVariantBuilder hints;
+    g_variant_builder_init(&hints, G_VARIANT_TYPE("a{sv}"));
+    g_variant_builder_add(&hints, "{sv}", "urgency", g_variant_new_byte(Urgency(request.priority)));
+    if (!desktop_entry.empty()) {
+      g_variant_builder_add(&hints, "{sv}", "desktop-entry", g_variant_new_string(desktop_entry.data()));
+    }
+
+    const auto parameters = g_variant_new("(susssasa{sv}i)", app_name.data(), record.serverId, request.appIcon.data(),
+      request.summary.data(), request.body.data(), &actions, &hints, -1);
+
+    record.inFlight = true;
+    ++in_flight;
+    ++stats.calls;
+    g_dbus_connection_call(connection, BusName, ObjectPath, InterfaceName, "Notify", parameters, G_VARIANT_TYPE("(u)"),
+      G_DBUS_CALL_FLAGS_NONE, -1, cancellable, onNotifyReply, new CallData{ this, id, g_get_monotonic_time() });
+  }
+
+  void FdoNotificationBackend::closeOnServer(guint32 serverId) {
+    g_dbus_connection_call(connection, BusName, ObjectPath, InterfaceName, "CloseNotification", g_variant_new("(u)", serverId),
+      nullptr, G_DBUS_CALL_FLAGS_NONE, -1, cancellable, nullptr, nullptr);
+  }
+
+  void FdoNotificationBackend::forgetServerId(Record& record) {
+    if (record.serverId) {
+      ids.erase(std::exchange(record.serverId, 0));
+    }
+  }
+
+  std::string FdoNotificationBackend::iconString(GIcon* icon) const {
+    if (G_IS_THEMED_ICON(icon)) {
+      const auto names = g_themed_icon_get_names(G_THEMED_ICON(icon));
+      return names && names[0] ? names[0] : "";
+    }
+    if (G_IS_FILE_ICON(icon)) {
+      g_autofree gchar* uri = g_file_get_uri(g_file_icon_get_file(G_FILE_ICON(icon)));
+      return uri;
+    }
+    if (G_IS_BYTES_ICON(icon)) {
+      return WriteBytesIcon(g_bytes_icon_get_bytes(G_BYTES_ICON(icon)));
+    }
+    return {};
+  }
+
+  void FdoNotificationBackend::onBusReady(GObject* source, GAsyncResult* result, gpointer data) {
+    g_autoptr(GError) error = nullptr;
+    const auto connection = g_bus_get_finish(result, &error);
+    if (!connection) {
+      if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        g_warning("Failed to connect to session bus, notifications will not be shown: %s", error->message);
+      }
+      return;
+    }
+
+    const auto self = static_cast<FdoNotificationBackend*>(data);
+    self->connection = connection;
+    self->closed_subscription = g_dbus_connection_signal_subscribe(connection, BusName, InterfaceName, "NotificationClosed",
+      ObjectPath, nullptr, G_DBUS_SIGNAL_FLAGS_NONE, onSignal, self, nullptr);
+    self->action_subscription = g_dbus_connection_signal_subscribe(connection, BusName, InterfaceName, "ActionInvoked",
+      ObjectPath, nullptr, G_DBUS_SIGNAL_FLAGS_NONE, onSignal, self, nullptr);
+    g_dbus_connection_call(connection, BusName, ObjectPath, InterfaceName, "GetCapabilities", nullptr, G_VARIANT_TYPE("(as)"),
+      G_DBUS_CALL_FLAGS_NONE, -1, self->cancellable, onCapabilities, self);
+
+    for (auto& [id, record] : self->records) {
+      if (record.next) {
+        self->dispatch(id, record, *std::exchange(record.next, std::nullopt));
+      }
+    }
+  }
+
+  void FdoNotificationBackend::onCapabilities(GObject* source, GAsyncResult* result, gpointer data) {
+    g_autoptr(GError) error = nullptr;
+    g_autoptr(GVariant) reply = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), result, &error);
+    if (!reply) {
+      if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        g_warning("Failed to get capabilities of notification server: %s", error->message);
+      }
+      return;
+    }
+
+    const auto self = static_cast<FdoNotificationBackend*>(data);
+    g_autoptr(GVariantIter) iter = nullptr;
+    const gchar* capability;
+    g_variant_get(reply, "(as)", &iter);
+    while (g_variant_iter_next(iter, "&s", &capability)) {
+      self->capabilities.emplace(capability);
+    }
+    self->capabilities_known = true;
+  }
+
+  void FdoNotificationBackend::onNotifyReply(GObject* source, GAsyncResult* result, gpointer data) {
+    const std::unique_ptr<CallData> call(static_cast<CallData*>(data));
+    g_autoptr(GError) error = nullptr;
+    g_autoptr(GVariant) reply = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), result, &error);
+    if (!reply && g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+      return;
+    }
+
+    const auto self = call->backend;
+    --self->in_flight;
+    const auto latency = g_get_monotonic_time() - call->startTime;
+    self->stats.totalLatency += latency;
+    self->stats.maxLatency = std::max(self->stats.maxLatency, latency);
+
+    const auto iter = self->records.find(call->id);
+    if (iter == self->records.end()) {
+      return;
+    }
+    auto& record = iter->second;
+    record.inFlight = false;
+
+    if (reply) {
+      guint32 serverId;
+      g_variant_get(reply, "(u)", &serverId);
+      if (serverId != record.serverId) {
+        // the server did not know the old id anymore, e.g. it was closed meanwhile
+        self->forgetServerId(record);
+        record.serverId = serverId;
+        self->ids[serverId] = call->id;
+      }
+    } else {
+      ++self->stats.failures;
+      g_warning("Failed to send notification %" G_GINT64_FORMAT ": %s", call->id, error->message);
+    }
+
+    if (record.closeRequested) {
+      if (record.serverId) {
+        self->closeOnServer(record.serverId);
+      }
+      self->forgetServerId(record);
+      self->records.erase(iter);
+    } else if (record.next) {
+      self->dispatch(call->id, record, *std::exchange(record.next, std::nullopt));
+    } else if (!reply && !record.serverId) {
+      self->records.erase(iter);
+    }
+  }
+
+  void FdoNotificationBackend::onSignal(GDBusConnection* connection, const gchar* sender, const gchar* path, const gchar* interface,
+    const gchar* signal, GVariant* parameters, gpointer data) {
+    const auto self = static_cast<FdoNotificationBackend*>(data);
+    const std::string_view signalName(signal);
+
+    if (signalName == "ActionInvoked" && g_variant_is_of_type(parameters, G_VARIANT_TYPE("(us)"))) {
+      guint32 serverId;
+      const gchar* key;
+      g_variant_get(parameters, "(u&s)", &serverId, &key);
+      const auto idIter = self->ids.find(serverId);
+      if (idIter == self->ids.end()) {
+        return;
+      }
+      const auto& payloads = self->records[idIter->second].payloads;
+      const std::string_view keyView(key);
+      std::size_t index = payloads.size();
+      if (keyView == DefaultActionKey) {
+        index = 0;
+      } else if (keyView.substr(0, std::size(ButtonActionKeyPrefix) - 1) == ButtonActionKeyPrefix) {
+        index = std::strtoull(key + std::size(ButtonActionKeyPrefix) - 1, nullptr, 10) + 1;
+      }
+      if (index < payloads.size()) {
+        self->on_action(idIter->second, payloads[index], static_cast<gint32>(index) - 1);
+      }
+    } else if (signalName == "NotificationClosed" && g_variant_is_of_type(parameters, G_VARIANT_TYPE("(uu)"))) {
+      guint32 serverId;
+      guint32 reason;
+      g_variant_get(parameters, "(uu)", &serverId, &reason);
+      const auto idIter = self->ids.find(serverId);
+      if (idIter == self->ids.end()) {
+        return;
+      }
+      const auto id = idIter->second;
+      self->ids.erase(idIter);
+      const auto recordIter = self->records.find(id);
+      if (recordIter->second.inFlight) {
+        // an update is on its way and will be shown as a new notification
+        recordIter->second.serverId = 0;
+        return;
+      }
+      self->records.erase(recordIter);
+      self->on_closed(id, reason);
+    }
+  }
+}
@@ -0,0 +1,135 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_FDO_BACKEND_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_FDO_BACKEND_H_
+
+#include <gio/gio.h>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "admission_queue.h"
+#include "gobject_ptr.h"
+
+namespace flutter_local_notifications {
+  // Content of a notification in terms of org.freedesktop.Notifications.
+  struct FdoNotification {
+    struct Button {
+      std::string label;
+      std::string payload;
+    };
+
+    std::string summary;
+    std::string body;
+    // payload of the default action
+    std::string payload;
+    GObjectPtr<GIcon> icon;
+    std::vector<Button> buttons;
+    NotificationPriority priority = NotificationPriority::Normal;
+  };
+
+  // Attaches content to notification, so that it can be sent by FdoNotificationBackend
+  // whenever notification is sent.
+  void AttachFdoNotification(GNotification* notification, FdoNotification content);
+  const FdoNotification* GetFdoNotification(GNotification* notification);
+  // Replaces the icon of the content attached to notification, if any.
+  void SetFdoNotificationIcon(GNotification* notification, GIcon* icon);
+
+  // Sends notifications to org.freedesktop.Notifications on the session bus directly,
+  // instead of through GApplication. Calls are asynchronous and pipelined, notifications
+  // of the same id replace each other in place, and closed notifications are reported.
+  class FdoNotificationBackend {
+  public:
+    // button is the index of the button, -1 for the default action.
+    using ActionCallback = std::function<void(std::int64_t id, const std::string& payload, gint32 button)>;
+    // reason is as defined by the NotificationClosed signal.
+    using ClosedCallback = std::function<void(std::int64_t id, guint32 reason)>;
+
+    struct Stats {
+      std::uint64_t calls;
+      std::uint64_t failures;
+      // round trip of Notify calls, in microseconds
+      gint64 totalLatency;
+      gint64 maxLatency;
+    };
+
+    FdoNotificationBackend(std::string appName, std::string desktopEntry, ActionCallback onAction, ClosedCallback onClosed);
+    ~FdoNotificationBackend();
+
+    FdoNotificationBackend(const FdoNotificationBackend&) = delete;
+    FdoNotificationBackend& operator=(const FdoNotificationBackend&) = delete;
+
+    void notify(std::int64_t id, const FdoNotification& notification);
+    void close(std::int64_t id);
+
+    // Capabilities are fetched once the bus is connected, until then nothing is supported.
+    bool hasCapability(std::string_view capability) const;
+
+    const Stats& getStats() const {
+      return stats;
+    }
+
+    std::size_t inFlight() const {
+      return in_flight;
+    }
+
+  private:
+    struct Request {
+      std::string summary;
+      std::string body;
+      std::string appIcon;
+      std::vector<FdoNotification::Button> buttons;
+      std::string payload;
+      NotificationPriority priority;
+    };
+
+    struct Record {
+      // 0 if the server has not assigned one yet
+      guint32 serverId = 0;
+      // whether a Notify call of this notification is waiting for reply
+      bool inFlight = false;
+      // the notification is closed once the Notify call in flight returns
+      bool closeRequested = false;
+      // sent once the bus is connected or the call in flight returns
+      std::optional<Request> next;
+      // payloads of the actions of the notification last sent, index 0 is the default action
+      std::vector<std::string> payloads;
+    };
+
+    struct CallData;
+
+    const std::string app_name;
+    const std::string desktop_entry;
+    ActionCallback on_action;
+    ClosedCallback on_closed;
+
+    GCancellable* cancellable;
+    // null until the bus is connected
+    GDBusConnection* connection = nullptr;
+    guint closed_subscription = 0;
+    guint action_subscription = 0;
+    std::unordered_set<std::string> capabilities;
+    bool capabilities_known = false;
+
+    std::unordered_map<std::int64_t, Record> records;
+    std::unordered_map<guint32, std::int64_t> ids;
+    std::size_t in_flight = 0;
+    Stats stats = {};
+
+    void dispatch(std::int64_t id, Record& record, Request request);
+    void closeOnServer(guint32 serverId);
+    void forgetServerId(Record& record);
+    std::string iconString(GIcon* icon) const;
+
+    static void onBusReady(GObject* source, GAsyncResult* result, gpointer data);
+    static void onCapabilities(GObject* source, GAsyncResult* result, gpointer data);
+    static void onNotifyReply(GObject* source, GAsyncResult* result, gpointer data);
+    static void onSignal(GDBusConnection* connection, const gchar* sender, const gchar* path, const gchar* interface,
+      const gchar* signal, GVariant* parameters, gpointer data);
+  };
+}
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_FDO_BACKEND_H_
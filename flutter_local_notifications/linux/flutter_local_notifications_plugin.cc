@@ -1,4 +1,28 @@
 #include "include/flutter_local_notifications/flutter_local_notifications_plugin.h"
+#include "active_set.h"
+#include "admission_queue.h"
+#include "argument_decoder.h"
+#include "binary_codec.h"
+#include "clock.h"
+#include "fdo_backend.h"
+#include "flutter_local_notifications_plugin_private.h"
+#include "gobject_ptr.h"
+#include "icon_cache.h"
+#include "local_time.h"
+#include "metrics.h"
+#include "misfire_coalescer.h"
+#include "native_call_queue.h"
+#include "notification_registry.h"
+#include "recurrence.h"
+#include "schedule_store.h"
+#include "scheduler.h"
+#include "scheduler_helper_client.h"
+#include "selection_buffer.h"
+#include "simulation.h"
+#include "sleep_monitor.h"
+#include "time_zone_monitor.h"
+#include "trace_buffer.h"
+#include "update_coalescer.h"
 
 #include <flutter_linux/flutter_linux.h>
 #include <gtk/gtk.h>
@@ -7,20 +31,69 @@
 #include <cassert>
 #include <unordered_map>
 #include <vector>
+#include <memory>
 #include <utility>
 #include <optional>
 #include <variant>
+#include <algorithm>
 
 #define FLUTTER_LOCAL_NOTIFICATIONS_PLUGIN(obj) \
   (G_TYPE_CHECK_INSTANCE_CAST((obj), flutter_local_notifications_plugin_get_type(), \
                               FlutterLocalNotificationsPlugin))
 
 namespace {
-  enum class IconSource {
-    File,
-    Bytes,
-    Theme,
-  };
+  using flutter_local_notifications::ActiveSet;
+  using flutter_local_notifications::AdmissionQueue;
+  using flutter_local_notifications::ArgumentField;
+  using flutter_local_notifications::BinaryMessage;
+  using flutter_local_notifications::BinaryOperation;
+  using flutter_local_notifications::Clock;
+  using flutter_local_notifications::EvictionPolicy;
+  using flutter_local_notifications::EvictionSummaries;
+  using flutter_local_notifications::EvictionSummaryBody;
+  using flutter_local_notifications::DecodeArguments;
+  using flutter_local_notifications::GObjectPtr;
+  using flutter_local_notifications::IconCache;
+  using flutter_local_notifications::IconDecoder;
+  using flutter_local_notifications::IconSource;
+  using flutter_local_notifications::Histogram;
+  using flutter_local_notifications::Metrics;
+  using flutter_local_notifications::MisfireCoalescer;
+  using flutter_local_notifications::MisfirePolicy;
+  using flutter_local_notifications::Stopwatch;
+  using flutter_local_notifications::NativeCall;
+  using flutter_local_notifications::NativeCallQueue;
+  using flutter_local_notifications::NotificationDetailsView;
+  using flutter_local_notifications::NotificationPriority;
+  using flutter_local_notifications::NotificationRegistry;
+  using flutter_local_notifications::Recurrence;
+  using flutter_local_notifications::RecurrenceRule;
+  using flutter_local_notifications::ScheduleStore;
+  using flutter_local_notifications::Scheduler;
+  using flutter_local_notifications::SchedulerHelperClient;
+  using flutter_local_notifications::SelectionBuffer;
+  using flutter_local_notifications::Simulation;
+  using flutter_local_notifications::SleepMonitor;
+  using flutter_local_notifications::SystemClock;
+  using flutter_local_notifications::UpdateCoalescer;
+  using flutter_local_notifications::DefaultScheduleStorePath;
+  using flutter_local_notifications::TimeZoneCache;
+  using flutter_local_notifications::TimeZoneMonitor;
+  using flutter_local_notifications::TraceBuffer;
+  using flutter_local_notifications::TraceScope;
+  using flutter_local_notifications::SystemTimeZoneName;
+  using flutter_local_notifications::ToLocalSeconds;
+  using flutter_local_notifications::FromLocalSeconds;
+  using flutter_local_notifications::AttachFdoNotification;
+  using flutter_local_notifications::FdoNotification;
+  using flutter_local_notifications::FdoNotificationBackend;
+  using flutter_local_notifications::EncodeButtons;
+  using flutter_local_notifications::ForEachButton;
+  using flutter_local_notifications::GetFdoNotification;
+  using flutter_local_notifications::SetFdoNotificationIcon;
+  using flutter_local_notifications::NextPeriodicDeadline;
+  using flutter_local_notifications::NowInTimeZone;
+  using flutter_local_notifications::ReanchorPeriodicDeadline;
 
   enum class RepeatInterval {
     EveryMinute = 60,
@@ -41,145 +114,496 @@ namespace {
     DayOfWeekAndTime,
   };
 
-  template <typename T>
-  using TypeIdentity = T;
 
-  enum class ModType {
-    Normal,
-    NoZero,
-  };
+  inline constexpr std::size_t IconCacheCapacity = 32;
 
-  template <ModType UsingModType = ModType::Normal, typename NumT>
-  constexpr NumT Mod(NumT a, TypeIdentity<NumT> b) {
-    using std::abs;
-    b = abs(b);
-    const auto result = a % b;
-    if (std::conditional_t<UsingModType == ModType::NoZero, std::less_equal<>, std::less<>>{}(result, 0)) {
-      return result + b;
-    }
-    return result;
-  }
+  // in pixels, file and byte icons larger than this are downscaled
+  inline constexpr int DefaultIconSize = 256;
 
-#if GLIB_CHECK_VERSION(2, 58, 0)
-  GDateTime* GetNextNotifyTime(GDateTime* now, GDateTime* value, DateTimeComponents component) {
-    const auto usingTimeZone = g_date_time_get_timezone(now);
-    const auto nowTimeStamp = g_date_time_to_unix(now);
-    const auto valueTimeStamp = g_date_time_to_unix(value);
-    auto diff = valueTimeStamp - nowTimeStamp;
-    switch (component)
-    {
-    default:
-      assert(!"Invalid component");
-      [[fallthrough]];
-    case DateTimeComponents::Time:
-      diff = Mod(diff, static_cast<gint64>(RepeatInterval::Daily));
-      break;
-    case DateTimeComponents::DayOfWeekAndTime:
-      diff = Mod(diff, static_cast<gint64>(RepeatInterval::Weekly));
-      break;
-    }
-    g_autoptr(GDateTime) utcResult = g_date_time_new_from_unix_utc(nowTimeStamp + diff);
-    return g_date_time_to_timezone(utcResult, usingTimeZone);
-  }
-#endif
-
-  GIcon* CreateIconFromFlValue(FlValue* v) {
+  // Reads the source and content of an icon, returns false if v is not a valid icon.
+  bool ReadIconFromFlValue(FlValue* v, IconSource& iconSource, std::string_view& content) {
     const auto icon = fl_value_lookup_string(v, "icon");
     const auto source = fl_value_lookup_string(v, "iconSource");
     if (!icon || !source || fl_value_get_type(source) != FL_VALUE_TYPE_INT) {
-      return nullptr;
+      return false;
     }
 
-    switch (static_cast<IconSource>(fl_value_get_int(source))) {
+    iconSource = static_cast<IconSource>(fl_value_get_int(source));
+    switch (iconSource) {
     case IconSource::File:
-    {
+    case IconSource::Theme:
       if (fl_value_get_type(icon) != FL_VALUE_TYPE_STRING) {
-        return nullptr;
+        return false;
       }
-      const auto iconFilePath = fl_value_get_string(icon);
-      g_autoptr(GFile) iconFile = g_file_new_for_commandline_arg(iconFilePath);
-      return g_file_icon_new(iconFile);
-    }
+      content = fl_value_get_string(icon);
+      return true;
     case IconSource::Bytes:
     {
       if (fl_value_get_type(icon) != FL_VALUE_TYPE_UINT8_LIST) {
-        return nullptr;
+        return false;
       }
       const auto size = fl_value_get_length(icon);
       const auto data = fl_value_get_uint8_list(icon);
-      g_autoptr(GBytes) bytes = g_bytes_new_static(data, size);
-      return g_bytes_icon_new(bytes);
-    }
-    case IconSource::Theme:
-    {
-      if (fl_value_get_type(icon) != FL_VALUE_TYPE_STRING) {
-        return nullptr;
-      }
-      const auto themeName = fl_value_get_string(icon);
-      return g_themed_icon_new(themeName);
+      content = std::string_view(reinterpret_cast<const char*>(data), size);
+      return true;
     }
     default:
-      return nullptr;
+      return false;
     }
   }
 
-  FlMethodResponse* RequiredArgumentAbsentError(std::string methodName, std::string requiredArgName, FlValue* detail = nullptr) {
-    methodName += "_error";
-    requiredArgName += " is absent, which is required for this operation";
-    return FL_METHOD_RESPONSE(fl_method_error_response_new(methodName.data(), requiredArgName.data(), detail));
+  GIcon* CreateIconFromFlValue(IconCache& iconCache, FlValue* v, IconCache::ReadyCallback ready = nullptr) {
+    IconSource source;
+    std::string_view content;
+    return ReadIconFromFlValue(v, source, content) ? iconCache.get(source, content, std::move(ready)) : nullptr;
   }
 
-  FlMethodResponse* RequiredArgumentTypeError(std::string methodName, std::string requiredArgName, FlValue* detail = nullptr) {
-    methodName += "_error";
-    requiredArgName += " has wrong type, which is required for this operation";
-    return FL_METHOD_RESPONSE(fl_method_error_response_new(methodName.data(), requiredArgName.data(), detail));
+  // A notification which is admitted once its icon is decoded.
+  struct IconWait {
+    // tells the wait apart from later ones of the same id
+    guint64 serial;
+    GObjectPtr<GNotification> notification;
+    NotificationPriority priority;
+  };
+
+  // Starts decoding the icon in the platformSpecifics of notification arguments, if any.
+  void PrewarmIconOfArguments(IconCache& iconCache, FlValue* args) {
+    if (!args || fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
+      return;
+    }
+    const auto platformSpecifics = fl_value_lookup_string(args, "platformSpecifics");
+    if (!platformSpecifics || fl_value_get_type(platformSpecifics) != FL_VALUE_TYPE_MAP) {
+      return;
+    }
+    const auto icon = fl_value_lookup_string(platformSpecifics, "icon");
+    IconSource source;
+    std::string_view content;
+    if (icon && fl_value_get_type(icon) == FL_VALUE_TYPE_MAP && ReadIconFromFlValue(icon, source, content)) {
+      iconCache.prewarm(source, content);
+    }
   }
 
-  FlMethodResponse* OptionalArgument(const char* funcName, const char* argName, FlValue*& arg, FlValueType requiredType) {
-    if (arg) {
-      const auto type = fl_value_get_type(arg);
-      if (type == FL_VALUE_TYPE_NULL) {
-        arg = nullptr;
-        return nullptr;
-      }
-      return type == requiredType ? nullptr : RequiredArgumentTypeError(funcName, argName);
+  // unit is the unit of the recorded values, e.g. "ns"
+  FlValue* HistogramToFlValue(const Histogram& histogram, const char* unit) {
+    const auto& buckets = histogram.getBuckets();
+    // trailing empty buckets are left out
+    auto bucketCount = buckets.size();
+    while (bucketCount > 0 && buckets[bucketCount - 1] == 0) {
+      --bucketCount;
     }
-    return nullptr;
+    std::vector<std::int64_t> bucketValues(buckets.begin(), buckets.begin() + bucketCount);
+
+    const auto result = fl_value_new_map();
+    fl_value_set_string_take(result, "unit", fl_value_new_string(unit));
+    fl_value_set_string_take(result, "count", fl_value_new_int(histogram.getCount()));
+    fl_value_set_string_take(result, "sum", fl_value_new_int(histogram.getSum()));
+    fl_value_set_string_take(result, "max", fl_value_new_int(histogram.getMax()));
+    fl_value_set_string_take(result, "buckets", fl_value_new_int64_list(bucketValues.data(), bucketValues.size()));
+    return result;
   }
 
-  FlMethodResponse* RequireArgument(const char* funcName, const char* argName, FlValue* arg, FlValueType requiredType) {
-    if (!arg) {
-      return RequiredArgumentAbsentError(funcName, argName);
+  // Converts the response of a single operation of a batch into its item of the batch result,
+  // which is the result value of a succeeded operation, or a map with the code, message and
+  // details of a failed operation.
+  FlValue* BatchItemResult(FlMethodResponse* response) {
+    if (FL_IS_METHOD_SUCCESS_RESPONSE(response)) {
+      const auto result = fl_method_success_response_get_result(FL_METHOD_SUCCESS_RESPONSE(response));
+      return result ? fl_value_ref(result) : fl_value_new_null();
     }
-    if (fl_value_get_type(arg) != requiredType) {
-      return RequiredArgumentTypeError(funcName, argName);
+    const auto error = fl_value_new_map();
+    if (FL_IS_METHOD_ERROR_RESPONSE(response)) {
+      const auto errorResponse = FL_METHOD_ERROR_RESPONSE(response);
+      const auto message = fl_method_error_response_get_message(errorResponse);
+      const auto details = fl_method_error_response_get_details(errorResponse);
+      fl_value_set_string_take(error, "code", fl_value_new_string(fl_method_error_response_get_code(errorResponse)));
+      fl_value_set_string_take(error, "message", message ? fl_value_new_string(message) : fl_value_new_null());
+      fl_value_set_string_take(error, "details", details ? fl_value_ref(details) : fl_value_new_null());
+    } else {
+      fl_value_set_string_take(error, "code", fl_value_new_string("notImplemented"));
     }
-    return nullptr;
+    return error;
   }
 
 #define APP_ACTION_PREFIX "app."
 #define NOTIFICATION_ACTION_NAME "flutter-local-notifications-action"
+#define NOTIFICATION_BUTTON_ACTION_NAME "flutter-local-notifications-button"
 
+  // Activated with (id, payload) by the notification itself.
   inline constexpr const char NotificationActionName[] = NOTIFICATION_ACTION_NAME;
 
   inline constexpr const char NotificationActionBindingName[] = APP_ACTION_PREFIX NOTIFICATION_ACTION_NAME;
+
+  // Activated with (id, payload, index) by its buttons.
+  inline constexpr const char NotificationButtonActionName[] = NOTIFICATION_BUTTON_ACTION_NAME;
+
+  inline constexpr const char NotificationButtonActionBindingName[] = APP_ACTION_PREFIX NOTIFICATION_BUTTON_ACTION_NAME;
+
+  struct CommonArguments {
+    std::int64_t id;
+    const char* title = "";
+    const char* body = nullptr;
+    const char* payload;
+    FlValue* platformSpecifics = nullptr;
+  };
+
+  struct PeriodicallyShowArguments : CommonArguments {
+    std::int64_t repeatInterval;
+  };
+
+  struct ZonedScheduleArguments : CommonArguments {
+    const char* timeZoneName;
+    const char* scheduledDateTime;
+    std::optional<std::int64_t> matchDateTimeComponents;
+    FlValue* recurrence = nullptr;
+  };
+
+  struct RecurrenceArguments {
+    std::int64_t frequency;
+    std::optional<std::int64_t> interval;
+    FlValue* weekdays = nullptr;
+    std::optional<std::int64_t> weekOfMonth;
+    std::optional<std::int64_t> endTime;
+    std::optional<std::int64_t> until;
+  };
+
+  struct LinuxNotificationDetails {
+    FlValue* icon = nullptr;
+    FlValue* buttons = nullptr;
+    std::optional<std::int64_t> priority;
+    std::optional<std::int64_t> misfirePolicy;
+    const char* groupKey = nullptr;
+  };
+
+  struct AdmissionSettings {
+    FlValue* rate = nullptr;
+    std::optional<std::int64_t> burst;
+    std::optional<std::int64_t> maxQueueDepth;
+  };
+
+  struct MisfireSummarySettings {
+    std::int64_t id;
+    const char* title;
+  };
+
+  struct ActiveLimitSettings {
+    std::int64_t maxActivePerGroup;
+    std::optional<std::int64_t> policy;
+    const char* summaryTitle = nullptr;
+    std::optional<std::int64_t> summaryBaseId;
+  };
+
+  struct SimulationArguments {
+    std::int64_t startTime;
+  };
+
+  struct AdvanceSimulationArguments {
+    std::int64_t until;
+  };
+
+  struct SimulatedTimeZoneArguments {
+    const char* timeZoneName;
+  };
+
+  struct DumpTraceArguments {
+    const char* path = nullptr;
+  };
+
+  struct NotificationButton {
+    const char* buttonLabel;
+    const char* payload;
+  };
+
+#define COMMON_ARGUMENT_FIELDS(T) \
+    { "id", FL_VALUE_TYPE_INT, true, &T::id }, \
+    { "title", FL_VALUE_TYPE_STRING, false, &T::title }, \
+    { "body", FL_VALUE_TYPE_STRING, false, &T::body }, \
+    { "payload", FL_VALUE_TYPE_STRING, true, &T::payload }, \
+    { "platformSpecifics", FL_VALUE_TYPE_MAP, false, &T::platformSpecifics }
+
+  inline constexpr ArgumentField<CommonArguments> CommonArgumentFields[] = {
+    COMMON_ARGUMENT_FIELDS(CommonArguments),
+  };
+
+  inline constexpr ArgumentField<PeriodicallyShowArguments> PeriodicallyShowArgumentFields[] = {
+    COMMON_ARGUMENT_FIELDS(PeriodicallyShowArguments),
+    { "repeatInterval", FL_VALUE_TYPE_INT, true, &PeriodicallyShowArguments::repeatInterval },
+  };
+
+  inline constexpr ArgumentField<ZonedScheduleArguments> ZonedScheduleArgumentFields[] = {
+    COMMON_ARGUMENT_FIELDS(ZonedScheduleArguments),
+    { "timeZoneName", FL_VALUE_TYPE_STRING, true, &ZonedScheduleArguments::timeZoneName },
+    { "scheduledDateTime", FL_VALUE_TYPE_STRING, true, &ZonedScheduleArguments::scheduledDateTime },
+    { "matchDateTimeComponents", FL_VALUE_TYPE_INT, false, &ZonedScheduleArguments::matchDateTimeComponents },
+    { "recurrence", FL_VALUE_TYPE_MAP, false, &ZonedScheduleArguments::recurrence },
+  };
+
+#undef COMMON_ARGUMENT_FIELDS
+
+  inline constexpr ArgumentField<RecurrenceArguments> RecurrenceArgumentFields[] = {
+    { "frequency", FL_VALUE_TYPE_INT, true, &RecurrenceArguments::frequency },
+    { "interval", FL_VALUE_TYPE_INT, false, &RecurrenceArguments::interval },
+    { "weekdays", FL_VALUE_TYPE_LIST, false, &RecurrenceArguments::weekdays },
+    { "weekOfMonth", FL_VALUE_TYPE_INT, false, &RecurrenceArguments::weekOfMonth },
+    { "endTime", FL_VALUE_TYPE_INT, false, &RecurrenceArguments::endTime },
+    { "until", FL_VALUE_TYPE_INT, false, &RecurrenceArguments::until },
+  };
+
+  inline constexpr ArgumentField<LinuxNotificationDetails> LinuxNotificationDetailsFields[] = {
+    { "icon", FL_VALUE_TYPE_MAP, false, &LinuxNotificationDetails::icon },
+    { "buttons", FL_VALUE_TYPE_LIST, false, &LinuxNotificationDetails::buttons },
+    { "priority", FL_VALUE_TYPE_INT, false, &LinuxNotificationDetails::priority },
+    { "misfirePolicy", FL_VALUE_TYPE_INT, false, &LinuxNotificationDetails::misfirePolicy },
+    { "groupKey", FL_VALUE_TYPE_STRING, false, &LinuxNotificationDetails::groupKey },
+  };
+
+  inline constexpr ArgumentField<SimulationArguments> SimulationArgumentFields[] = {
+    { "startTime", FL_VALUE_TYPE_INT, true, &SimulationArguments::startTime },
+  };
+
+  inline constexpr ArgumentField<AdvanceSimulationArguments> AdvanceSimulationArgumentFields[] = {
+    { "until", FL_VALUE_TYPE_INT, true, &AdvanceSimulationArguments::until },
+  };
+
+  inline constexpr ArgumentField<SimulatedTimeZoneArguments> SimulatedTimeZoneArgumentFields[] = {
+    { "timeZoneName", FL_VALUE_TYPE_STRING, true, &SimulatedTimeZoneArguments::timeZoneName },
+  };
+
+  inline constexpr ArgumentField<DumpTraceArguments> DumpTraceArgumentFields[] = {
+    { "path", FL_VALUE_TYPE_STRING, false, &DumpTraceArguments::path },
+  };
+
+  inline constexpr ArgumentField<AdmissionSettings> AdmissionSettingsFields[] = {
+    { "rate", FL_VALUE_TYPE_FLOAT, false, &AdmissionSettings::rate },
+    { "burst", FL_VALUE_TYPE_INT, false, &AdmissionSettings::burst },
+    { "maxQueueDepth", FL_VALUE_TYPE_INT, false, &AdmissionSettings::maxQueueDepth },
+  };
+
+  inline constexpr ArgumentField<MisfireSummarySettings> MisfireSummarySettingsFields[] = {
+    { "id", FL_VALUE_TYPE_INT, true, &MisfireSummarySettings::id },
+    { "title", FL_VALUE_TYPE_STRING, true, &MisfireSummarySettings::title },
+  };
+
+  inline constexpr ArgumentField<ActiveLimitSettings> ActiveLimitSettingsFields[] = {
+    { "maxActivePerGroup", FL_VALUE_TYPE_INT, true, &ActiveLimitSettings::maxActivePerGroup },
+    { "policy", FL_VALUE_TYPE_INT, false, &ActiveLimitSettings::policy },
+    { "summaryTitle", FL_VALUE_TYPE_STRING, false, &ActiveLimitSettings::summaryTitle },
+    { "summaryBaseId", FL_VALUE_TYPE_INT, false, &ActiveLimitSettings::summaryBaseId },
+  };
+
+  // Same order as LinuxNotificationBackend on Dart side.
+  enum class NotificationBackend {
+    GApplication,
+    Freedesktop,
+  };
+
+  inline constexpr AdmissionQueue::Config DefaultAdmissionConfig = { 20, 20, 512 };
+
+  // in microseconds, i.e. at most 10 updates per second per notification
+  inline constexpr gint64 DefaultUpdateCoalescingWindow = 100 * 1000;
+
+  // selections kept until Dart is listening, e.g. the one which launched the app
+  inline constexpr std::size_t SelectionBufferCapacity = 64;
+
+  // in microseconds, how late a scheduled notification may fire before its misfire policy
+  // applies
+  inline constexpr gint64 DefaultMisfireThreshold = 60 * G_USEC_PER_SEC;
+  inline constexpr std::int64_t DefaultMisfireSummaryId = G_MAXINT32;
+  inline constexpr const char DefaultMisfireSummaryTitle[] = "Missed notifications";
+
+  // ids of eviction summaries count down from below the misfire summary
+  inline constexpr std::int64_t DefaultEvictionSummaryBaseId = G_MAXINT32 - 1;
+  inline constexpr const char DefaultEvictionSummaryTitle[] = "Earlier notifications";
+
+  GNotificationPriority ToGNotificationPriority(NotificationPriority priority) {
+    switch (priority) {
+    case NotificationPriority::Low:
+      return G_NOTIFICATION_PRIORITY_LOW;
+    case NotificationPriority::High:
+      return G_NOTIFICATION_PRIORITY_HIGH;
+    case NotificationPriority::Urgent:
+      return G_NOTIFICATION_PRIORITY_URGENT;
+    default:
+      return G_NOTIFICATION_PRIORITY_NORMAL;
+    }
+  }
+
+  inline constexpr ArgumentField<NotificationButton> NotificationButtonFields[] = {
+    { "buttonLabel", FL_VALUE_TYPE_STRING, true, &NotificationButton::buttonLabel },
+    { "payload", FL_VALUE_TYPE_STRING, true, &NotificationButton::payload },
+  };
+
+  // Reads platformSpecifics of notification arguments, which may be null. Invalid
+  // platformSpecifics are ignored, as are invalid buttons.
+  NotificationDetailsView ReadNotificationDetails(FlValue* platformSpecifics) {
+    NotificationDetailsView view;
+    if (!platformSpecifics) {
+      return view;
+    }
+    LinuxNotificationDetails details;
+    if (const auto resp = DecodeArguments(__func__, platformSpecifics, LinuxNotificationDetailsFields, details)) {
+      g_warning("Ignoring invalid platformSpecifics: %s", fl_method_error_response_get_message(FL_METHOD_ERROR_RESPONSE(resp)));
+      g_object_unref(resp);
+      return view;
+    }
+    IconSource iconSource;
+    if (details.icon && ReadIconFromFlValue(details.icon, iconSource, view.icon)) {
+      view.iconSource = iconSource;
+    }
+    view.priority = details.priority;
+    view.misfirePolicy = details.misfirePolicy;
+    view.groupKey = details.groupKey;
+    if (details.buttons) {
+      const auto buttonSize = fl_value_get_length(details.buttons);
+      view.buttons.reserve(buttonSize);
+      for (std::size_t i = 0; i < buttonSize; ++i) {
+        const auto buttonValue = fl_value_get_list_value(details.buttons, i);
+        assert(buttonValue && fl_value_get_type(buttonValue) == FL_VALUE_TYPE_MAP);
+
+        NotificationButton button;
+        if (const auto resp = DecodeArguments(__func__, buttonValue, NotificationButtonFields, button)) {
+          g_object_unref(resp);
+          continue;
+        }
+        view.buttons.push_back({ button.buttonLabel, button.payload });
+      }
+    }
+    return view;
+  }
+
+  std::optional<NotificationPriority> ReadPriority(const NotificationDetailsView& details) {
+    if (!details.priority) {
+      return std::nullopt;
+    }
+    return static_cast<NotificationPriority>(std::clamp<std::int64_t>(*details.priority,
+      static_cast<std::int64_t>(NotificationPriority::Low), static_cast<std::int64_t>(NotificationPriority::Urgent)));
+  }
+
+  MisfirePolicy ReadMisfirePolicy(const NotificationDetailsView& details) {
+    if (!details.misfirePolicy || *details.misfirePolicy < 0
+        || *details.misfirePolicy > static_cast<std::int64_t>(MisfirePolicy::Coalesce)) {
+      return MisfirePolicy::FireOnce;
+    }
+    return static_cast<MisfirePolicy>(*details.misfirePolicy);
+  }
+
+  // Returns the id of the notification which a method call with args is about, for
+  // TraceBuffer.
+  std::int64_t NotificationIdOf(FlValue* args) {
+    if (args && fl_value_get_type(args) == FL_VALUE_TYPE_INT) {
+      return fl_value_get_int(args);
+    }
+    if (args && fl_value_get_type(args) == FL_VALUE_TYPE_MAP) {
+      const auto id = fl_value_lookup_string(args, "id");
+      if (id && fl_value_get_type(id) == FL_VALUE_TYPE_INT) {
+        return fl_value_get_int(id);
+      }
+    }
+    return TraceBuffer::NoId;
+  }
+
+  // Name of the method equivalent to operation, so that both channels trace alike.
+  const char* BinaryOperationName(BinaryOperation operation) {
+    switch (operation) {
+    case BinaryOperation::Show:
+      return "show";
+    case BinaryOperation::Cancel:
+      return "cancel";
+    case BinaryOperation::PeriodicallyShow:
+      return "periodicallyShow";
+    case BinaryOperation::ZonedSchedule:
+      return "zonedSchedule";
+    }
+    return "binary";
+  }
+
+  FlMethodResponse* RecurrenceRangeError(const char* field) {
+    const auto message = std::string(field) + " of recurrence is not in valid range";
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("zonedSchedule_error", message.data(), nullptr));
+  }
+
+#if GLIB_CHECK_VERSION(2, 58, 0)
+  // Repeats at the time of day, and on the weekday if weekly, of scheduledDateTime from
+  // now on, even if scheduledDateTime is later, which is what matchDateTimeComponents has
+  // always meant on Linux.
+  Recurrence MatchingRecurrence(GTimeZone* timeZone, GDateTime* scheduledDateTime, GDateTime* now, DateTimeComponents components) {
+    g_autoptr(GDateTime) local = g_date_time_to_timezone(scheduledDateTime, timeZone);
+    RecurrenceRule rule;
+    if (components == DateTimeComponents::DayOfWeekAndTime) {
+      rule.frequency = RecurrenceRule::Frequency::Weekly;
+      rule.weekdays = 1 << (g_date_time_get_day_of_week(local) - 1);
+    }
+    // rules with an interval of 1 do not depend on the day of their start, which only
+    // has to be before now
+    g_autoptr(GDateTime) yesterday = g_date_time_add_days(now, -1);
+    g_autoptr(GDateTime) start = g_date_time_new(timeZone, g_date_time_get_year(yesterday), g_date_time_get_month(yesterday),
+      g_date_time_get_day_of_month(yesterday), g_date_time_get_hour(local), g_date_time_get_minute(local), g_date_time_get_second(local));
+    return Recurrence(rule, timeZone, start && g_date_time_compare(start, local) < 0 ? start : local);
+  }
+#endif
+
+  std::string NotificationIdString(std::int64_t id) {
+    return "flutter_local_notifications#" + std::to_string(id);
+  }
 }
 
-#define RequireArg(arg, requiredType) if (const auto resp = ::RequireArgument(__func__, #arg, arg, requiredType)) { return resp; }
-#define OptionalArg(arg, requiredType) if (const auto resp = ::OptionalArgument(__func__, #arg, arg, requiredType)) { return resp; }
+#define RequireArg(arg, requiredType) if (const auto resp = flutter_local_notifications::RequireArgument(__func__, #arg, arg, requiredType)) { return resp; }
+#define OptionalArg(arg, requiredType) if (const auto resp = flutter_local_notifications::OptionalArgument(__func__, #arg, arg, requiredType)) { return resp; }
+#define DecodeArgs(args, fields, out) if (const auto resp = DecodeArguments(__func__, args, fields, out)) { return resp; }
 
 struct _FlutterLocalNotificationsPlugin {
   GObject parent_instance;
 
   FlPluginRegistrar* registrar;
   FlMethodChannel* channel;
+  // Opt-in channel of BinaryMessage for show, cancel and schedules
+  FlBasicMessageChannel* binary_channel;
+  // Only set if the plugin is headless, i.e. not registered with a registrar
+  GApplication* application;
 
   GIcon* default_icon;
-
-  std::vector<int64_t>* notifications;
-
-  // Key: notification id, Value: task id
-  std::unordered_map<int64_t, int>* periodic_notification_map;
+  IconDecoder* icon_decoder;
+  IconCache* icon_cache;
+  // shown notifications whose icon is still being decoded, by id
+  std::unordered_map<std::int64_t, IconWait>* icon_waits;
+  guint64 icon_wait_serial;
+
+  TimeZoneCache* time_zones;
+  NotificationRegistry* registry;
+  AdmissionQueue* admission_queue;
+  UpdateCoalescer* update_coalescer;
+  SelectionBuffer* selections;
+  bool actions_registered;
+
+  SystemClock* system_clock;
+  // system_clock, or the virtual clock of simulation
+  const Clock* clock;
+  Scheduler* scheduler;
+  Metrics* metrics;
+  // Created on enableSimulation, notifications are then recorded instead of sent
+  Simulation* simulation;
+  // Created on initialize
+  ScheduleStore* schedule_store;
+  // Created on initialize if the freedesktop backend is selected
+  FdoNotificationBackend* fdo_backend;
+  // Created on initialize if the scheduler helper is enabled, pending notifications are
+  // mirrored to it so that they fire while the app is not running
+  SchedulerHelperClient* scheduler_helper;
+  // in microseconds, see DefaultMisfireThreshold
+  gint64 misfire_threshold;
+  MisfireCoalescer* misfires;
+  // Created on initialize
+  SleepMonitor* sleep_monitor;
+  // Created on initialize, unless schedules are not to follow the system time zone
+  TimeZoneMonitor* time_zone_monitor;
+  // Zone followed by the schedules in it, see onSystemTimeZoneChanged. Null if schedules
+  // do not follow the system time zone, and set by changeSimulatedTimeZone in simulations.
+  gchar* system_time_zone;
+  // shown notifications by group, unlimited unless configured on initialize
+  ActiveSet* active_set;
+  EvictionPolicy eviction_policy;
+  EvictionSummaries* eviction_summaries;
+  // Created on initialize if tracing is enabled, records lifecycle events of notifications
+  TraceBuffer* trace;
 
   GtkWidget* getTopLevel() const {
     const auto view = GTK_WIDGET(fl_plugin_registrar_get_view(registrar));
@@ -187,308 +611,1255 @@ struct _FlutterLocalNotificationsPlugin {
     return topLevel;
   }
 
-  GtkApplication* getApplication() const {
-    return gtk_window_get_application(GTK_WINDOW(getTopLevel()));
+  GApplication* getApplication() const {
+    if (application) {
+      return application;
+    }
+    return G_APPLICATION(gtk_window_get_application(GTK_WINDOW(getTopLevel())));
   }
 
-  FlMethodResponse* initialize(FlMethodCall* call) {
-    const auto args = fl_method_call_get_args(call);
+  FlMethodResponse* initialize(FlValue* args) {
+    auto followSystemTimeZone = true;
     if (args && fl_value_get_type(args) == FL_VALUE_TYPE_MAP) {
+      const auto iconSize = fl_value_lookup_string(args, "iconSize");
+      if (iconSize && fl_value_get_type(iconSize) == FL_VALUE_TYPE_INT && fl_value_get_int(iconSize) > 0
+          && fl_value_get_int(iconSize) != icon_decoder->getSize()) {
+        icon_decoder->setSize(fl_value_get_int(iconSize));
+        icon_cache->clear();
+      }
       const auto defaultIconValue = fl_value_lookup_string(args, "defaultIcon");
       if (defaultIconValue && fl_value_get_type(defaultIconValue) == FL_VALUE_TYPE_MAP) {
-        default_icon = CreateIconFromFlValue(defaultIconValue);
+        default_icon = CreateIconFromFlValue(*icon_cache, defaultIconValue, [this](GIcon* icon, GIcon* decoded) {
+          if (default_icon == icon) {
+            g_object_unref(std::exchange(default_icon, G_ICON(g_object_ref(decoded))));
+          }
+        });
       }
       const auto knownShowingNotifications = fl_value_lookup_string(args, "knownShowingNotifications");
       if (knownShowingNotifications && fl_value_get_type(knownShowingNotifications) == FL_VALUE_TYPE_INT64_LIST) {
         const auto size = fl_value_get_length(knownShowingNotifications);
         const auto knownShowingNotificationsValue = fl_value_get_int64_list(knownShowingNotifications);
-        notifications->assign(knownShowingNotificationsValue, knownShowingNotificationsValue + size);
+        for (std::size_t i = 0; i < size; ++i) {
+          registry->markShown(knownShowingNotificationsValue[i]);
+        }
+      }
+      const auto admission = fl_value_lookup_string(args, "admission");
+      if (admission && fl_value_get_type(admission) == FL_VALUE_TYPE_MAP) {
+        AdmissionSettings settings;
+        DecodeArgs(admission, AdmissionSettingsFields, settings);
+        auto config = DefaultAdmissionConfig;
+        if (settings.rate) {
+          config.rate = fl_value_get_float(settings.rate);
+        }
+        if (settings.burst) {
+          config.burst = std::max<std::int64_t>(*settings.burst, 1);
+        }
+        if (settings.maxQueueDepth) {
+          config.maxDepth = std::max<std::int64_t>(*settings.maxQueueDepth, 0);
+        }
+        admission_queue->configure(config);
+      }
+      const auto updateCoalescingWindow = fl_value_lookup_string(args, "updateCoalescingWindow");
+      if (updateCoalescingWindow && fl_value_get_type(updateCoalescingWindow) == FL_VALUE_TYPE_INT) {
+        update_coalescer->setWindow(std::max<std::int64_t>(fl_value_get_int(updateCoalescingWindow), 0));
+      }
+      const auto backend = fl_value_lookup_string(args, "backend");
+      if (backend && fl_value_get_type(backend) == FL_VALUE_TYPE_INT
+          && static_cast<NotificationBackend>(fl_value_get_int(backend)) == NotificationBackend::Freedesktop && !fdo_backend) {
+        const auto appId = g_application_get_application_id(G_APPLICATION(getApplication()));
+        const auto appName = g_get_application_name();
+        fdo_backend = new FdoNotificationBackend(appName ? appName : (appId ? appId : ""), appId ? appId : "",
+          [this](std::int64_t id, const std::string& payload, gint32 button) {
+            activate(id, payload.data(), button);
+          },
+          [this](std::int64_t id, guint32 reason) {
+            registry->markDismissed(id);
+            active_set->remove(id);
+            eviction_summaries->reset(id);
+          });
+      }
+      const auto misfireThreshold = fl_value_lookup_string(args, "misfireThreshold");
+      if (misfireThreshold && fl_value_get_type(misfireThreshold) == FL_VALUE_TYPE_INT) {
+        misfire_threshold = std::max<std::int64_t>(fl_value_get_int(misfireThreshold), 0);
+      }
+      const auto misfireSummary = fl_value_lookup_string(args, "misfireSummary");
+      if (misfireSummary && fl_value_get_type(misfireSummary) == FL_VALUE_TYPE_MAP) {
+        MisfireSummarySettings settings;
+        DecodeArgs(misfireSummary, MisfireSummarySettingsFields, settings);
+        misfires->setSummary({ settings.id, settings.title });
+      }
+      const auto activeLimit = fl_value_lookup_string(args, "activeLimit");
+      if (activeLimit && fl_value_get_type(activeLimit) == FL_VALUE_TYPE_MAP) {
+        ActiveLimitSettings settings;
+        DecodeArgs(activeLimit, ActiveLimitSettingsFields, settings);
+        active_set->setCapacity(std::max<std::int64_t>(settings.maxActivePerGroup, 0));
+        if (settings.policy && *settings.policy >= 0 && *settings.policy <= static_cast<std::int64_t>(EvictionPolicy::Summarize)) {
+          eviction_policy = static_cast<EvictionPolicy>(*settings.policy);
+        }
+        if (settings.summaryTitle) {
+          eviction_summaries->setTitle(settings.summaryTitle);
+        }
+        if (settings.summaryBaseId) {
+          eviction_summaries->setBaseId(*settings.summaryBaseId);
+        }
+      }
+      const auto traceEventCapacity = fl_value_lookup_string(args, "traceEventCapacity");
+      if (traceEventCapacity && fl_value_get_type(traceEventCapacity) == FL_VALUE_TYPE_INT && fl_value_get_int(traceEventCapacity) > 0
+          && !trace) {
+        trace = new TraceBuffer(fl_value_get_int(traceEventCapacity));
+      }
+      const auto followSystemTimeZoneValue = fl_value_lookup_string(args, "followSystemTimeZone");
+      if (followSystemTimeZoneValue && fl_value_get_type(followSystemTimeZoneValue) == FL_VALUE_TYPE_BOOL) {
+        followSystemTimeZone = fl_value_get_bool(followSystemTimeZoneValue);
+      }
+      const auto schedulerHelper = fl_value_lookup_string(args, "schedulerHelper");
+      if (schedulerHelper && fl_value_get_type(schedulerHelper) == FL_VALUE_TYPE_BOOL && fl_value_get_bool(schedulerHelper)
+          && !scheduler_helper && !simulation) {
+        const auto appId = g_application_get_application_id(G_APPLICATION(getApplication()));
+        const auto appName = g_get_application_name();
+        scheduler_helper = new SchedulerHelperClient(appId ? appId : "", appName ? appName : (appId ? appId : ""), appId ? appId : "",
+          [this](std::int64_t id, const std::string& payload, gint32 button) {
+            activate(id, payload.data(), button);
+          },
+          [this](std::int64_t id) {
+            dropFiredByHelper(id);
+          },
+          [this]() {
+            for (const auto id : registry->pendingIds()) {
+              mirrorScheduledNotification(id);
+            }
+          });
       }
     }
 
     const auto app = getApplication();
-    const GActionEntry actionEntries[] = {
-      {
-        NotificationActionName,
-        [](GSimpleAction* action, GVariant* param, gpointer opaque) {
-          g_autoptr(GVariant) id = g_variant_get_child_value(param, 0);
-          const auto idValue = g_variant_get_int64(id);
-          g_autoptr(GVariant) payload = g_variant_get_child_value(param, 1);
-          const auto payloadValue = g_variant_get_string(payload, nullptr);
-
-          const auto plugin = static_cast<FlutterLocalNotificationsPlugin*>(opaque);
-
-          g_autoptr(FlValue) arg = fl_value_new_map();
-          fl_value_set_string_take(arg, "id", fl_value_new_int(idValue));
-          fl_value_set_string_take(arg, "payload", fl_value_new_string(payloadValue));
-          fl_method_channel_invoke_method(plugin->channel, "selectNotification", arg, nullptr, nullptr, nullptr);
-        },
-        "(xs)"
+    // in case the application was not known yet when the plugin was registered
+    registerActions();
+    // selections received so far, including the one which launched the app, are delivered
+    // now that Dart is listening
+    selections->setListening(channel != nullptr);
+    if (!sleep_monitor) {
+      sleep_monitor = new SleepMonitor([this]() {
+        onResume();
+      });
+    }
+    if (!followSystemTimeZone) {
+      delete std::exchange(time_zone_monitor, nullptr);
+      g_clear_pointer(&system_time_zone, g_free);
+    } else if (!time_zone_monitor && !simulation) {
+      startTimeZoneMonitor();
+    }
+
+    // simulated schedules are not persisted, restored ones follow system_time_zone
+    if (!schedule_store && !simulation) {
+      schedule_store = new ScheduleStore(DefaultScheduleStorePath(g_application_get_application_id(G_APPLICATION(app))));
+      // if the zone changed while the app was not running, schedules are restored in the
+      // zone they followed and moved to the current one afterwards
+      g_autofree gchar* currentTimeZone = nullptr;
+      if (system_time_zone) {
+        const auto recordedTimeZone = schedule_store->readTimeZone();
+        if (!recordedTimeZone.empty() && recordedTimeZone != system_time_zone) {
+          currentTimeZone = std::exchange(system_time_zone, g_strdup(recordedTimeZone.data()));
+        }
+      }
+      const auto replayStartTime = g_get_monotonic_time();
+      const auto replayedCount = schedule_store->replay([this](std::int64_t id, gint64 deadline, gint64 repeatInterval, FlValue* arguments) {
+        restoreScheduledNotification(id, deadline, repeatInterval, arguments);
+      });
+      g_debug("Restored %" G_GSIZE_FORMAT " scheduled notifications from %s in %" G_GINT64_FORMAT " us",
+        replayedCount, schedule_store->getPath().data(), g_get_monotonic_time() - replayStartTime);
+      if (currentTimeZone) {
+        onSystemTimeZoneChanged(currentTimeZone);
+      } else if (system_time_zone) {
+        schedule_store->recordTimeZone(system_time_zone);
+      }
+    }
+    // after the replay, so that notifications the helper fired meanwhile are dropped
+    if (scheduler_helper) {
+      scheduler_helper->attach();
+    }
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+  }
+
+  // Adds the actions activated by notifications to the application, as early as possible
+  // so that the activation which launched the app is not missed.
+  void registerActions() {
+    const auto app = getApplication();
+    if (actions_registered || !app) {
+      return;
+    }
+    const auto activate = [](GSimpleAction* action, GVariant* param, gpointer opaque) {
+      g_autoptr(GVariant) id = g_variant_get_child_value(param, 0);
+      g_autoptr(GVariant) payload = g_variant_get_child_value(param, 1);
+      gint32 button = -1;
+      if (g_variant_n_children(param) > 2) {
+        g_autoptr(GVariant) index = g_variant_get_child_value(param, 2);
+        button = g_variant_get_int32(index);
       }
+      const auto plugin = static_cast<FlutterLocalNotificationsPlugin*>(opaque);
+      plugin->activate(g_variant_get_int64(id), g_variant_get_string(payload, nullptr), button);
+    };
+    const GActionEntry actionEntries[] = {
+      { NotificationActionName, activate, "(xs)" },
+      { NotificationButtonActionName, activate, "(xsi)" },
     };
     g_action_map_add_action_entries(G_ACTION_MAP(app), actionEntries, std::size(actionEntries), this);
-    return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+    actions_registered = true;
+  }
+
+  // Called once the notification id, or its button of index button, has been activated.
+  void activate(std::int64_t id, const char* payload, gint32 button) {
+    if (trace) {
+      trace->instant("activate", id);
+    }
+    selections->push(id, payload, button);
   }
 
-  GNotification* buildNotification(int64_t id, const char* title, const char* body, const char* payload, FlValue* platformSpecifics) {
+  void selectNotifications(FlValue* batch) {
+    if (!channel) {
+      return;
+    }
+    if (trace) {
+      const auto ids = fl_value_lookup_string(batch, "ids");
+      for (std::size_t i = 0, size = fl_value_get_length(ids); i < size; ++i) {
+        trace->instant("selectNotification", fl_value_get_int64_list(ids)[i]);
+      }
+    }
+    fl_method_channel_invoke_method(channel, "selectNotifications", batch, nullptr, nullptr, nullptr);
+  }
+
+  // Builds the notification of a pending entry, once it is needed.
+  GNotification* buildPendingNotification(int64_t id, const NotificationRegistry::Entry& entry) {
+    const auto& strings = registry->strings();
+    std::vector<NotificationDetailsView::Button> buttons;
+    ForEachButton(strings.get(entry.buttons), [&buttons](const char* label, const char* payload) {
+      buttons.push_back({ label, payload });
+    });
+    const auto& body = strings.get(entry.body);
+    return buildNotification(id, strings.get(entry.title).data(), body.empty() ? nullptr : body.data(),
+      strings.get(entry.payload).data(), entry.icon.get(), entry.priority, buttons);
+  }
+
+  // default_icon is used if icon is null.
+  GNotification* buildNotification(int64_t id, const char* title, const char* body, const char* payload, GIcon* icon,
+    std::optional<NotificationPriority> priority, const std::vector<NotificationDetailsView::Button>& buttons) {
+    const TraceScope traceScope(trace, "buildNotification", id);
     GNotification* notification = g_notification_new(title);
     if (body) {
       g_notification_set_body(notification, body);
     }
     g_notification_set_default_action_and_target(notification, NotificationActionBindingName, "(xs)", id, payload);
 
-    if (platformSpecifics) {
-      const auto icon = fl_value_lookup_string(platformSpecifics, "icon");
-      g_autoptr(GIcon) usingIcon = icon && fl_value_get_type(icon) == FL_VALUE_TYPE_MAP ? CreateIconFromFlValue(icon) : nullptr;
-      if (!usingIcon && default_icon) {
-        g_object_ref(default_icon);
-        usingIcon = default_icon;
+    // fdo_backend and scheduler_helper cannot read the content back from notification, so
+    // it is kept aside
+    std::optional<FdoNotification> fdoNotification;
+    if (fdo_backend || scheduler_helper) {
+      fdoNotification.emplace();
+      fdoNotification->summary = title ? title : "";
+      fdoNotification->body = body ? body : "";
+      fdoNotification->payload = payload ? payload : "";
+    }
+
+    const auto usingIcon = icon ? icon : default_icon;
+    if (usingIcon) {
+      g_notification_set_icon(notification, usingIcon);
+      if (fdoNotification) {
+        fdoNotification->icon.reset(G_ICON(g_object_ref(usingIcon)));
       }
-      if (usingIcon) {
-        g_notification_set_icon(notification, usingIcon);
+    }
+
+    if (priority) {
+      g_notification_set_priority(notification, ToGNotificationPriority(*priority));
+      if (fdoNotification) {
+        fdoNotification->priority = *priority;
       }
+    }
+
+    for (std::size_t i = 0; i < buttons.size(); ++i) {
+      const auto& button = buttons[i];
+      g_notification_add_button_with_target(notification, button.label, NotificationButtonActionBindingName, "(xsi)", id, button.payload, static_cast<gint32>(i));
+      if (fdoNotification) {
+        fdoNotification->buttons.push_back({ button.label, button.payload });
+      }
+    }
+
+    if (fdoNotification) {
+      AttachFdoNotification(notification, std::move(*fdoNotification));
+    }
+    return notification;
+  }
+
+  // Content of the notification must have been set in registry. Its GNotification is only
+  // built once it fires.
+  // arguments are recorded to schedule_store if they are present, so that the notification
+  // can be restored by restoreScheduledNotification after a restart.
+  // arguments are the ones of the method call which scheduled the notification, which are
+  // recorded to schedule_store unless they are replayed from it.
+  void addScheduledNotification(std::int64_t id, const NotificationDetailsView& details, gint64 deadline, gint64 repeatInterval,
+    FlValue* arguments, std::optional<Recurrence> recurrence = std::nullopt, bool record = true) {
+    // the icon as is is replaced once it is decoded, it is only sent that way if the
+    // notification fires before
+    GObjectPtr<GIcon> icon(details.iconSource ? icon_cache->get(*details.iconSource, details.icon, [this, id](GIcon* asIs, GIcon* decoded) {
+      useDecodedIcon(id, asIs, decoded);
+    }) : nullptr);
+    auto& entry = registry->markPending(id, std::move(icon), EncodeButtons(details.buttons), deadline, repeatInterval);
+    registry->setGroup(entry, details.groupKey);
+    entry.recurrence = std::move(recurrence);
+    entry.priority = ReadPriority(details).value_or(NotificationPriority::Normal);
+    entry.misfirePolicy = ReadMisfirePolicy(details);
+    entry.followsSystemTimeZone = isInSystemTimeZone(arguments);
+    scheduler->schedule(id, deadline);
+    if (trace) {
+      trace->instant("arm", id, deadline);
+    }
+    if (record && arguments && schedule_store) {
+      schedule_store->recordSchedule(id, deadline, repeatInterval, arguments);
+    }
+    mirrorScheduledNotification(id);
+  }
 
-      const auto buttons = fl_value_lookup_string(platformSpecifics, "buttons");
-      if (buttons && fl_value_get_type(buttons) == FL_VALUE_TYPE_LIST) {
-        const auto buttonSize = fl_value_get_length(buttons);
-        for (std::size_t i = 0; i < buttonSize; ++i) {
-          const auto button = fl_value_get_list_value(buttons, i);
-          assert(button && fl_value_get_type(button) == FL_VALUE_TYPE_MAP);
+  void useDecodedIcon(std::int64_t id, GIcon* icon, GIcon* decoded) {
+    const auto entry = registry->find(id);
+    if (decoded == icon || !entry || !entry->pending || entry->icon.get() != icon) {
+      return;
+    }
+    entry->icon.reset(G_ICON(g_object_ref(decoded)));
+    mirrorScheduledNotification(id);
+  }
 
-          const auto label = fl_value_get_string(fl_value_lookup_string(button, "buttonLabel"));
-          const auto buttonPayload = fl_value_get_string(fl_value_lookup_string(button, "payload"));
+  void mirrorScheduledNotification(std::int64_t id) {
+    if (!scheduler_helper || simulation) {
+      return;
+    }
+    const auto entry = registry->find(id);
+    if (!entry || !entry->pending) {
+      return;
+    }
+    // carries the content for the helper
+    g_autoptr(GNotification) notification = buildPendingNotification(id, *entry);
+    scheduler_helper->schedule(id, entry->nextFireTime, entry->repeatInterval, entry->recurrence, *GetFdoNotification(notification));
+  }
 
-          g_notification_add_button_with_target(notification, label, NotificationActionBindingName, "(xs)", id, buttonPayload);
+  // Called for notifications which the helper fired for the last time while the app was
+  // not running.
+  void dropFiredByHelper(std::int64_t id) {
+    const auto entry = registry->find(id);
+    if (!entry || !entry->pending) {
+      return;
+    }
+    scheduler->cancel(id);
+    registry->markFired(id);
+    if (schedule_store) {
+      schedule_store->recordCancel(id);
+    }
+  }
+
+  void restoreScheduledNotification(std::int64_t id, gint64 deadline, gint64 repeatInterval, FlValue* arguments) {
+    const auto commonArgs = getCommonArguments(arguments);
+    if (const auto resp = std::get_if<FlMethodResponse*>(&commonArgs)) {
+      g_object_unref(*resp);
+      return;
+    }
+    [[maybe_unused]] const auto [unused, title, body, payload, platformSpecifics] = std::get<1>(commonArgs);
+
+    const auto recurrence = repeatInterval > 0 ? getRecurrence(arguments) : std::nullopt;
+    if (recurrence) {
+      if (deadline <= clock->now()) {
+        const auto next = recurrence->next(clock->now());
+        if (!next) {
+          return;
         }
+        deadline = *next;
       }
+    } else if (repeatInterval > 0) {
+      deadline = NextPeriodicDeadline(deadline, repeatInterval, clock->now());
+    }
+    registry->setContent(id, title, body, payload);
+    addScheduledNotification(id, ReadNotificationDetails(platformSpecifics), deadline, repeatInterval, arguments, recurrence, false);
+  }
+
+  // Returns how the notification scheduled with arguments repeats, if it was scheduled
+  // by zonedSchedule with matchDateTimeComponents or a recurrence rule.
+  std::optional<Recurrence> getRecurrence(FlValue* arguments) {
+#if GLIB_CHECK_VERSION(2, 58, 0)
+    std::optional<Recurrence> recurrence;
+    ZonedScheduleArguments zonedScheduleArgs;
+    FlMethodResponse* resp = DecodeArguments(__func__, arguments, ZonedScheduleArgumentFields, zonedScheduleArgs);
+    if (!resp) {
+      const auto timeZone = time_zones->get(zonedScheduleArgs.timeZoneName);
+      g_autoptr(GDateTime) scheduledDateTime = g_date_time_new_from_iso8601(zonedScheduleArgs.scheduledDateTime, timeZone);
+      g_autoptr(GDateTime) now = NowInTimeZone(*clock, timeZone);
+      resp = scheduledDateTime ? decodeRecurrence(zonedScheduleArgs, timeZone, scheduledDateTime, now, recurrence) : nullptr;
+    }
+    if (resp) {
+      g_object_unref(resp);
+    }
+    return recurrence;
+#else
+    return std::nullopt;
+#endif
+  }
+
+#if GLIB_CHECK_VERSION(2, 58, 0)
+  // Decodes how the notification scheduled with zonedScheduleArgs repeats into recurrence,
+  // which is left empty if the notification fires once.
+  FlMethodResponse* decodeRecurrence(const ZonedScheduleArguments& zonedScheduleArgs, GTimeZone* timeZone, GDateTime* scheduledDateTime,
+    GDateTime* now, std::optional<Recurrence>& recurrence) {
+    if (zonedScheduleArgs.matchDateTimeComponents) {
+      recurrence = MatchingRecurrence(timeZone, scheduledDateTime, now,
+        static_cast<DateTimeComponents>(*zonedScheduleArgs.matchDateTimeComponents));
+      return nullptr;
+    }
+    if (!zonedScheduleArgs.recurrence) {
+      return nullptr;
+    }
+
+    RecurrenceArguments recurrenceArgs;
+    DecodeArgs(zonedScheduleArgs.recurrence, RecurrenceArgumentFields, recurrenceArgs);
+    RecurrenceRule rule;
+    if (recurrenceArgs.frequency < 0 || recurrenceArgs.frequency > static_cast<std::int64_t>(RecurrenceRule::Frequency::Monthly)) {
+      return RecurrenceRangeError("frequency");
+    }
+    rule.frequency = static_cast<RecurrenceRule::Frequency>(recurrenceArgs.frequency);
+    if (recurrenceArgs.interval) {
+      if (*recurrenceArgs.interval < 1 || *recurrenceArgs.interval > G_MAXUINT16) {
+        return RecurrenceRangeError("interval");
+      }
+      rule.interval = static_cast<guint16>(*recurrenceArgs.interval);
+    }
+    if (const auto weekdays = recurrenceArgs.weekdays) {
+      for (std::size_t i = 0, size = fl_value_get_length(weekdays); i < size; ++i) {
+        const auto weekday = fl_value_get_list_value(weekdays, i);
+        if (fl_value_get_type(weekday) != FL_VALUE_TYPE_INT || fl_value_get_int(weekday) < 1 || fl_value_get_int(weekday) > 7) {
+          return RecurrenceRangeError("weekdays");
+        }
+        rule.weekdays |= 1 << (fl_value_get_int(weekday) - 1);
+      }
+    }
+    if (recurrenceArgs.weekOfMonth) {
+      if (*recurrenceArgs.weekOfMonth < -1 || *recurrenceArgs.weekOfMonth > 5) {
+        return RecurrenceRangeError("weekOfMonth");
+      }
+      rule.weekOfMonth = static_cast<gint8>(*recurrenceArgs.weekOfMonth);
+    }
+    if (recurrenceArgs.endTime) {
+      if (*recurrenceArgs.endTime < 0 || *recurrenceArgs.endTime >= flutter_local_notifications::SecondsPerDay) {
+        return RecurrenceRangeError("endTime");
+      }
+      rule.endOfDay = static_cast<gint32>(*recurrenceArgs.endTime);
+    }
+    rule.until = recurrenceArgs.until.value_or(0);
+    recurrence.emplace(rule, timeZone, scheduledDateTime);
+    return nullptr;
+  }
+#endif
+
+  // Called by admission_queue once notification is allowed to be sent.
+  void sendNotification(std::int64_t id, GNotification* notification) {
+    const Stopwatch stopwatch;
+    const TraceScope traceScope(trace, "send", id);
+    const auto fdoNotification = fdo_backend ? GetFdoNotification(notification) : nullptr;
+    if (simulation) {
+      simulation->recordSend();
+    } else if (fdoNotification) {
+      fdo_backend->notify(id, *fdoNotification);
     } else {
-      if (default_icon) {
-        g_notification_set_icon(notification, default_icon);
+      g_application_send_notification(G_APPLICATION(getApplication()), NotificationIdString(id).data(), notification);
+    }
+    registry->markShown(id);
+    trackActive(id);
+    metrics->recordSend(stopwatch);
+  }
+
+  // Evicts the notifications shown least recently from the group of id, once it has more
+  // than the capacity of active_set.
+  void trackActive(std::int64_t id) {
+    const auto entry = registry->find(id);
+    if (active_set->getCapacity() == 0 || eviction_summaries->isSummary(id) || !entry) {
+      return;
+    }
+    const auto& group = registry->strings().get(entry->group);
+    std::vector<std::int64_t> evicted;
+    active_set->touch(id, group, evicted);
+    if (evicted.empty()) {
+      return;
+    }
+
+    const EvictionSummaries::Summary* summary = nullptr;
+    std::vector<std::int64_t> destroyed;
+    for (const auto victim : evicted) {
+      const auto victimEntry = registry->find(victim);
+      if (!victimEntry) {
+        continue;
+      }
+      if (eviction_policy == EvictionPolicy::Summarize) {
+        summary = &eviction_summaries->add(group, registry->strings().get(victimEntry->title));
+      }
+      withdrawShown(victim);
+      // repeating notifications are still pending, and will be shown again
+      if (registry->stateOf(victim) == NotificationRegistry::State::Withdrawn) {
+        destroyed.push_back(victim);
       }
     }
-    return notification;
+    if (summary) {
+      const auto body = EvictionSummaryBody(*summary);
+      showNotification(summary->id, eviction_summaries->titleOf(group).data(), body.data(), "", NotificationDetailsView{});
+    }
+    if (!destroyed.empty() && channel) {
+      g_autoptr(FlValue) ids = fl_value_new_int64_list(destroyed.data(), destroyed.size());
+      fl_method_channel_invoke_method(channel, "notificationsEvicted", ids, nullptr, nullptr, nullptr);
+    }
   }
 
-  void doPeriodicallyShow(GApplication* app, std::int64_t id, GNotification*& notification, std::string&& notificationId, RepeatInterval repeatInterval) {
-    const auto data = new std::tuple{ app, std::exchange(notification, nullptr), std::move(notificationId) };
-    const auto taskId = g_timeout_add_seconds_full(G_PRIORITY_DEFAULT, static_cast<guint>(repeatInterval), [](gpointer p) -> gboolean {
-      const auto& [app, notification, notificationIdString] = *static_cast<decltype(data)>(p);
-      g_application_send_notification(app, notificationIdString.data(), notification);
-      return TRUE;
-    }, static_cast<gpointer>(data), [](gpointer p) {
-      const auto ptr = static_cast<decltype(data)>(p);
-      g_object_unref(std::get<GNotification*>(*ptr));
-      delete ptr;
+  // Withdraws the notification from the notification server, it stays pending if it is.
+  void withdrawShown(std::int64_t id) {
+    registry->markDismissed(id);
+    if (simulation) {
+      return;
+    }
+    if (fdo_backend) {
+      fdo_backend->close(id);
+    }
+    g_application_withdraw_notification(G_APPLICATION(getApplication()), NotificationIdString(id).data());
+  }
+
+  // Notifications which fire later than misfire_threshold follow their misfire policy.
+  std::optional<gint64> fireScheduledNotification(std::int64_t id, gint64 deadline) {
+    const TraceScope traceScope(trace, "fire", id, deadline);
+    const auto entry = registry->find(id);
+    if (!entry || !entry->pending) {
+      return std::nullopt;
+    }
+    const auto now = clock->now();
+    metrics->recordFireLateness(now - deadline);
+    const auto policy = now - deadline > misfire_threshold ? entry->misfirePolicy : MisfirePolicy::FireOnce;
+    if (policy == MisfirePolicy::Coalesce) {
+      misfires->add(registry->strings().get(entry->title));
+    } else if (policy != MisfirePolicy::Skip) {
+      if (simulation) {
+        simulation->recordFire(id, deadline);
+      }
+      g_autoptr(GNotification) notification = buildPendingNotification(id, *entry);
+      admit(id, notification, entry->priority);
+    }
+
+    // the occurrences missed after deadline are fired by the same dispatch, as they are due
+    const auto catchUp = policy == MisfirePolicy::FireAll && ++entry->catchUpFires < flutter_local_notifications::MaxCatchUpFires;
+    if (!catchUp) {
+      entry->catchUpFires = 0;
+    }
+    const auto after = catchUp ? deadline : std::max(deadline, now);
+    std::optional<gint64> next;
+    if (entry->recurrence) {
+      next = entry->recurrence->next(after);
+    } else if (entry->repeatInterval > 0) {
+      next = NextPeriodicDeadline(deadline, entry->repeatInterval, after);
+    }
+    if (!next) {
+      registry->markFired(id);
+      if (schedule_store) {
+        schedule_store->recordCancel(id);
+      }
+      // the helper would fire it again once the app exits
+      if (scheduler_helper && !simulation) {
+        scheduler_helper->cancel(id);
+      }
+      return std::nullopt;
+    }
+    entry->nextFireTime = *next;
+    if (trace) {
+      trace->instant("arm", id, *next);
+    }
+    return next;
+  }
+
+  void sendMisfireSummary(const MisfireCoalescer::Summary& summary, const std::string& body) {
+    update_coalescer->remove(summary.id);
+    showNotification(summary.id, summary.title.data(), body.data(), "", NotificationDetailsView{});
+  }
+
+  // Called once the system resumed from suspend. Every notification which became due
+  // meanwhile is handled in one pass, and misfires are summarized right away, instead of
+  // waiting for the timer, whose GLib timeout fallback does not count suspended time.
+  void onResume() {
+    scheduler->fireDue();
+    misfires->flush();
+  }
+
+  void startTimeZoneMonitor() {
+    time_zone_monitor = new TimeZoneMonitor([this](const std::string& name) {
+      // the simulated time zone is changed by changeSimulatedTimeZone only
+      if (!simulation) {
+        onSystemTimeZoneChanged(name.data());
+      }
     });
-    periodic_notification_map->emplace(id, taskId);
+    const auto& name = time_zone_monitor->getName();
+    g_free(system_time_zone);
+    system_time_zone = name.empty() ? nullptr : g_strdup(name.data());
+  }
+
+  // Returns whether the notification scheduled with arguments was scheduled by
+  // zonedSchedule in the system time zone, which it then follows.
+  bool isInSystemTimeZone(FlValue* arguments) const {
+    if (!system_time_zone || !arguments || fl_value_get_type(arguments) != FL_VALUE_TYPE_MAP) {
+      return false;
+    }
+    const auto timeZoneName = fl_value_lookup_string(arguments, "timeZoneName");
+    return timeZoneName && fl_value_get_type(timeZoneName) == FL_VALUE_TYPE_STRING
+      && g_strcmp0(fl_value_get_string(timeZoneName), system_time_zone) == 0;
+  }
+
+  // Called once the system time zone changed to name. Schedules in the previous zone keep
+  // their wall clock time in the new one, which moves their deadlines in one pass over the
+  // scheduler, followed by a single rearm of its timer. The moved schedules are recorded to
+  // the journal in the new zone, which is recorded as well, so that a restart neither
+  // restores their former deadlines nor misses a change while the app was not running.
+  // Returns the number of schedules moved.
+  std::size_t onSystemTimeZoneChanged(const char* name) {
+    g_autofree gchar* previous = std::exchange(system_time_zone, g_strdup(name));
+    if (g_strcmp0(previous, name) == 0) {
+      return 0;
+    }
+    if (!previous) {
+      if (schedule_store) {
+        schedule_store->recordTimeZone(name);
+      }
+      return 0;
+    }
+    const auto from = time_zones->get(previous);
+    const auto to = time_zones->get(name);
+    std::vector<std::int64_t> moved;
+    scheduler->reanchorAll([this, from, to, &moved](std::int64_t id, gint64 deadline, gint64 now) {
+      const auto entry = registry->find(id);
+      if (!entry || !entry->followsSystemTimeZone) {
+        return deadline;
+      }
+      moved.push_back(id);
+      return moveToTimeZone(*entry, deadline, now, from, to);
+    });
+    // the helper and the journal keep their own deadlines
+    for (const auto id : moved) {
+      mirrorScheduledNotification(id);
+    }
+    if (schedule_store) {
+      std::vector<std::pair<std::int64_t, gint64>> deadlines;
+      deadlines.reserve(moved.size());
+      for (const auto id : moved) {
+        deadlines.emplace_back(id, registry->find(id)->nextFireTime);
+      }
+      schedule_store->recordMovedToTimeZone(deadlines, name);
+    }
+    g_debug("Moved %" G_GSIZE_FORMAT " scheduled notifications from %s to %s", moved.size(), previous, name);
+    return moved.size();
+  }
+
+  // Returns the deadline of entry with the wall clock time it has in from, in to. Overdue
+  // deadlines are left to fire.
+  gint64 moveToTimeZone(NotificationRegistry::Entry& entry, gint64 deadline, gint64 now, GTimeZone* from, GTimeZone* to) {
+    if (entry.recurrence) {
+      entry.recurrence->setTimeZone(to);
+      if (deadline > now) {
+        entry.nextFireTime = entry.recurrence->next(now).value_or(deadline);
+      }
+    } else if (deadline > now) {
+      entry.nextFireTime = FromLocalSeconds(to, ToLocalSeconds(from, deadline));
+    }
+    return entry.nextFireTime;
+  }
+
+  gint64 reanchorScheduledNotification(std::int64_t id, gint64 deadline, gint64 now) {
+    const auto entry = registry->find(id);
+    if (!entry || entry->repeatInterval <= 0) {
+      return deadline;
+    }
+    if (entry->recurrence) {
+      entry->nextFireTime = deadline <= now ? deadline : entry->recurrence->next(now).value_or(deadline);
+    } else {
+      entry->nextFireTime = ReanchorPeriodicDeadline(deadline, entry->repeatInterval, now);
+    }
+    return entry->nextFireTime;
+  }
+
+  void doPeriodicallyShow(std::int64_t id, const NotificationDetailsView& details, RepeatInterval repeatInterval, FlValue* arguments) {
+    const auto interval = static_cast<gint64>(repeatInterval) * G_USEC_PER_SEC;
+    addScheduledNotification(id, details, clock->now() + interval, interval, arguments);
   }
 
 #if GLIB_CHECK_VERSION(2, 58, 0)
-  void doZonedSchedule(GApplication* app, std::int64_t id, GNotification*& notification, std::string&& notificationId, GDateTime* now, GDateTime* scheduledDateTime, std::optional<DateTimeComponents> matchDateTimeComponents) {
-    if (matchDateTimeComponents) {
-      const auto matchDateTimeComponentsValue = *matchDateTimeComponents;
-      const auto nextNotifyTime = GetNextNotifyTime(now, scheduledDateTime, matchDateTimeComponentsValue);
-      const auto initialDiff = g_date_time_to_unix(nextNotifyTime) - g_date_time_to_unix(now);
-      const auto data = new std::tuple{ G_APPLICATION(app), std::exchange(notification, nullptr), std::move(notificationId),
-        static_cast<guint>(matchDateTimeComponentsValue == DateTimeComponents::Time ? RepeatInterval::Daily : RepeatInterval::Weekly),
-        id, this };
-      const auto taskId = g_timeout_add_seconds(initialDiff, [](gpointer p) -> gboolean {
-        const auto& [app, notification, notificationId, repeatInterval, id, plugin] = *static_cast<decltype(data)>(p);
-        g_application_send_notification(app, notificationId.data(), notification);
-        // delays may accumulate here
-        const auto taskId = g_timeout_add_seconds_full(G_PRIORITY_DEFAULT, repeatInterval, [](gpointer p) -> gboolean {
-          [[maybe_unused]] const auto& [app, notification, notificationId, unused, unused2, unused3] = *static_cast<decltype(data)>(p);
-          g_application_send_notification(app, notificationId.data(), notification);
-          return TRUE;
-        }, p, [](gpointer p) {
-          const auto ptr = static_cast<decltype(data)>(p);
-          g_object_unref(std::get<GNotification*>(*ptr));
-          delete ptr;
-        });
-        // possible race condition?
-        plugin->periodic_notification_map->insert_or_assign(id, taskId);
-        return FALSE;
-      }, static_cast<gpointer>(data));
-      periodic_notification_map->emplace(id, taskId);
+  // recurrence must have an occurrence after now.
+  void doZonedSchedule(std::int64_t id, const NotificationDetailsView& details, GDateTime* now, GDateTime* scheduledDateTime,
+    const std::optional<Recurrence>& recurrence, FlValue* arguments) {
+    if (recurrence) {
+      addScheduledNotification(id, details, *recurrence->next(clock->now()), recurrence->period(), arguments, recurrence);
     } else {
-      const auto diff = g_date_time_to_unix(scheduledDateTime) - g_date_time_to_unix(now);
       // this should be guaranteed by flutter side
-      assert(diff > 0);
-      const auto data = new std::tuple{ G_APPLICATION(app), std::exchange(notification, nullptr), std::move(notificationId), id, this };
-      const auto taskId = g_timeout_add_seconds_full(G_PRIORITY_DEFAULT, diff, [](gpointer p) -> gboolean {
-        const auto& [app, notification, notificationId, id, plugin] = *static_cast<decltype(data)>(p);
-        g_application_send_notification(app, notificationId.data(), notification);
-        plugin->periodic_notification_map->erase(id);
-        return FALSE;
-      }, static_cast<gpointer>(data), [](gpointer p) {
-        const auto ptr = static_cast<decltype(data)>(p);
-        g_object_unref(std::get<GNotification*>(*ptr));
-        delete ptr;
-      });
-      periodic_notification_map->emplace(id, taskId);
+      assert(g_date_time_compare(scheduledDateTime, now) > 0);
+      addScheduledNotification(id, details, g_date_time_to_unix(scheduledDateTime) * G_USEC_PER_SEC, 0, arguments);
     }
   }
 #endif
 
-  struct CommonArguments {
-    std::int64_t id;
-    const char* title;
-    const char* body;
-    const char* payload;
-    FlValue* platformSpecifics;
-  };
-
   std::variant<FlMethodResponse*, CommonArguments> getCommonArguments(FlValue* args) {
-    const auto id = fl_value_lookup_string(args, "id");
-    RequireArg(id, FL_VALUE_TYPE_INT);
-    auto title = fl_value_lookup_string(args, "title");
-    OptionalArg(title, FL_VALUE_TYPE_STRING);
-    auto body = fl_value_lookup_string(args, "body");
-    OptionalArg(body, FL_VALUE_TYPE_STRING);
-    const auto payload = fl_value_lookup_string(args, "payload");
-    RequireArg(payload, FL_VALUE_TYPE_STRING);
-    auto platformSpecifics = fl_value_lookup_string(args, "platformSpecifics");
-    OptionalArg(platformSpecifics, FL_VALUE_TYPE_MAP);
-
-    const auto idValue = fl_value_get_int(id);
-    const auto titleValue = title ? fl_value_get_string(title) : "";
-    const auto bodyValue = body ? fl_value_get_string(body) : nullptr;
-    const auto payloadValue = fl_value_get_string(payload);
-
-    return CommonArguments{ idValue, titleValue, bodyValue, payloadValue, platformSpecifics };
-  }
-
-  FlMethodResponse* show(FlMethodCall* call) {
-    const auto args = fl_method_call_get_args(call);
+    CommonArguments commonArgs;
+    DecodeArgs(args, CommonArgumentFields, commonArgs);
+    return commonArgs;
+  }
+
+  FlMethodResponse* show(FlValue* args) {
     RequireArg(args, FL_VALUE_TYPE_MAP);
 
-    const auto commonArgs = getCommonArguments(args);
-    if (const auto resp = std::get_if<FlMethodResponse*>(&commonArgs)) {
-      return *resp;
+    CommonArguments showArgs;
+    DecodeArgs(args, CommonArgumentFields, showArgs);
+    // later updates are compared with this content instead of the one last updated
+    update_coalescer->remove(showArgs.id);
+    showNotification(showArgs);
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+  }
+
+  void showNotification(const CommonArguments& showArgs) {
+    const auto [id, title, body, payload, platformSpecifics] = showArgs;
+    showNotification(id, title, body, payload, ReadNotificationDetails(platformSpecifics));
+  }
+
+  // A notification whose icon is still being decoded is only admitted once it is decoded,
+  // instead of waiting for the decoder here.
+  void showNotification(std::int64_t id, const char* title, const char* body, const char* payload, const NotificationDetailsView& details) {
+    const auto serial = ++icon_wait_serial;
+    auto iconDecoding = false;
+    g_autoptr(GIcon) icon = details.iconSource ? icon_cache->get(*details.iconSource, details.icon, [this, id, serial](GIcon*, GIcon* decoded) {
+      admitWithDecodedIcon(id, serial, decoded);
+    }, &iconDecoding) : nullptr;
+    const auto priority = ReadPriority(details);
+    g_autoptr(GNotification) notification = buildNotification(id, title, body, payload, icon, priority, details.buttons);
+
+    auto& entry = registry->setContent(id, title, body, payload);
+    entry.priority = priority.value_or(NotificationPriority::Normal);
+    registry->setGroup(entry, details.groupKey);
+    // replaces the notification of id which is still waiting for its icon, if any
+    icon_waits->erase(id);
+    if (iconDecoding) {
+      icon_waits->emplace(id, IconWait{ serial, GObjectPtr<GNotification>(G_NOTIFICATION(g_object_ref(notification))), entry.priority });
+      registry->markQueued(id);
+    } else {
+      admit(id, notification, entry.priority);
+    }
+  }
+
+  void admitWithDecodedIcon(std::int64_t id, guint64 serial, GIcon* decoded) {
+    const auto wait = icon_waits->find(id);
+    if (wait == icon_waits->end() || wait->second.serial != serial) {
+      return;
+    }
+    const auto notification = std::move(wait->second.notification);
+    const auto priority = wait->second.priority;
+    icon_waits->erase(wait);
+    g_notification_set_icon(notification.get(), decoded);
+    SetFdoNotificationIcon(notification.get(), decoded);
+    admit(id, notification.get(), priority);
+  }
+
+  // Submits notification to admission_queue. While it is held back, the registry keeps its
+  // content even if it fired for the last time, until it is sent or dropped.
+  void admit(std::int64_t id, GNotification* notification, NotificationPriority priority) {
+    admission_queue->submit(id, notification, priority);
+    if (admission_queue->contains(id)) {
+      registry->markQueued(id);
     }
-    const auto [id, title, body, payload, platformSpecifics] = std::get<1>(commonArgs);
+  }
 
-    g_autoptr(GNotification) notification = buildNotification(id, title, body, payload, platformSpecifics);
+  // Like show, but the notification is only rebuilt and sent if args differ from the
+  // ones last sent for its id, and at most once per coalescing window.
+  FlMethodResponse* update(FlValue* args) {
+    RequireArg(args, FL_VALUE_TYPE_MAP);
 
-    auto notificationIdString = "flutter_local_notifications#" + std::to_string(id);
-    const auto app = G_APPLICATION(getApplication());
-  
-    g_application_send_notification(G_APPLICATION(app), notificationIdString.data(), notification);
-    notifications->emplace_back(id);
+    CommonArguments updateArgs;
+    DecodeArgs(args, CommonArgumentFields, updateArgs);
+    update_coalescer->submit(updateArgs.id, args);
     return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
   }
 
-  FlMethodResponse* periodicallyShow(FlMethodCall* call) {
-    const auto args = fl_method_call_get_args(call);
+  // Called by update_coalescer once an update is to be sent.
+  void sendUpdate(FlValue* args) {
+    CommonArguments updateArgs;
+    // already decoded by update
+    g_autoptr(FlMethodResponse) resp = DecodeArguments("update", args, CommonArgumentFields, updateArgs);
+    if (!resp) {
+      showNotification(updateArgs);
+    }
+  }
+
+  FlMethodResponse* periodicallyShow(FlValue* args) {
     RequireArg(args, FL_VALUE_TYPE_MAP);
 
-    const auto commonArgs = getCommonArguments(args);
-    if (const auto resp = std::get_if<FlMethodResponse*>(&commonArgs)) {
-      return *resp;
-    }
-    const auto [id, title, body, payload, platformSpecifics] = std::get<1>(commonArgs);
+    PeriodicallyShowArguments periodicallyShowArgs;
+    DecodeArgs(args, PeriodicallyShowArgumentFields, periodicallyShowArgs);
+    const auto& [id, title, body, payload, platformSpecifics] = static_cast<const CommonArguments&>(periodicallyShowArgs);
 
-    auto repeatInterval = fl_value_lookup_string(args, "repeatInterval");
-    RequireArg(repeatInterval, FL_VALUE_TYPE_INT);
-    const auto repeatIntervalIndex = fl_value_get_int(repeatInterval);
-    if (repeatIntervalIndex < 0 || repeatIntervalIndex >= std::size(RepeatIntervalMap)) {
+    const auto repeatIntervalIndex = periodicallyShowArgs.repeatInterval;
+    if (repeatIntervalIndex < 0 || repeatIntervalIndex >= static_cast<std::int64_t>(std::size(RepeatIntervalMap))) {
       return FL_METHOD_RESPONSE(fl_method_error_response_new("show_error", "repeatInterval is not in valid range", nullptr));
     }
     const auto repeatIntervalValue = RepeatIntervalMap[repeatIntervalIndex];
 
-    g_autoptr(GNotification) notification = buildNotification(id, title, body, payload, platformSpecifics);
-
-    auto notificationIdString = "flutter_local_notifications#" + std::to_string(id);
-    const auto app = G_APPLICATION(getApplication());
-
-    doPeriodicallyShow(app, id, notification, std::move(notificationIdString), repeatIntervalValue);
+    registry->setContent(id, title, body, payload);
+    doPeriodicallyShow(id, ReadNotificationDetails(platformSpecifics), repeatIntervalValue, args);
     return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
   }
 
-  FlMethodResponse* zonedSchedule(FlMethodCall* call) {
+  FlMethodResponse* zonedSchedule(FlValue* args) {
 #if GLIB_CHECK_VERSION(2, 58, 0)
-    const auto args = fl_method_call_get_args(call);
     RequireArg(args, FL_VALUE_TYPE_MAP);
 
-    const auto commonArgs = getCommonArguments(args);
-    if (const auto resp = std::get_if<FlMethodResponse*>(&commonArgs)) {
-      return *resp;
-    }
-    const auto [id, title, body, payload, platformSpecifics] = std::get<1>(commonArgs);
+    ZonedScheduleArguments zonedScheduleArgs;
+    DecodeArgs(args, ZonedScheduleArgumentFields, zonedScheduleArgs);
+    const auto& [id, title, body, payload, platformSpecifics] = static_cast<const CommonArguments&>(zonedScheduleArgs);
 
-    auto timeZoneName = fl_value_lookup_string(args, "timeZoneName");
-    RequireArg(timeZoneName, FL_VALUE_TYPE_STRING);
-
-    const auto scheduledDateTime = fl_value_lookup_string(args, "scheduledDateTime");
-    RequireArg(scheduledDateTime, FL_VALUE_TYPE_STRING);
-    auto matchDateTimeComponents = fl_value_lookup_string(args, "matchDateTimeComponents");
-    OptionalArg(matchDateTimeComponents, FL_VALUE_TYPE_INT);
-
-    const auto timeZoneNameValue = fl_value_get_string(timeZoneName);
-    const auto scheduledDateTimeValue = fl_value_get_string(scheduledDateTime);
-    g_autoptr(GTimeZone) timeZone = g_time_zone_new(timeZoneNameValue);
-    g_autoptr(GDateTime) realScheduledDateTime = g_date_time_new_from_iso8601(scheduledDateTimeValue, timeZone);
+    const auto timeZone = time_zones->get(zonedScheduleArgs.timeZoneName);
+    g_autoptr(GDateTime) realScheduledDateTime = g_date_time_new_from_iso8601(zonedScheduleArgs.scheduledDateTime, timeZone);
     assert(realScheduledDateTime);
 
-    g_autoptr(GDateTime) now = g_date_time_new_now(timeZone);
-
-    g_autoptr(GNotification) notification = buildNotification(id, title, body, payload, platformSpecifics);
-
-    auto notificationIdString = "flutter_local_notifications#" + std::to_string(id);
-    const auto app = G_APPLICATION(getApplication());
+    g_autoptr(GDateTime) now = NowInTimeZone(*clock, timeZone);
+    std::optional<Recurrence> recurrence;
+    if (const auto resp = decodeRecurrence(zonedScheduleArgs, timeZone, realScheduledDateTime, now, recurrence)) {
+      return resp;
+    }
+    if (recurrence && !recurrence->next(clock->now())) {
+      return FL_METHOD_RESPONSE(fl_method_error_response_new("zonedSchedule_error", "recurrence has no occurrence in the future", nullptr));
+    }
 
-    doZonedSchedule(app, id, notification, std::move(notificationIdString), now, realScheduledDateTime,
-      matchDateTimeComponents ? std::optional{ static_cast<DateTimeComponents>(fl_value_get_int(matchDateTimeComponents)) } : std::nullopt);
+    registry->setContent(id, title, body, payload);
+    doZonedSchedule(id, ReadNotificationDetails(platformSpecifics), now, realScheduledDateTime, recurrence, args);
     return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
 #else
     return FL_METHOD_RESPONSE(fl_method_error_response_new("UnsupportedPlatform", "This feature requires glib 2.58.0, which is not satisfied", nullptr));
 #endif
   }
 
-  FlMethodResponse* cancel(FlMethodCall* call) {
-    const auto args = fl_method_call_get_args(call);
+  FlMethodResponse* cancel(FlValue* args) {
     RequireArg(args, FL_VALUE_TYPE_INT);
-    const auto id = fl_value_get_int(args);
+    cancelNotification(fl_value_get_int(args));
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+  }
 
+  void cancelNotification(std::int64_t id) {
     const auto app = getApplication();
-    const auto iter = periodic_notification_map->find(id);
-    if (iter != periodic_notification_map->end()) {
-      g_source_remove(iter->second);
-      periodic_notification_map->erase(iter);
+    if (scheduler->cancel(id) && schedule_store) {
+      schedule_store->recordCancel(id);
     }
-    g_application_withdraw_notification(G_APPLICATION(app), ("flutter_local_notifications#" + std::to_string(id)).data());
-    return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+    // also closes the notification if the helper sent it
+    if (scheduler_helper) {
+      scheduler_helper->cancel(id);
+    }
+    admission_queue->remove(id);
+    icon_waits->erase(id);
+    update_coalescer->remove(id);
+    registry->withdraw(id);
+    active_set->remove(id);
+    eviction_summaries->reset(id);
+    if (fdo_backend) {
+      fdo_backend->close(id);
+    }
+    g_application_withdraw_notification(G_APPLICATION(app), NotificationIdString(id).data());
   }
 
   FlMethodResponse* cancelAll() {
     const auto app = getApplication();
-    for (const auto id : *notifications) {
-      g_application_withdraw_notification(G_APPLICATION(app), ("flutter_local_notifications#" + std::to_string(id)).data());
+    std::vector<std::int64_t> cancelledNotifications(registry->shownIds().begin(), registry->shownIds().end());
+    for (const auto id : registry->pendingIds()) {
+      if (!registry->shownIds().contains(id)) {
+        cancelledNotifications.emplace_back(id);
+      }
+    }
+    for (const auto id : cancelledNotifications) {
+      if (fdo_backend) {
+        fdo_backend->close(id);
+      }
+      g_application_withdraw_notification(G_APPLICATION(app), NotificationIdString(id).data());
     }
-    auto cancelledNotifications = *notifications;
-    notifications->clear();
-    for (const auto [id, taskId] : *periodic_notification_map) {
-      g_source_remove(taskId);
-      g_application_withdraw_notification(G_APPLICATION(app), ("flutter_local_notifications#" + std::to_string(id)).data());
-      cancelledNotifications.emplace_back(id);
+    scheduler->cancelAll();
+    admission_queue->clear();
+    icon_waits->clear();
+    update_coalescer->clear();
+    registry->clear();
+    active_set->clear();
+    eviction_summaries->clear();
+    if (schedule_store) {
+      schedule_store->recordCancelAll();
+    }
+    if (scheduler_helper) {
+      scheduler_helper->cancelAll();
     }
-    periodic_notification_map->clear();
     g_autoptr(FlValue) returnedValue = fl_value_new_int64_list(cancelledNotifications.data(), cancelledNotifications.size());
     return FL_METHOD_RESPONSE(fl_method_success_response_new(returnedValue));
   }
+
+  FlMethodResponse* pendingNotificationRequests() {
+    g_autoptr(FlValue) result = fl_value_new_list();
+    for (const auto id : registry->pendingIds()) {
+      const auto entry = registry->find(id);
+      const auto request = fl_value_new_map();
+      fl_value_set_string_take(request, "id", fl_value_new_int(id));
+      fl_value_set_string_take(request, "title", fl_value_new_string(registry->strings().get(entry->title).data()));
+      fl_value_set_string_take(request, "body", fl_value_new_string(registry->strings().get(entry->body).data()));
+      fl_value_set_string_take(request, "payload", fl_value_new_string(registry->strings().get(entry->payload).data()));
+      fl_value_append_take(result, request);
+    }
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  }
+
+  FlMethodResponse* getAdmissionStats() {
+    const auto& stats = admission_queue->getStats();
+    g_autoptr(FlValue) result = fl_value_new_map();
+    fl_value_set_string_take(result, "queued", fl_value_new_int(admission_queue->depth()));
+    fl_value_set_string_take(result, "sent", fl_value_new_int(stats.sent));
+    fl_value_set_string_take(result, "deferred", fl_value_new_int(stats.deferred));
+    fl_value_set_string_take(result, "dropped", fl_value_new_int(stats.dropped));
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  }
+
+  Scheduler* createScheduler(bool manual) {
+    return new Scheduler([this](std::int64_t id, gint64 deadline) {
+      return fireScheduledNotification(id, deadline);
+    }, [this](std::int64_t id, gint64 deadline, gint64 now) {
+      return reanchorScheduledNotification(id, deadline, now);
+    }, *clock, manual);
+  }
+
+  // Switches to virtual time starting at startTime, pending notifications are kept.
+  // Nothing is sent to the notification server or persisted afterwards, and notifications
+  // are not rate limited.
+  FlMethodResponse* enableSimulation(FlValue* args) {
+    RequireArg(args, FL_VALUE_TYPE_MAP);
+    SimulationArguments simulationArgs;
+    DecodeArgs(args, SimulationArgumentFields, simulationArgs);
+
+    const auto oldSimulation = simulation;
+    const auto oldScheduler = scheduler;
+    simulation = new Simulation(simulationArgs.startTime);
+    clock = &simulation->getClock();
+    scheduler = createScheduler(true);
+    for (const auto id : registry->pendingIds()) {
+      if (const auto deadline = oldScheduler->deadlineOf(id)) {
+        scheduler->schedule(id, *deadline);
+      }
+    }
+    delete oldScheduler;
+    delete oldSimulation;
+
+    delete std::exchange(schedule_store, nullptr);
+    auto config = DefaultAdmissionConfig;
+    config.rate = 0;
+    admission_queue->configure(config);
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+  }
+
+  FlMethodResponse* advanceSimulation(FlValue* args) {
+    if (!simulation) {
+      return FL_METHOD_RESPONSE(fl_method_error_response_new("simulation_error", "Simulation is not enabled", nullptr));
+    }
+    RequireArg(args, FL_VALUE_TYPE_MAP);
+    AdvanceSimulationArguments advanceArgs;
+    DecodeArgs(args, AdvanceSimulationArgumentFields, advanceArgs);
+
+    const auto fired = simulation->advance(*scheduler, advanceArgs.until);
+    g_autoptr(FlValue) result = fl_value_new_map();
+    fl_value_set_string_take(result, "fired", fl_value_new_int(fired));
+    fl_value_set_string_take(result, "sent", fl_value_new_int(simulation->getSent()));
+    fl_value_set_string_take(result, "now", fl_value_new_int(clock->now()));
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  }
+
+  // Jumps virtual time to until, then handles the notifications which became due like after
+  // a resume from suspend, so that misfire policies can be checked.
+  FlMethodResponse* suspendSimulation(FlValue* args) {
+    if (!simulation) {
+      return FL_METHOD_RESPONSE(fl_method_error_response_new("simulation_error", "Simulation is not enabled", nullptr));
+    }
+    RequireArg(args, FL_VALUE_TYPE_MAP);
+    AdvanceSimulationArguments suspendArgs;
+    DecodeArgs(args, AdvanceSimulationArgumentFields, suspendArgs);
+
+    const auto firesBefore = simulation->recordedFires();
+    simulation->suspend(suspendArgs.until);
+    onResume();
+    g_autoptr(FlValue) result = fl_value_new_map();
+    fl_value_set_string_take(result, "fired", fl_value_new_int(simulation->recordedFires() - firesBefore));
+    fl_value_set_string_take(result, "sent", fl_value_new_int(simulation->getSent()));
+    fl_value_set_string_take(result, "now", fl_value_new_int(clock->now()));
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  }
+
+  // Changes the system time zone of the simulation to timeZoneName, which schedules in
+  // the previous one follow. Responds with the number of schedules moved.
+  FlMethodResponse* changeSimulatedTimeZone(FlValue* args) {
+    if (!simulation) {
+      return FL_METHOD_RESPONSE(fl_method_error_response_new("simulation_error", "Simulation is not enabled", nullptr));
+    }
+    RequireArg(args, FL_VALUE_TYPE_MAP);
+    SimulatedTimeZoneArguments timeZoneArgs;
+    DecodeArgs(args, SimulatedTimeZoneArgumentFields, timeZoneArgs);
+
+    std::size_t moved = 0;
+    if (!system_time_zone) {
+      system_time_zone = g_strdup(timeZoneArgs.timeZoneName);
+    } else {
+      moved = onSystemTimeZoneChanged(timeZoneArgs.timeZoneName);
+    }
+    g_autoptr(FlValue) result = fl_value_new_map();
+    fl_value_set_string_take(result, "moved", fl_value_new_int(moved));
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  }
+
+  // Responds with the trace events recorded so far in the JSON format of Chrome's trace
+  // viewer, or writes them to path if one is given.
+  FlMethodResponse* dumpTrace(FlValue* args) {
+    if (!trace) {
+      return FL_METHOD_RESPONSE(fl_method_error_response_new("trace_error", "Tracing is not enabled", nullptr));
+    }
+    OptionalArg(args, FL_VALUE_TYPE_MAP);
+    DumpTraceArguments dumpArgs;
+    if (args) {
+      DecodeArgs(args, DumpTraceArgumentFields, dumpArgs);
+    }
+
+    const auto json = trace->toChromeTraceJson();
+    if (!dumpArgs.path) {
+      g_autoptr(FlValue) result = fl_value_new_string_sized(json.data(), json.size());
+      return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+    }
+    g_autoptr(GError) error = nullptr;
+    if (!g_file_set_contents(dumpArgs.path, json.data(), json.size(), &error)) {
+      return FL_METHOD_RESPONSE(fl_method_error_response_new("trace_error", error->message, nullptr));
+    }
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+  }
+
+  // Responds with the fires recorded since the last call, as id, intended and actual time
+  // triples flattened into one list.
+  FlMethodResponse* takeSimulatedFires() {
+    if (!simulation) {
+      return FL_METHOD_RESPONSE(fl_method_error_response_new("simulation_error", "Simulation is not enabled", nullptr));
+    }
+    const auto fires = simulation->takeFires();
+    std::vector<std::int64_t> values;
+    values.reserve(fires.size() * 3);
+    for (const auto& fire : fires) {
+      values.insert(values.end(), { fire.id, fire.intended, fire.actual });
+    }
+    g_autoptr(FlValue) result = fl_value_new_int64_list(values.data(), values.size());
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  }
+
+  FlMethodResponse* getStats() {
+    std::int64_t repeatingCount = 0;
+    for (const auto id : registry->pendingIds()) {
+      if (registry->stateOf(id) == NotificationRegistry::State::Repeating) {
+        ++repeatingCount;
+      }
+    }
+    g_autoptr(FlValue) gauges = fl_value_new_map();
+    fl_value_set_string_take(gauges, "active", fl_value_new_int(registry->shownIds().size()));
+    fl_value_set_string_take(gauges, "scheduled", fl_value_new_int(scheduler->size()));
+    fl_value_set_string_take(gauges, "repeating", fl_value_new_int(repeatingCount));
+    fl_value_set_string_take(gauges, "queued", fl_value_new_int(admission_queue->depth()));
+    fl_value_set_string_take(gauges, "inFlight", fl_value_new_int(fdo_backend ? fdo_backend->inFlight() : 0));
+
+    g_autoptr(FlValue) result = fl_value_new_map();
+    fl_value_set_string_take(result, "enabled", fl_value_new_bool(Metrics::Enabled));
+    fl_value_set_string(result, "gauges", gauges);
+    fl_value_set_string_take(result, "dropped", fl_value_new_int(admission_queue->getStats().dropped));
+#ifdef FLUTTER_LOCAL_NOTIFICATIONS_ENABLE_METRICS
+    g_autoptr(FlValue) methods = fl_value_new_map();
+    for (const auto& [method, histogram] : metrics->getMethods()) {
+      fl_value_set_string_take(methods, method.data(), HistogramToFlValue(histogram, "ns"));
+    }
+    fl_value_set_string(result, "methods", methods);
+    fl_value_set_string_take(result, "send", HistogramToFlValue(metrics->getSend(), "ns"));
+    fl_value_set_string_take(result, "fireLateness", HistogramToFlValue(metrics->getFireLateness(), "us"));
+#endif
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  }
+
+  FlMethodResponse* getActiveNotifications() {
+    g_autoptr(FlValue) result = fl_value_new_list();
+    for (const auto id : registry->shownIds()) {
+      const auto entry = registry->find(id);
+      const auto notification = fl_value_new_map();
+      fl_value_set_string_take(notification, "id", fl_value_new_int(id));
+      fl_value_set_string_take(notification, "title", fl_value_new_string(registry->strings().get(entry->title).data()));
+      fl_value_set_string_take(notification, "body", fl_value_new_string(registry->strings().get(entry->body).data()));
+      fl_value_set_string_take(notification, "payload", fl_value_new_string(registry->strings().get(entry->payload).data()));
+      fl_value_append_take(result, notification);
+    }
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  }
+
+  // Applies operation to every element of args, which must be a list, and responds with
+  // the results of all elements at once, see BatchItemResult.
+  // Icons of all elements are decoded in parallel before the first one is built.
+  template <typename Operation>
+  FlMethodResponse* batch(FlValue* args, Operation&& operation) {
+    RequireArg(args, FL_VALUE_TYPE_LIST);
+    g_autoptr(FlValue) results = fl_value_new_list();
+    const auto size = fl_value_get_length(args);
+    for (std::size_t i = 0; i < size; ++i) {
+      PrewarmIconOfArguments(*icon_cache, fl_value_get_list_value(args, i));
+    }
+    for (std::size_t i = 0; i < size; ++i) {
+      g_autoptr(FlMethodResponse) response = operation(fl_value_get_list_value(args, i));
+      fl_value_append_take(results, BatchItemResult(response));
+    }
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(results));
+  }
+
+  // Handles a message of the binary channel, see BinaryMessage. Shows and cancels are
+  // applied directly from the message, while schedules go through their method call as
+  // they are persisted as arguments anyway.
+  FlMethodResponse* handleBinaryMessage(const guint8* data, std::size_t size) {
+    BinaryMessage message = {};
+    if (!ReadBinaryMessage(data, size, message)) {
+      return FL_METHOD_RESPONSE(fl_method_error_response_new("binary_error", "message is malformed", nullptr));
+    }
+    const TraceScope traceScope(trace, BinaryOperationName(message.operation), message.id);
+    switch (message.operation) {
+    case BinaryOperation::Show:
+      update_coalescer->remove(message.id);
+      showNotification(message.id, message.title ? message.title : "", message.body, message.payload, message.details);
+      break;
+    case BinaryOperation::Cancel:
+      cancelNotification(message.id);
+      break;
+    case BinaryOperation::PeriodicallyShow:
+    {
+      g_autoptr(FlValue) args = flutter_local_notifications::BinaryMessageToArguments(message);
+      return periodicallyShow(args);
+    }
+    case BinaryOperation::ZonedSchedule:
+    {
+      g_autoptr(FlValue) args = flutter_local_notifications::BinaryMessageToArguments(message);
+      return zonedSchedule(args);
+    }
+    }
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+  }
+
+  // Runs a call of the native API, shows and cancels are applied directly like the ones of
+  // the binary channel.
+  void runNativeCall(const NativeCall& call) {
+    const Stopwatch stopwatch;
+    const TraceScope traceScope(trace, "native", call.id);
+    const auto title = call.title ? call.title->data() : nullptr;
+    const auto body = call.body ? call.body->data() : nullptr;
+    g_autoptr(FlMethodResponse) response = nullptr;
+    if (call.operation == NativeCall::Operation::Cancel) {
+      cancelNotification(call.id);
+    } else if (call.operation == NativeCall::Operation::Show
+        || (call.operation == NativeCall::Operation::Schedule && call.fireTime <= clock->now())) {
+      update_coalescer->remove(call.id);
+      showNotification(call.id, title ? title : "", body, call.payload.data(), NotificationDetailsView{});
+    } else {
+      g_autoptr(FlValue) args = fl_value_new_map();
+      fl_value_set_string_take(args, "id", fl_value_new_int(call.id));
+      fl_value_set_string_take(args, "title", title ? fl_value_new_string(title) : fl_value_new_null());
+      fl_value_set_string_take(args, "body", body ? fl_value_new_string(body) : fl_value_new_null());
+      fl_value_set_string_take(args, "payload", fl_value_new_string(call.payload.data()));
+      if (call.operation == NativeCall::Operation::Update) {
+        response = update(args);
+      } else {
+        // rounded up, so that it stays after now
+        g_autoptr(GDateTime) fireTime = g_date_time_new_from_unix_utc((call.fireTime + G_USEC_PER_SEC - 1) / G_USEC_PER_SEC);
+        g_autofree gchar* scheduledDateTime = g_date_time_format(fireTime, "%Y-%m-%dT%H:%M:%S");
+        fl_value_set_string_take(args, "timeZoneName", fl_value_new_string("UTC"));
+        fl_value_set_string_take(args, "scheduledDateTime", fl_value_new_string(scheduledDateTime));
+        response = zonedSchedule(args);
+      }
+    }
+    if (response && FL_IS_METHOD_ERROR_RESPONSE(response)) {
+      g_warning("Native call for notification %" G_GINT64_FORMAT " failed: %s", call.id,
+        fl_method_error_response_get_message(FL_METHOD_ERROR_RESPONSE(response)));
+    }
+    metrics->recordMethod("native", stopwatch);
+  }
 };
 
+namespace {
+  // Runs the calls of the native API, the plugin registered last. Only accessed on the
+  // main context.
+  FlutterLocalNotificationsPlugin* native_plugin = nullptr;
+
+  NativeCallQueue& NativeCalls() {
+    // never destroyed, as other threads may still call while the process exits
+    static const auto queue = new NativeCallQueue([](NativeCall& call) {
+      if (!native_plugin) {
+        g_warning("Dropping native call for notification %" G_GINT64_FORMAT ", no plugin is registered", call.id);
+        return;
+      }
+      native_plugin->runNativeCall(call);
+    });
+    return *queue;
+  }
+
+  void PushNativeCall(NativeCall::Operation operation, gint32 id, const gchar* title, const gchar* body, const gchar* payload,
+    gint64 fireTime = 0) {
+    const auto call = new NativeCall();
+    call->operation = operation;
+    call->id = id;
+    if (title) {
+      call->title.emplace(title);
+    }
+    if (body) {
+      call->body.emplace(body);
+    }
+    call->payload = payload ? payload : "";
+    call->fireTime = fireTime;
+    NativeCalls().push(call);
+  }
+}
+
 G_DEFINE_TYPE(FlutterLocalNotificationsPlugin, flutter_local_notifications_plugin, g_object_get_type())
 
 static void flutter_local_notifications_plugin_dispose(GObject* object) {
   const auto plugin = FLUTTER_LOCAL_NOTIFICATIONS_PLUGIN(object);
+  if (native_plugin == plugin) {
+    native_plugin = nullptr;
+  }
+  // the actions refer to the plugin
+  if (plugin->actions_registered) {
+    if (const auto app = plugin->getApplication()) {
+      g_action_map_remove_action(G_ACTION_MAP(app), NotificationActionName);
+      g_action_map_remove_action(G_ACTION_MAP(app), NotificationButtonActionName);
+    }
+    plugin->actions_registered = false;
+  }
   if (plugin->default_icon) {
     g_object_unref(plugin->default_icon);
   }
-  g_object_unref(plugin->channel);
-  g_object_unref(plugin->registrar);
-  delete plugin->notifications;
-  delete plugin->periodic_notification_map;
+  g_clear_object(&plugin->channel);
+  g_clear_object(&plugin->binary_channel);
+  g_clear_object(&plugin->registrar);
+  g_clear_object(&plugin->application);
+  delete plugin->schedule_store;
+  delete plugin->scheduler;
+  delete plugin->simulation;
+  delete plugin->system_clock;
+  delete plugin->icon_cache;
+  delete plugin->icon_decoder;
+  delete plugin->icon_waits;
+  delete plugin->fdo_backend;
+  delete plugin->scheduler_helper;
+  delete plugin->sleep_monitor;
+  delete plugin->time_zone_monitor;
+  delete plugin->trace;
+  g_clear_pointer(&plugin->system_time_zone, g_free);
+  delete plugin->misfires;
+  delete plugin->active_set;
+  delete plugin->eviction_summaries;
+  delete plugin->update_coalescer;
+  delete plugin->selections;
+  delete plugin->admission_queue;
+  delete plugin->registry;
+  delete plugin->time_zones;
+  delete plugin->metrics;
 
   G_OBJECT_CLASS(flutter_local_notifications_plugin_parent_class)->dispose(object);
 }
@@ -500,34 +1871,136 @@ static void flutter_local_notifications_plugin_class_init(FlutterLocalNotificati
 static void flutter_local_notifications_plugin_init(FlutterLocalNotificationsPlugin* self) {
   self->registrar = nullptr;
   self->channel = nullptr;
+  self->binary_channel = nullptr;
+  self->application = nullptr;
   self->default_icon = nullptr;
-  self->notifications = new std::vector<int64_t>();
-  self->periodic_notification_map = new std::unordered_map<int64_t, int>();
+  self->icon_decoder = new IconDecoder(DefaultIconSize);
+  self->icon_cache = new IconCache(IconCacheCapacity, *self->icon_decoder);
+  self->icon_waits = new std::unordered_map<std::int64_t, IconWait>();
+  self->icon_wait_serial = 0;
+  self->metrics = new Metrics();
+  self->time_zones = new TimeZoneCache();
+  self->registry = new NotificationRegistry();
+  self->admission_queue = new AdmissionQueue([self](std::int64_t id, GNotification* notification) {
+    self->sendNotification(id, notification);
+  }, [self](std::int64_t id) {
+    self->registry->markDropped(id);
+  }, DefaultAdmissionConfig);
+  self->update_coalescer = new UpdateCoalescer([self](std::int64_t id, FlValue* args) {
+    self->sendUpdate(args);
+  }, DefaultUpdateCoalescingWindow);
+  self->selections = new SelectionBuffer(SelectionBufferCapacity, [self](FlValue* batch) {
+    self->selectNotifications(batch);
+  });
+  self->actions_registered = false;
+  self->schedule_store = nullptr;
+  self->fdo_backend = nullptr;
+  self->scheduler_helper = nullptr;
+  self->misfire_threshold = DefaultMisfireThreshold;
+  self->misfires = new MisfireCoalescer({ DefaultMisfireSummaryId, DefaultMisfireSummaryTitle },
+    [self](const MisfireCoalescer::Summary& summary, const std::string& body) {
+      self->sendMisfireSummary(summary, body);
+    });
+  self->sleep_monitor = nullptr;
+  self->time_zone_monitor = nullptr;
+  self->system_time_zone = nullptr;
+  self->active_set = new ActiveSet();
+  self->eviction_policy = EvictionPolicy::Withdraw;
+  self->eviction_summaries = new EvictionSummaries(DefaultEvictionSummaryBaseId, DefaultEvictionSummaryTitle);
+  self->trace = nullptr;
+  self->system_clock = new SystemClock();
+  self->clock = self->system_clock;
+  self->simulation = nullptr;
+  self->scheduler = self->createScheduler(false);
+}
+
+FlMethodResponse* flutter_local_notifications_plugin_handle_method(
+  FlutterLocalNotificationsPlugin* self,
+  const gchar* methodName,
+  FlValue* args) {
+  const Stopwatch stopwatch;
+  FlMethodResponse* response = nullptr;
+
+  const std::string_view method = methodName;
+  // the buffer created by initialize records from the next call on
+  const TraceScope traceScope(self->trace, method, NotificationIdOf(args));
+  if (method == "initialize") {
+    response = self->initialize(args);
+  } else if (method == "show") {
+    response = self->show(args);
+  } else if (method == "update") {
+    response = self->update(args);
+  } else if (method == "periodicallyShow") {
+    response = self->periodicallyShow(args);
+  } else if (method == "zonedSchedule") {
+    response = self->zonedSchedule(args);
+  } else if (method == "cancel") {
+    response = self->cancel(args);
+  } else if (method == "cancelAll") {
+    response = self->cancelAll();
+  } else if (method == "pendingNotificationRequests") {
+    response = self->pendingNotificationRequests();
+  } else if (method == "getActiveNotifications") {
+    response = self->getActiveNotifications();
+  } else if (method == "getAdmissionStats") {
+    response = self->getAdmissionStats();
+  } else if (method == "getStats") {
+    response = self->getStats();
+  } else if (method == "enableSimulation") {
+    response = self->enableSimulation(args);
+  } else if (method == "advanceSimulation") {
+    response = self->advanceSimulation(args);
+  } else if (method == "suspendSimulation") {
+    response = self->suspendSimulation(args);
+  } else if (method == "changeSimulatedTimeZone") {
+    response = self->changeSimulatedTimeZone(args);
+  } else if (method == "dumpTrace") {
+    response = self->dumpTrace(args);
+  } else if (method == "takeSimulatedFires") {
+    response = self->takeSimulatedFires();
+  } else if (method == "showBatch") {
+    response = self->batch(args, [self](FlValue* item) { return self->show(item); });
+  } else if (method == "zonedScheduleBatch") {
+    response = self->batch(args, [self](FlValue* item) { return self->zonedSchedule(item); });
+  } else if (method == "cancelBatch") {
+    response = self->batch(args, [self](FlValue* item) { return self->cancel(item); });
+  } else {
+    response = FL_METHOD_RESPONSE(fl_method_not_implemented_response_new());
+  }
+
+  self->metrics->recordMethod(method, stopwatch);
+  return response;
+}
+
+FlValue* flutter_local_notifications_plugin_handle_binary_message(
+  FlutterLocalNotificationsPlugin* self,
+  FlValue* message) {
+  const Stopwatch stopwatch;
+  g_autoptr(FlMethodResponse) response = nullptr;
+  if (message && fl_value_get_type(message) == FL_VALUE_TYPE_UINT8_LIST) {
+    response = self->handleBinaryMessage(fl_value_get_uint8_list(message), fl_value_get_length(message));
+  } else {
+    response = FL_METHOD_RESPONSE(fl_method_error_response_new("binary_error", "message is not binary", nullptr));
+  }
+  self->metrics->recordMethod("binary", stopwatch);
+  return flutter_local_notifications::BinaryReply(response);
+}
+
+FlutterLocalNotificationsPlugin* flutter_local_notifications_plugin_new_headless(GApplication* application) {
+  const auto plugin = FLUTTER_LOCAL_NOTIFICATIONS_PLUGIN(
+      g_object_new(flutter_local_notifications_plugin_get_type(), nullptr));
+  plugin->application = G_APPLICATION(g_object_ref(application));
+  plugin->registerActions();
+  native_plugin = plugin;
+  return plugin;
 }
 
 namespace {
   void flutter_local_notifications_plugin_handle_method_call(
     FlutterLocalNotificationsPlugin* self,
     FlMethodCall* call) {
-    g_autoptr(FlMethodResponse) response = nullptr;
-
-    const std::string_view method = fl_method_call_get_name(call);
-    if (method == "initialize") {
-      response = self->initialize(call);
-    } else if (method == "show") {
-      response = self->show(call);
-    } else if (method == "periodicallyShow") {
-      response = self->periodicallyShow(call);
-    } else if (method == "zonedSchedule") {
-      response = self->zonedSchedule(call);
-    } else if (method == "cancel") {
-      response = self->cancel(call);
-    } else if (method == "cancelAll") {
-      response = self->cancelAll();
-    } else {
-      response = FL_METHOD_RESPONSE(fl_method_not_implemented_response_new());
-    }
-
+    g_autoptr(FlMethodResponse) response = flutter_local_notifications_plugin_handle_method(
+      self, fl_method_call_get_name(call), fl_method_call_get_args(call));
     fl_method_call_respond(call, response, nullptr);
   }
 
@@ -536,6 +2009,16 @@ namespace {
     FlutterLocalNotificationsPlugin* plugin = FLUTTER_LOCAL_NOTIFICATIONS_PLUGIN(user_data);
     flutter_local_notifications_plugin_handle_method_call(plugin, method_call);
   }
+
+  void binary_message_cb(FlBasicMessageChannel* channel, FlValue* message,
+                         FlBasicMessageChannelResponseHandle* response_handle, gpointer user_data) {
+    FlutterLocalNotificationsPlugin* plugin = FLUTTER_LOCAL_NOTIFICATIONS_PLUGIN(user_data);
+    g_autoptr(FlValue) reply = flutter_local_notifications_plugin_handle_binary_message(plugin, message);
+    g_autoptr(GError) error = nullptr;
+    if (!fl_basic_message_channel_respond(channel, response_handle, reply, &error)) {
+      g_warning("Failed to respond to binary message: %s", error->message);
+    }
+  }
 }
 
 void flutter_local_notifications_plugin_register_with_registrar(FlPluginRegistrar* registrar) {
@@ -554,5 +2037,32 @@ void flutter_local_notifications_plugin_register_with_registrar(FlPluginRegistra
                                             g_object_ref(plugin),
                                             g_object_unref);
 
+  g_autoptr(FlBinaryCodec) binaryCodec = fl_binary_codec_new();
+  plugin->binary_channel =
+      fl_basic_message_channel_new(fl_plugin_registrar_get_messenger(registrar),
+                                   "dexterous.com/flutter/local_notifications/binary",
+                                   FL_MESSAGE_CODEC(binaryCodec));
+  fl_basic_message_channel_set_message_handler(plugin->binary_channel, binary_message_cb,
+                                               g_object_ref(plugin),
+                                               g_object_unref);
+  plugin->registerActions();
+  native_plugin = plugin;
+
   g_object_unref(plugin);
 }
+
+void flutter_local_notifications_show(gint32 id, const gchar* title, const gchar* body, const gchar* payload) {
+  PushNativeCall(NativeCall::Operation::Show, id, title, body, payload);
+}
+
+void flutter_local_notifications_update(gint32 id, const gchar* title, const gchar* body, const gchar* payload) {
+  PushNativeCall(NativeCall::Operation::Update, id, title, body, payload);
+}
+
+void flutter_local_notifications_schedule(gint32 id, const gchar* title, const gchar* body, const gchar* payload, gint64 fire_time) {
+  PushNativeCall(NativeCall::Operation::Schedule, id, title, body, payload, fire_time);
+}
+
+void flutter_local_notifications_cancel(gint32 id) {
+  PushNativeCall(NativeCall::Operation::Cancel, id, nullptr, nullptr, nullptr);
+}
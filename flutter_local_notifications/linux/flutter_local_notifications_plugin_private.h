@@ -0,0 +1,30 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_PLUGIN_PRIVATE_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_PLUGIN_PRIVATE_H_
+
+#include <flutter_linux/flutter_linux.h>
+#include <gio/gio.h>
+
+#include "include/flutter_local_notifications/flutter_local_notifications_plugin.h"
+
+G_BEGIN_DECLS
+
+// Creates a plugin which is not registered with a Flutter engine, notifications are
+// sent through application. Used to drive the plugin without a view, e.g. by benchmarks.
+FlutterLocalNotificationsPlugin* flutter_local_notifications_plugin_new_headless(GApplication* application);
+
+// Handles the method call of method with args, and returns its response which is sent back
+// to Dart when the call comes from the method channel.
+FlMethodResponse* flutter_local_notifications_plugin_handle_method(
+  FlutterLocalNotificationsPlugin* self,
+  const gchar* method,
+  FlValue* args);
+
+// Handles a message of the binary channel, which is a uint8 list, and returns the reply
+// which is sent back to Dart when the message comes from the binary channel.
+FlValue* flutter_local_notifications_plugin_handle_binary_message(
+  FlutterLocalNotificationsPlugin* self,
+  FlValue* message);
+
+G_END_DECLS
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_PLUGIN_PRIVATE_H_
@@ -0,0 +1,19 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_GOBJECT_PTR_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_GOBJECT_PTR_H_
+
+#include <glib-object.h>
+#include <memory>
+
+namespace flutter_local_notifications {
+  struct GObjectDeleter {
+    void operator()(gpointer p) const {
+      g_object_unref(p);
+    }
+  };
+
+  // Owns a reference of a GObject.
+  template <typename T>
+  using GObjectPtr = std::unique_ptr<T, GObjectDeleter>;
+}
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_GOBJECT_PTR_H_
@@ -0,0 +1,361 @@
+// Fires the scheduled notifications of an application while it is not running, see
+// scheduler_helper_protocol.h. Started by the plugin, exits once nothing is left to fire or
+// to hand over. Only depends on GIO, so that it stays small while it waits.
+//
+// Usage: flutter_local_notifications_scheduler BUS_NAME APP_NAME DESKTOP_ENTRY
+#include <gio/gio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../clock.h"
+#include "../fdo_backend.h"
+#include "../local_time.h"
+#include "../scheduler.h"
+#include "../scheduler_helper_protocol.h"
+
+namespace {
+  using flutter_local_notifications::FdoNotificationBackend;
+  using flutter_local_notifications::HelperSchedule;
+  using flutter_local_notifications::HelperScheduleFromVariant;
+  using flutter_local_notifications::NextPeriodicDeadline;
+  using flutter_local_notifications::ReanchorPeriodicDeadline;
+  using flutter_local_notifications::RecordHelperFired;
+  using flutter_local_notifications::Scheduler;
+  using flutter_local_notifications::SchedulerHelperIntrospectionXml;
+  using flutter_local_notifications::SchedulerHelperInterface;
+  using flutter_local_notifications::SchedulerHelperObjectPath;
+  using flutter_local_notifications::SystemClock;
+  using flutter_local_notifications::TimeZoneCache;
+
+  // selections kept until the application attaches again
+  inline constexpr std::size_t MaxPendingSelections = 64;
+
+  // time given to the plugin which started the helper to attach, in milliseconds
+  inline constexpr guint AttachGracePeriod = 30 * 1000;
+
+  class SchedulerHelper {
+  public:
+    SchedulerHelper(GMainLoop* loop, std::string busName, std::string appName, std::string desktopEntry)
+      : loop(loop), bus_name(std::move(busName)),
+        scheduler([this](std::int64_t id, gint64 deadline) {
+          return fire(id, deadline);
+        }, [this](std::int64_t id, gint64 deadline, gint64 now) {
+          return reanchor(id, deadline, now);
+        }, clock),
+        backend(std::move(appName), std::move(desktopEntry), [this](std::int64_t id, const std::string& payload, gint32 button) {
+          select(id, payload, button);
+        }, [this](std::int64_t id, guint32 reason) {
+          shown.erase(id);
+          quitIfIdle();
+        }) {
+      grace_source_id = g_timeout_add(AttachGracePeriod, [](gpointer data) -> gboolean {
+        const auto self = static_cast<SchedulerHelper*>(data);
+        self->grace_source_id = 0;
+        self->quitIfIdle();
+        return G_SOURCE_REMOVE;
+      }, this);
+    }
+
+    ~SchedulerHelper() {
+      if (grace_source_id) {
+        g_source_remove(grace_source_id);
+      }
+      if (attached_watch) {
+        g_bus_unwatch_name(attached_watch);
+      }
+    }
+
+    SchedulerHelper(const SchedulerHelper&) = delete;
+    SchedulerHelper& operator=(const SchedulerHelper&) = delete;
+
+    void quit() {
+      g_main_loop_quit(loop);
+    }
+
+    bool registerObject(GDBusConnection* busConnection) {
+      connection = busConnection;
+      g_autoptr(GError) error = nullptr;
+      g_autoptr(GDBusNodeInfo) nodeInfo = g_dbus_node_info_new_for_xml(SchedulerHelperIntrospectionXml, &error);
+      if (nodeInfo) {
+        static const GDBusInterfaceVTable vtable = {
+          [](GDBusConnection* connection, const gchar* sender, const gchar* path, const gchar* interface,
+            const gchar* method, GVariant* parameters, GDBusMethodInvocation* invocation, gpointer data) {
+            static_cast<SchedulerHelper*>(data)->handleMethod(sender, method, parameters, invocation);
+          },
+        };
+        g_dbus_connection_register_object(connection, SchedulerHelperObjectPath,
+          g_dbus_node_info_lookup_interface(nodeInfo, SchedulerHelperInterface), &vtable, this, nullptr, &error);
+      }
+      if (error) {
+        g_warning("Failed to export the scheduler: %s", error->message);
+        return false;
+      }
+      return true;
+    }
+
+  private:
+    struct PendingSelection {
+      std::int64_t id;
+      std::string payload;
+      gint32 button;
+    };
+
+    GMainLoop* loop;
+    const std::string bus_name;
+    SystemClock clock;
+    TimeZoneCache time_zones;
+    std::unordered_map<std::int64_t, HelperSchedule> schedules;
+    // only holds the schedules while no plugin is attached
+    Scheduler scheduler;
+    FdoNotificationBackend backend;
+    GDBusConnection* connection = nullptr;
+
+    // unique name of the connection of the plugin attached last, empty once it is gone
+    std::string attached;
+    guint attached_watch = 0;
+    // executable of the application, launched when a notification is selected
+    std::string executable;
+    bool launched = false;
+
+    std::deque<PendingSelection> selections;
+    // notifications sent by the helper which have not been closed yet
+    std::unordered_set<std::int64_t> shown;
+    guint grace_source_id = 0;
+
+    void handleMethod(const gchar* sender, std::string_view method, GVariant* parameters, GDBusMethodInvocation* invocation) {
+      if (method == "Attach") {
+        authenticate(sender, invocation);
+        return;
+      }
+      if (attached != sender) {
+        g_dbus_method_invocation_return_error_literal(invocation, G_DBUS_ERROR, G_DBUS_ERROR_ACCESS_DENIED,
+          "only the attached application may change schedules");
+        return;
+      }
+      if (method == "Schedule") {
+        HelperSchedule schedule = {};
+        if (!HelperScheduleFromVariant(parameters, time_zones, schedule)) {
+          g_dbus_method_invocation_return_error_literal(invocation, G_DBUS_ERROR, G_DBUS_ERROR_INVALID_ARGS, "malformed schedule");
+          return;
+        }
+        const auto id = schedule.id;
+        schedules.insert_or_assign(id, std::move(schedule));
+        if (attached.empty()) {
+          armSchedule(id, clock.now());
+        }
+      } else if (method == "Cancel") {
+        std::int64_t id;
+        g_variant_get(parameters, "(x)", &id);
+        schedules.erase(id);
+        scheduler.cancel(id);
+        if (shown.erase(id)) {
+          backend.close(id);
+        }
+      } else if (method == "CancelAll") {
+        schedules.clear();
+        scheduler.cancelAll();
+        for (const auto id : shown) {
+          backend.close(id);
+        }
+        shown.clear();
+      }
+      g_dbus_method_invocation_return_value(invocation, nullptr);
+      quitIfIdle();
+    }
+
+    // Asks the bus for the credentials of sender, as the helper launches whatever executable
+    // attached and must not be told which one by the caller.
+    void authenticate(const gchar* sender, GDBusMethodInvocation* invocation) {
+      g_dbus_connection_call(connection, "org.freedesktop.DBus", "/org/freedesktop/DBus", "org.freedesktop.DBus",
+        "GetConnectionCredentials", g_variant_new("(s)", sender), G_VARIANT_TYPE("(a{sv})"), G_DBUS_CALL_FLAGS_NONE, -1,
+        nullptr, [](GObject* source, GAsyncResult* result, gpointer data) {
+          const auto invocation = static_cast<GDBusMethodInvocation*>(data);
+          const auto self = static_cast<SchedulerHelper*>(g_dbus_method_invocation_get_user_data(invocation));
+          g_autoptr(GError) error = nullptr;
+          g_autoptr(GVariant) reply = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), result, &error);
+          if (!reply) {
+            g_dbus_method_invocation_return_gerror(invocation, error);
+            return;
+          }
+          g_autoptr(GVariant) credentials = g_variant_get_child_value(reply, 0);
+          guint32 user;
+          guint32 process;
+          if (!g_variant_lookup(credentials, "UnixUserID", "u", &user) || user != getuid()
+              || !g_variant_lookup(credentials, "ProcessID", "u", &process)) {
+            g_dbus_method_invocation_return_error_literal(invocation, G_DBUS_ERROR, G_DBUS_ERROR_ACCESS_DENIED,
+              "only processes of the same user may attach");
+            return;
+          }
+          g_autofree gchar* link = g_strdup_printf("/proc/%u/exe", process);
+          g_autofree gchar* executable = g_file_read_link(link, nullptr);
+          self->attach(g_dbus_method_invocation_get_sender(invocation), executable ? executable : "", invocation);
+        }, invocation);
+    }
+
+    // The plugin resends its schedules after attaching, so the ones kept are dropped.
+    void attach(const gchar* sender, const gchar* executablePath, GDBusMethodInvocation* invocation) {
+      if (attached_watch) {
+        g_bus_unwatch_name(attached_watch);
+      }
+      if (grace_source_id) {
+        g_source_remove(std::exchange(grace_source_id, 0));
+      }
+      attached = sender;
+      executable = executablePath;
+      launched = false;
+      attached_watch = g_bus_watch_name_on_connection(connection, sender, G_BUS_NAME_WATCHER_FLAGS_NONE, nullptr,
+        [](GDBusConnection* connection, const gchar* name, gpointer data) {
+          static_cast<SchedulerHelper*>(data)->detach();
+        }, this, nullptr);
+      schedules.clear();
+      scheduler.cancelAll();
+
+      GVariantBuilder selectionsBuilder;
+      g_variant_builder_init(&selectionsBuilder, G_VARIANT_TYPE("a(xsi)"));
+      for (const auto& selection : selections) {
+        g_variant_builder_add(&selectionsBuilder, "(xsi)", selection.id, selection.payload.data(), selection.button);
+      }
+      selections.clear();
+      g_dbus_method_invocation_return_value(invocation, g_variant_new("(a(xsi))", &selectionsBuilder));
+    }
+
+    // The application is gone, so the helper takes over its schedules.
+    void detach() {
+      g_bus_unwatch_name(std::exchange(attached_watch, 0));
+      attached.clear();
+      const auto now = clock.now();
+      std::vector<std::int64_t> ids;
+      ids.reserve(schedules.size());
+      for (const auto& [id, schedule] : schedules) {
+        ids.push_back(id);
+      }
+      for (const auto id : ids) {
+        armSchedule(id, now);
+      }
+      quitIfIdle();
+    }
+
+    // Schedules id at its first deadline from now, occurrences of repeating notifications
+    // which the application may have fired already are skipped.
+    void armSchedule(std::int64_t id, gint64 now) {
+      auto& schedule = schedules.at(id);
+      if (schedule.deadline <= now && schedule.recurrence) {
+        const auto next = schedule.recurrence->next(now);
+        if (!next) {
+          schedules.erase(id);
+          RecordHelperFired(bus_name, id);
+          return;
+        }
+        schedule.deadline = *next;
+      } else if (schedule.deadline <= now && schedule.repeatInterval > 0) {
+        schedule.deadline = NextPeriodicDeadline(schedule.deadline, schedule.repeatInterval, now);
+      }
+      scheduler.schedule(id, schedule.deadline);
+    }
+
+    std::optional<gint64> fire(std::int64_t id, gint64 deadline) {
+      const auto iter = schedules.find(id);
+      if (iter == schedules.end()) {
+        return std::nullopt;
+      }
+      auto& schedule = iter->second;
+      backend.notify(id, schedule.content);
+      shown.insert(id);
+
+      std::optional<gint64> next;
+      if (schedule.recurrence) {
+        next = schedule.recurrence->next(std::max(deadline, clock.now()));
+      } else if (schedule.repeatInterval > 0) {
+        next = NextPeriodicDeadline(deadline, schedule.repeatInterval, clock.now());
+      }
+      if (!next) {
+        schedules.erase(iter);
+        RecordHelperFired(bus_name, id);
+        return std::nullopt;
+      }
+      schedule.deadline = *next;
+      return next;
+    }
+
+    gint64 reanchor(std::int64_t id, gint64 deadline, gint64 now) {
+      auto& schedule = schedules.at(id);
+      if (schedule.recurrence) {
+        schedule.deadline = deadline <= now ? deadline : schedule.recurrence->next(now).value_or(deadline);
+      } else if (schedule.repeatInterval > 0) {
+        schedule.deadline = ReanchorPeriodicDeadline(deadline, schedule.repeatInterval, now);
+      }
+      return schedule.deadline;
+    }
+
+    void select(std::int64_t id, const std::string& payload, gint32 button) {
+      if (!attached.empty()) {
+        g_dbus_connection_emit_signal(connection, attached.data(), SchedulerHelperObjectPath, SchedulerHelperInterface, "Selected",
+          g_variant_new("(xsi)", id, payload.data(), button), nullptr);
+        return;
+      }
+      if (selections.size() == MaxPendingSelections) {
+        selections.pop_front();
+      }
+      selections.push_back({ id, payload, button });
+      launch();
+    }
+
+    // Launches the application, which attaches and takes the selections once it starts.
+    void launch() {
+      if (launched || executable.empty()) {
+        return;
+      }
+      gchar* argv[] = { executable.data(), nullptr };
+      g_autoptr(GError) error = nullptr;
+      if (!g_spawn_async(nullptr, argv, nullptr, G_SPAWN_DEFAULT, nullptr, nullptr, nullptr, &error)) {
+        g_warning("Failed to launch %s: %s", executable.data(), error->message);
+        return;
+      }
+      launched = true;
+    }
+
+    void quitIfIdle() {
+      if (attached.empty() && !grace_source_id && schedules.empty() && selections.empty() && shown.empty()) {
+        quit();
+      }
+    }
+  };
+}
+
+int main(int argc, char** argv) {
+  if (argc != 4) {
+    g_printerr("Usage: %s BUS_NAME APP_NAME DESKTOP_ENTRY\n", argv[0]);
+    return 1;
+  }
+  g_set_prgname(flutter_local_notifications::SchedulerHelperExecutable);
+
+  GMainLoop* loop = g_main_loop_new(nullptr, FALSE);
+  auto helper = std::make_unique<SchedulerHelper>(loop, argv[1], argv[2], argv[3]);
+  // lost if another helper of the application owns the name already, or the bus is gone
+  const auto ownerId = g_bus_own_name(G_BUS_TYPE_SESSION, argv[1], G_BUS_NAME_OWNER_FLAGS_NONE,
+    [](GDBusConnection* connection, const gchar* name, gpointer data) {
+      const auto helper = static_cast<SchedulerHelper*>(data);
+      if (!helper->registerObject(connection)) {
+        helper->quit();
+      }
+    }, nullptr, [](GDBusConnection* connection, const gchar* name, gpointer data) {
+      static_cast<SchedulerHelper*>(data)->quit();
+    }, helper.get(), nullptr);
+
+  g_main_loop_run(loop);
+  g_bus_unown_name(ownerId);
+  helper.reset();
+  g_main_loop_unref(loop);
+  return 0;
+}
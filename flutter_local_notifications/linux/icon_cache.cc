@@ -0,0 +1,149 @@
+#include "icon_cache.h"
+
+#include <cassert>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+#include "gobject_ptr.h"
+
+namespace flutter_local_notifications {
+  IconCache::IconCache(std::size_t capacity, IconDecoder& decoder) : capacity(capacity), decoder(decoder) {
+    assert(capacity > 0);
+  }
+
+  IconCache::~IconCache() {
+    // the waiters belong to the owner of the cache, which is going away too
+    for (auto& entry : entries) {
+      entry.waiters.clear();
+    }
+    clear();
+  }
+
+  GIcon* IconCache::get(IconSource source, std::string_view content, ReadyCallback ready, bool* decoding) {
+    if (decoding) {
+      *decoding = false;
+    }
+    const auto entry = lookup(source, content);
+    if (entry == entries.end()) {
+      return nullptr;
+    }
+    if (entry->job) {
+      if (ready) {
+        entry->waiters.push_back(std::move(ready));
+      }
+      if (decoding) {
+        *decoding = true;
+      }
+    }
+    return G_ICON(g_object_ref(entry->icon));
+  }
+
+  void IconCache::prewarm(IconSource source, std::string_view content) {
+    lookup(source, content);
+  }
+
+  std::list<IconCache::Entry>::iterator IconCache::lookup(IconSource source, std::string_view content) {
+    const Key key{ source, std::hash<std::string_view>{}(content) };
+    const auto [begin, end] = index.equal_range(key);
+    for (auto iter = begin; iter != end; ++iter) {
+      const auto entry = iter->second;
+      gsize cachedSize;
+      const auto cachedData = g_bytes_get_data(entry->content, &cachedSize);
+      if (cachedSize == content.size() && std::memcmp(cachedData, content.data(), cachedSize) == 0) {
+        entries.splice(entries.begin(), entries, entry);
+        return entry;
+      }
+    }
+
+    const auto ownedContent = g_bytes_new(content.data(), content.size());
+    const auto icon = createIcon(source, ownedContent);
+    if (!icon) {
+      g_bytes_unref(ownedContent);
+      return entries.end();
+    }
+    entries.push_front(Entry{ key, ownedContent, icon, nullptr, {} });
+    const auto entry = entries.begin();
+    index.emplace(key, entry);
+    if (IconDecoder::isDecodable(source)) {
+      // the job is cancelled if the entry is removed before
+      entry->job = decoder.decode(source, ownedContent, [this, entry]() {
+        onDecoded(entry);
+      });
+    }
+    if (entries.size() > capacity) {
+      evict();
+    }
+    return entry;
+  }
+
+  void IconCache::clear() {
+    // removed first, as waiters may use the cache again
+    auto removed = std::move(entries);
+    entries.clear();
+    index.clear();
+    for (auto& entry : removed) {
+      release(entry);
+    }
+  }
+
+  void IconCache::onDecoded(std::list<Entry>::iterator entry) {
+    // the icon as is outlives the waiters, which may compare it with the icons they hold
+    const GObjectPtr<GIcon> icon(entry->icon);
+    const auto downscaled = IconDecoder::finish(entry->job);
+    entry->icon = downscaled ? downscaled : G_ICON(g_object_ref(icon.get()));
+    entry->job.reset();
+    const GObjectPtr<GIcon> decoded(G_ICON(g_object_ref(entry->icon)));
+    for (const auto& ready : std::exchange(entry->waiters, {})) {
+      ready(icon.get(), decoded.get());
+    }
+  }
+
+  void IconCache::release(Entry& entry) {
+    if (entry.job) {
+      IconDecoder::cancel(entry.job);
+    }
+    for (const auto& ready : entry.waiters) {
+      ready(entry.icon, entry.icon);
+    }
+    g_object_unref(entry.icon);
+    g_bytes_unref(entry.content);
+  }
+
+  GIcon* IconCache::createIcon(IconSource source, GBytes* content) {
+    switch (source) {
+    case IconSource::File:
+    {
+      // content is not null terminated
+      const std::string iconFilePath(static_cast<const char*>(g_bytes_get_data(content, nullptr)), g_bytes_get_size(content));
+      g_autoptr(GFile) iconFile = g_file_new_for_commandline_arg(iconFilePath.data());
+      return g_file_icon_new(iconFile);
+    }
+    case IconSource::Bytes:
+      // the icon holds a reference of the owned copy, so the data outlives the message it came from
+      return g_bytes_icon_new(content);
+    case IconSource::Theme:
+    {
+      const std::string themeName(static_cast<const char*>(g_bytes_get_data(content, nullptr)), g_bytes_get_size(content));
+      return g_themed_icon_new(themeName.data());
+    }
+    default:
+      return nullptr;
+    }
+  }
+
+  void IconCache::evict() {
+    std::list<Entry> removed;
+    removed.splice(removed.begin(), entries, std::prev(entries.end()));
+    auto& victim = removed.front();
+    const auto [begin, end] = index.equal_range(victim.key);
+    for (auto iter = begin; iter != end; ++iter) {
+      if (&*iter->second == &victim) {
+        index.erase(iter);
+        break;
+      }
+    }
+    release(victim);
+  }
+}
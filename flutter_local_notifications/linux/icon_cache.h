@@ -0,0 +1,93 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_ICON_CACHE_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_ICON_CACHE_H_
+
+#include <gio/gio.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "icon_decoder.h"
+
+namespace flutter_local_notifications {
+  // Caches GIcons by their content, a file path, the icon data or a theme name, so that
+  // notifications using the same icon share one GIcon.
+  // Least recently used icons are evicted once more than capacity icons are cached.
+  // File and byte icons are downscaled by decoder, once per cached icon, without blocking
+  // the main thread: the icon is used as is until it is decoded.
+  class IconCache {
+  public:
+    // Called with the icon which get returned and the decoded icon, which is the same
+    // one if it did not need downscaling or was evicted before it was decoded.
+    using ReadyCallback = std::function<void(GIcon* icon, GIcon* decoded)>;
+
+    IconCache(std::size_t capacity, IconDecoder& decoder);
+    ~IconCache();
+
+    IconCache(const IconCache&) = delete;
+    IconCache& operator=(const IconCache&) = delete;
+
+    // Returns a new reference of the icon described by source and content, content of
+    // IconSource::Bytes icons is copied into the cache if it is not cached yet.
+    // Never waits for the decoder: an icon which is still being decoded is returned as is,
+    // and ready, if set, is called once it is decoded. decoding, if set, receives whether
+    // that is the case.
+    GIcon* get(IconSource source, std::string_view content, ReadyCallback ready = nullptr, bool* decoding = nullptr);
+    // Starts decoding the icon if it is not cached yet, without waiting for it.
+    void prewarm(IconSource source, std::string_view content);
+
+    void clear();
+
+    std::size_t size() const {
+      return entries.size();
+    }
+
+  private:
+    struct Key {
+      IconSource source;
+      std::size_t hash;
+
+      bool operator==(const Key& other) const {
+        return source == other.source && hash == other.hash;
+      }
+    };
+
+    struct KeyHash {
+      std::size_t operator()(const Key& key) const {
+        return key.hash ^ static_cast<std::size_t>(key.source);
+      }
+    };
+
+    struct Entry {
+      Key key;
+      // owned copy of the content, used to tell apart contents with same hash
+      GBytes* content;
+      // the icon as is until job is finished, then the downscaled one if it needed downscaling
+      GIcon* icon;
+      // null once the icon is decoded
+      std::shared_ptr<IconDecoder::Job> job;
+      std::vector<ReadyCallback> waiters;
+    };
+
+    std::size_t capacity;
+    IconDecoder& decoder;
+    // most recently used entry comes first
+    std::list<Entry> entries;
+    std::unordered_multimap<Key, std::list<Entry>::iterator, KeyHash> index;
+
+    // Returns the entry of the icon, which is created if it is not cached yet.
+    std::list<Entry>::iterator lookup(IconSource source, std::string_view content);
+    static GIcon* createIcon(IconSource source, GBytes* content);
+    void onDecoded(std::list<Entry>::iterator entry);
+    // Releases an entry which is removed, its waiters get the icon as is if it is not decoded yet.
+    static void release(Entry& entry);
+    void evict();
+  };
+}
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_ICON_CACHE_H_
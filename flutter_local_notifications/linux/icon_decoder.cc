@@ -0,0 +1,148 @@
+#include "icon_decoder.h"
+
+#include <gdk-pixbuf/gdk-pixbuf.h>
+#include <algorithm>
+#include <cassert>
+#include <string>
+#include <utility>
+
+namespace flutter_local_notifications {
+  struct IconDecoder::Job {
+    IconSource source;
+    GBytes* content;
+    int size;
+    GMainContext* context;
+    // called on context once the job is done, only touched there
+    std::function<void()> onDone;
+
+    GMutex mutex;
+    bool done = false;
+    // null if the icon is used as is
+    GBytes* result = nullptr;
+
+    Job(IconSource source, GBytes* content, int size, std::function<void()> onDone)
+      : source(source), content(g_bytes_ref(content)), size(size), context(g_main_context_ref_thread_default()),
+        onDone(std::move(onDone)) {
+      g_mutex_init(&mutex);
+    }
+
+    ~Job() {
+      g_mutex_clear(&mutex);
+      if (result) {
+        g_bytes_unref(result);
+      }
+      g_bytes_unref(content);
+      g_main_context_unref(context);
+    }
+  };
+
+  namespace {
+    // Makes the loader decode at most at size, which also lets decoders like jpeg
+    // skip the full resolution.
+    void OnSizePrepared(GdkPixbufLoader* loader, gint width, gint height, gpointer data) {
+      auto& size = *static_cast<int*>(data);
+      if (width <= size && height <= size) {
+        size = 0;
+        return;
+      }
+      const auto scale = static_cast<double>(size) / std::max(width, height);
+      gdk_pixbuf_loader_set_size(loader, std::max(1, static_cast<int>(width * scale)), std::max(1, static_cast<int>(height * scale)));
+    }
+
+    // Returns the picture downscaled to size and encoded as png, or null if it is small
+    // enough already or cannot be decoded.
+    GBytes* Downscale(IconSource source, GBytes* content, int size) {
+      g_autoptr(GError) error = nullptr;
+      g_autoptr(GBytes) data = nullptr;
+      if (source == IconSource::File) {
+        const std::string path(static_cast<const char*>(g_bytes_get_data(content, nullptr)), g_bytes_get_size(content));
+        g_autoptr(GFile) file = g_file_new_for_commandline_arg(path.data());
+        gchar* contents;
+        gsize length;
+        if (!g_file_load_contents(file, nullptr, &contents, &length, nullptr, &error)) {
+          g_warning("Failed to load icon %s: %s", path.data(), error->message);
+          return nullptr;
+        }
+        data = g_bytes_new_take(contents, length);
+      } else {
+        data = g_bytes_ref(content);
+      }
+
+      // set to 0 by OnSizePrepared if the picture is not larger than size
+      int targetSize = size;
+      g_autoptr(GdkPixbufLoader) loader = gdk_pixbuf_loader_new();
+      g_signal_connect(loader, "size-prepared", G_CALLBACK(OnSizePrepared), &targetSize);
+      gsize length;
+      const auto bytes = static_cast<const guchar*>(g_bytes_get_data(data, &length));
+      const auto loaded = gdk_pixbuf_loader_write(loader, bytes, length, &error);
+      // must be closed even if writing failed
+      const auto closed = gdk_pixbuf_loader_close(loader, loaded ? &error : nullptr);
+      if (!loaded || !closed) {
+        g_warning("Failed to decode icon: %s", error->message);
+        return nullptr;
+      }
+      if (targetSize == 0) {
+        return nullptr;
+      }
+
+      const auto pixbuf = gdk_pixbuf_loader_get_pixbuf(loader);
+      gchar* buffer;
+      gsize bufferSize;
+      if (!pixbuf || !gdk_pixbuf_save_to_buffer(pixbuf, &buffer, &bufferSize, "png", &error, nullptr)) {
+        g_warning("Failed to encode icon: %s", error ? error->message : "no picture");
+        return nullptr;
+      }
+      return g_bytes_new_take(buffer, bufferSize);
+    }
+  }
+
+  IconDecoder::IconDecoder(int size) : size(size) {
+    pool = g_thread_pool_new(run, nullptr, std::max<gint>(g_get_num_processors(), 1), FALSE, nullptr);
+  }
+
+  IconDecoder::~IconDecoder() {
+    // jobs already queued are finished, their callbacks only run if they are not cancelled
+    g_thread_pool_free(pool, FALSE, TRUE);
+  }
+
+  std::shared_ptr<IconDecoder::Job> IconDecoder::decode(IconSource source, GBytes* content, std::function<void()> done) {
+    auto job = std::make_shared<Job>(source, content, size, std::move(done));
+    g_thread_pool_push(pool, new std::shared_ptr<Job>(job), nullptr);
+    return job;
+  }
+
+  GIcon* IconDecoder::finish(const std::shared_ptr<Job>& job) {
+    g_mutex_lock(&job->mutex);
+    assert(job->done);
+    const auto result = job->result;
+    g_mutex_unlock(&job->mutex);
+    return result ? g_bytes_icon_new(result) : nullptr;
+  }
+
+  void IconDecoder::cancel(const std::shared_ptr<Job>& job) {
+    job->onDone = nullptr;
+  }
+
+  void IconDecoder::run(gpointer data, gpointer userData) {
+    std::unique_ptr<std::shared_ptr<Job>> holder(static_cast<std::shared_ptr<Job>*>(data));
+    auto& job = **holder;
+    const auto result = Downscale(job.source, job.content, job.size);
+
+    g_mutex_lock(&job.mutex);
+    job.result = result;
+    job.done = true;
+    g_mutex_unlock(&job.mutex);
+    // the job is kept alive until its callback ran, even if its owner dropped it
+    g_main_context_invoke_full(job.context, G_PRIORITY_DEFAULT, notifyDone, holder.release(), [](gpointer data) {
+      delete static_cast<std::shared_ptr<Job>*>(data);
+    });
+  }
+
+  gboolean IconDecoder::notifyDone(gpointer data) {
+    auto& job = **static_cast<std::shared_ptr<Job>*>(data);
+    if (job.onDone) {
+      std::exchange(job.onDone, nullptr)();
+    }
+    return G_SOURCE_REMOVE;
+  }
+}
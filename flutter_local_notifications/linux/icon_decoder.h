@@ -0,0 +1,60 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_ICON_DECODER_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_ICON_DECODER_H_
+
+#include <gio/gio.h>
+#include <functional>
+#include <memory>
+
+namespace flutter_local_notifications {
+  enum class IconSource {
+    File,
+    Bytes,
+    Theme,
+  };
+
+  // Decodes file and byte icons on a thread pool and downscales the ones larger than
+  // size, so that they are sent to the notification server at notification size instead
+  // of the size of the picture.
+  class IconDecoder {
+  public:
+    struct Job;
+
+    explicit IconDecoder(int size);
+    ~IconDecoder();
+
+    IconDecoder(const IconDecoder&) = delete;
+    IconDecoder& operator=(const IconDecoder&) = delete;
+
+    // Only affects icons decoded afterwards.
+    void setSize(int newSize) {
+      size = newSize;
+    }
+
+    int getSize() const {
+      return size;
+    }
+
+    static bool isDecodable(IconSource source) {
+      return source == IconSource::File || source == IconSource::Bytes;
+    }
+
+    // Starts decoding content, which is the path of IconSource::File icons or the picture
+    // data of IconSource::Bytes icons. done is called on the thread default main context
+    // of the caller once the job is done, unless the job is cancelled before.
+    std::shared_ptr<Job> decode(IconSource source, GBytes* content, std::function<void()> done);
+    // Returns a new reference of the downscaled icon of a job which is done, or null if
+    // the icon does not need to be downscaled or cannot be decoded. Never waits.
+    static GIcon* finish(const std::shared_ptr<Job>& job);
+    // Drops the done callback of job, which still runs to its end on the pool.
+    static void cancel(const std::shared_ptr<Job>& job);
+
+  private:
+    int size;
+    GThreadPool* pool;
+
+    static void run(gpointer data, gpointer userData);
+    static gboolean notifyDone(gpointer data);
+  };
+}
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_ICON_DECODER_H_
@@ -21,6 +21,28 @@ FLUTTER_PLUGIN_EXPORT GType flutter_local_notifications_plugin_get_type();
 FLUTTER_PLUGIN_EXPORT void flutter_local_notifications_plugin_register_with_registrar(
     FlPluginRegistrar* registrar);
 
+// Native API, which may be called from any thread, e.g. by workers of the app which do
+// not run Dart. Calls do not block, they are queued and run in order on the main context
+// by the plugin registered last, like the method of the same name called from Dart.
+// They are dropped if no plugin is registered by then. Strings are copied, title and
+// body may be null.
+
+FLUTTER_PLUGIN_EXPORT void flutter_local_notifications_show(
+    gint32 id, const gchar* title, const gchar* body, const gchar* payload);
+
+// Like flutter_local_notifications_show, but sends nothing if the content did not change.
+FLUTTER_PLUGIN_EXPORT void flutter_local_notifications_update(
+    gint32 id, const gchar* title, const gchar* body, const gchar* payload);
+
+// Shows the notification at fire_time, in microseconds since the Unix epoch, or right
+// away if fire_time has already passed once the call runs.
+FLUTTER_PLUGIN_EXPORT void flutter_local_notifications_schedule(
+    gint32 id, const gchar* title, const gchar* body, const gchar* payload,
+    gint64 fire_time);
+
+// Cancels the notification, whether it is shown or pending.
+FLUTTER_PLUGIN_EXPORT void flutter_local_notifications_cancel(gint32 id);
+
 G_END_DECLS
 
 #endif  // FLUTTER_PLUGIN_FLUTTER_LOCAL_NOTIFICATIONS_PLUGIN_H_
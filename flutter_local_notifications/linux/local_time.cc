@@ -0,0 +1,69 @@
+#include "local_time.h"
+
+namespace flutter_local_notifications {
+  namespace {
+    gint64 FloorDiv(gint64 a, gint64 b) {
+      return a / b - (a % b < 0);
+    }
+  }
+
+  TimeZoneCache::~TimeZoneCache() {
+    for (const auto& [identifier, timeZone] : zones) {
+      g_time_zone_unref(timeZone);
+    }
+  }
+
+  GTimeZone* TimeZoneCache::get(const gchar* identifier) {
+    auto iter = zones.find(identifier);
+    if (iter == zones.end()) {
+      iter = zones.emplace(identifier, g_time_zone_new(identifier)).first;
+    }
+    return iter->second;
+  }
+
+  // Both conversions are from http://howardhinnant.github.io/date_algorithms.html
+  gint64 DaysFromCivil(const CivilDate& date) {
+    const gint64 year = date.month <= 2 ? date.year - 1 : date.year;
+    const auto era = FloorDiv(year, 400);
+    const auto yearOfEra = year - era * 400;
+    const auto dayOfYear = (153 * (date.month > 2 ? date.month - 3 : date.month + 9) + 2) / 5 + date.day - 1;
+    const auto dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+  }
+
+  CivilDate CivilFromDays(gint64 days) {
+    days += 719468;
+    const auto era = FloorDiv(days, 146097);
+    const auto dayOfEra = days - era * 146097;
+    const auto yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const auto dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const auto monthIndex = (5 * dayOfYear + 2) / 153;
+    const auto day = static_cast<gint>(dayOfYear - (153 * monthIndex + 2) / 5 + 1);
+    const auto month = static_cast<gint>(monthIndex < 10 ? monthIndex + 3 : monthIndex - 9);
+    return { static_cast<gint>(yearOfEra + era * 400 + (month <= 2)), month, day };
+  }
+
+  gint WeekdayOfDays(gint64 days) {
+    // 1970-01-01 is a Thursday
+    return static_cast<gint>(days + 3 - FloorDiv(days + 3, 7) * 7) + 1;
+  }
+
+  gint DaysInMonth(gint year, gint month) {
+    static constexpr gint Days[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    const auto leap = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+    return month == 2 && leap ? 29 : Days[month - 1];
+  }
+
+  gint64 ToLocalSeconds(GTimeZone* timeZone, gint64 time) {
+    const auto seconds = FloorDiv(time, G_USEC_PER_SEC);
+    const auto interval = g_time_zone_find_interval(timeZone, G_TIME_TYPE_UNIVERSAL, seconds);
+    return seconds + g_time_zone_get_offset(timeZone, interval);
+  }
+
+  gint64 FromLocalSeconds(GTimeZone* timeZone, gint64 localSeconds) {
+    // the hint picks the daylight saving time interval of a repeated time, which is the
+    // earlier one, and times in a gap are moved to its end, as g_date_time_new does
+    const auto interval = g_time_zone_adjust_time(timeZone, G_TIME_TYPE_DAYLIGHT, &localSeconds);
+    return (localSeconds - g_time_zone_get_offset(timeZone, interval)) * G_USEC_PER_SEC;
+  }
+}
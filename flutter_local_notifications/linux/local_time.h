@@ -0,0 +1,58 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_LOCAL_TIME_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_LOCAL_TIME_H_
+
+#include <glib.h>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+namespace flutter_local_notifications {
+  inline constexpr gint64 SecondsPerDay = 24 * 60 * 60;
+
+  // Parsed time zones by identifier, as g_time_zone_new reads and parses tzdata on
+  // every call.
+  class TimeZoneCache {
+  public:
+    TimeZoneCache() = default;
+    ~TimeZoneCache();
+
+    TimeZoneCache(const TimeZoneCache&) = delete;
+    TimeZoneCache& operator=(const TimeZoneCache&) = delete;
+
+    // Returns a time zone owned by the cache, valid until the cache is destroyed.
+    GTimeZone* get(const gchar* identifier);
+
+    std::size_t size() const {
+      return zones.size();
+    }
+
+  private:
+    std::unordered_map<std::string, GTimeZone*> zones;
+  };
+
+  // Date of the proleptic Gregorian calendar.
+  struct CivilDate {
+    gint year;
+    gint month;
+    gint day;
+  };
+
+  // Days since 1970-01-01.
+  gint64 DaysFromCivil(const CivilDate& date);
+  CivilDate CivilFromDays(gint64 days);
+  // 1 (Monday) to 7 (Sunday), like g_date_time_get_day_of_week.
+  gint WeekdayOfDays(gint64 days);
+  gint DaysInMonth(gint year, gint month);
+
+  // Returns the wall clock time of time in timeZone, in seconds since 1970-01-01T00:00:00
+  // of the zone. time is in microseconds of real time.
+  gint64 ToLocalSeconds(GTimeZone* timeZone, gint64 time);
+
+  // Returns the real time in microseconds of localSeconds in timeZone. Like
+  // g_date_time_new, a wall clock time skipped by a daylight saving time transition is
+  // moved to the end of the transition, and one repeated by a transition is taken the
+  // first time.
+  gint64 FromLocalSeconds(GTimeZone* timeZone, gint64 localSeconds);
+}
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_LOCAL_TIME_H_
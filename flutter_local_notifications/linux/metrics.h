@@ -0,0 +1,133 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_METRICS_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_METRICS_H_
+
+#include <glib.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+
+namespace flutter_local_notifications {
+  // Histogram of non-negative values with power of two buckets. Bucket 0 counts values
+  // below 1, and bucket i counts values in [2^(i-1), 2^i).
+  class Histogram {
+  public:
+    static constexpr std::size_t BucketCount = 48;
+
+    void record(std::int64_t value) {
+      if (value < 0) {
+        value = 0;
+      }
+      const auto bucket = value == 0 ? 0 : 64 - __builtin_clzll(static_cast<std::uint64_t>(value));
+      ++buckets[std::min<std::size_t>(bucket, BucketCount - 1)];
+      ++count;
+      sum += value;
+      max = std::max(max, value);
+    }
+
+    std::uint64_t getCount() const {
+      return count;
+    }
+
+    std::int64_t getSum() const {
+      return sum;
+    }
+
+    std::int64_t getMax() const {
+      return max;
+    }
+
+    const std::array<std::uint64_t, BucketCount>& getBuckets() const {
+      return buckets;
+    }
+
+  private:
+    std::array<std::uint64_t, BucketCount> buckets{};
+    std::uint64_t count = 0;
+    std::int64_t sum = 0;
+    std::int64_t max = 0;
+  };
+
+  // Metrics are collected only if FLUTTER_LOCAL_NOTIFICATIONS_ENABLE_METRICS is defined,
+  // otherwise Stopwatch and Metrics are empty and their calls compile away.
+#ifdef FLUTTER_LOCAL_NOTIFICATIONS_ENABLE_METRICS
+  class Stopwatch {
+  public:
+    Stopwatch() : start(std::chrono::steady_clock::now()) {
+    }
+
+    std::int64_t elapsedNanoseconds() const {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+  private:
+    std::chrono::steady_clock::time_point start;
+  };
+
+  class Metrics {
+  public:
+    static constexpr bool Enabled = true;
+
+    // Latency of handling a method call, in nanoseconds.
+    void recordMethod(std::string_view method, const Stopwatch& stopwatch) {
+      const auto elapsed = stopwatch.elapsedNanoseconds();
+      auto iter = methods.find(method);
+      if (iter == methods.end()) {
+        iter = methods.emplace(std::string(method), Histogram()).first;
+      }
+      iter->second.record(elapsed);
+    }
+
+    // Latency of sending a notification to the notification server, in nanoseconds.
+    void recordSend(const Stopwatch& stopwatch) {
+      send.record(stopwatch.elapsedNanoseconds());
+    }
+
+    // How late a scheduled notification fired, in microseconds.
+    void recordFireLateness(gint64 lateness) {
+      fire_lateness.record(lateness);
+    }
+
+    const std::map<std::string, Histogram, std::less<>>& getMethods() const {
+      return methods;
+    }
+
+    const Histogram& getSend() const {
+      return send;
+    }
+
+    const Histogram& getFireLateness() const {
+      return fire_lateness;
+    }
+
+  private:
+    std::map<std::string, Histogram, std::less<>> methods;
+    Histogram send;
+    Histogram fire_lateness;
+  };
+#else
+  class Stopwatch {
+  };
+
+  class Metrics {
+  public:
+    static constexpr bool Enabled = false;
+
+    void recordMethod(std::string_view method, const Stopwatch& stopwatch) {
+    }
+
+    void recordSend(const Stopwatch& stopwatch) {
+    }
+
+    void recordFireLateness(gint64 lateness) {
+    }
+  };
+#endif
+}
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_METRICS_H_
@@ -0,0 +1,53 @@
+#include "misfire_coalescer.h"
+
+#include <utility>
+
+namespace flutter_local_notifications {
+  namespace {
+    // titles listed in the body of a summary, later ones are elided
+    inline constexpr std::size_t MaxSummaryLines = 8;
+  }
+
+  MisfireCoalescer::MisfireCoalescer(Summary summary, SummaryCallback onSummary)
+    : summary(std::move(summary)), on_summary(std::move(onSummary)) {
+  }
+
+  MisfireCoalescer::~MisfireCoalescer() {
+    if (idle_source_id) {
+      g_source_remove(idle_source_id);
+    }
+  }
+
+  void MisfireCoalescer::add(const std::string& title) {
+    if (count < MaxSummaryLines) {
+      if (count > 0) {
+        body.push_back('\n');
+      }
+      body.append(title);
+    } else if (count == MaxSummaryLines) {
+      body.append("\n…");
+    }
+    ++count;
+    if (idle_source_id) {
+      return;
+    }
+    idle_source_id = g_idle_add_full(G_PRIORITY_DEFAULT, [](gpointer p) -> gboolean {
+      const auto self = static_cast<MisfireCoalescer*>(p);
+      self->idle_source_id = 0;
+      self->flush();
+      return G_SOURCE_REMOVE;
+    }, this, nullptr);
+  }
+
+  void MisfireCoalescer::flush() {
+    if (idle_source_id) {
+      g_source_remove(std::exchange(idle_source_id, 0));
+    }
+    if (count == 0) {
+      return;
+    }
+    const auto summaryBody = std::exchange(body, {});
+    count = 0;
+    on_summary(summary, summaryBody);
+  }
+}
@@ -0,0 +1,71 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_MISFIRE_COALESCER_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_MISFIRE_COALESCER_H_
+
+#include <glib.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+
+namespace flutter_local_notifications {
+  // What happens to a scheduled notification which fires later than the misfire threshold,
+  // e.g. because the system was suspended. Same order as LinuxMisfirePolicy on Dart side.
+  enum class MisfirePolicy : std::uint8_t {
+    // sent once, occurrences missed as well are skipped
+    FireOnce,
+    // sent once per occurrence missed, up to MaxCatchUpFires in a row
+    FireAll,
+    Skip,
+    // summarized by MisfireCoalescer
+    Coalesce,
+  };
+
+  // Occurrences of a notification with MisfirePolicy::FireAll which are caught up at once.
+  inline constexpr std::uint32_t MaxCatchUpFires = 16;
+
+  // Collects notifications which misfired with MisfirePolicy::Coalesce, and summarizes the
+  // ones collected in the same main loop iteration, e.g. all overdue after a resume, in one
+  // notification.
+  class MisfireCoalescer {
+  public:
+    struct Summary {
+      std::int64_t id;
+      std::string title;
+    };
+
+    // body lists the titles of the notifications summarized.
+    using SummaryCallback = std::function<void(const Summary& summary, const std::string& body)>;
+
+    MisfireCoalescer(Summary summary, SummaryCallback onSummary);
+    ~MisfireCoalescer();
+
+    MisfireCoalescer(const MisfireCoalescer&) = delete;
+    MisfireCoalescer& operator=(const MisfireCoalescer&) = delete;
+
+    void setSummary(Summary value) {
+      summary = std::move(value);
+    }
+
+    const Summary& getSummary() const {
+      return summary;
+    }
+
+    void add(const std::string& title);
+    // Summarizes the notifications collected so far, instead of waiting for the main loop.
+    void flush();
+
+    std::size_t size() const {
+      return count;
+    }
+
+  private:
+    Summary summary;
+    SummaryCallback on_summary;
+    std::string body;
+    std::size_t count = 0;
+    guint idle_source_id = 0;
+  };
+}
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_MISFIRE_COALESCER_H_
@@ -0,0 +1,87 @@
+#include "native_call_queue.h"
+
+#include <utility>
+
+namespace flutter_local_notifications {
+  NativeCallQueue::NativeCallQueue(RunCallback run) : run_callback(std::move(run)), head(&stub), tail(&stub) {
+  }
+
+  // Only destroyed with no idle source pending, calls left are dropped.
+  NativeCallQueue::~NativeCallQueue() {
+    while (const auto call = pop()) {
+      delete call;
+    }
+  }
+
+  void NativeCallQueue::push(NativeCall* call) {
+    link(call);
+    stats.pushed.fetch_add(1, std::memory_order_relaxed);
+    if (scheduled.exchange(true)) {
+      return;
+    }
+    g_idle_add_full(G_PRIORITY_DEFAULT, [](gpointer data) -> gboolean {
+      return static_cast<NativeCallQueue*>(data)->runBatch() ? G_SOURCE_CONTINUE : G_SOURCE_REMOVE;
+    }, this, nullptr);
+  }
+
+  void NativeCallQueue::link(NativeCall* call) {
+    call->next.store(nullptr, std::memory_order_relaxed);
+    const auto previous = head.exchange(call);
+    // the call is not reachable by the consumer until this
+    previous->next.store(call, std::memory_order_release);
+  }
+
+  NativeCall* NativeCallQueue::pop() {
+    auto call = tail;
+    auto next = call->next.load(std::memory_order_acquire);
+    if (call == &stub) {
+      if (!next) {
+        return nullptr;
+      }
+      tail = call = next;
+      next = call->next.load(std::memory_order_acquire);
+    }
+    if (next) {
+      tail = next;
+      return call;
+    }
+    if (call != head.load()) {
+      // a producer exchanged head but has not linked its call yet
+      return nullptr;
+    }
+    // call is the last one, put stub behind it so that it can be unlinked
+    link(&stub);
+    next = call->next.load(std::memory_order_acquire);
+    if (next) {
+      tail = next;
+      return call;
+    }
+    return nullptr;
+  }
+
+  bool NativeCallQueue::empty() const {
+    return head.load() == tail;
+  }
+
+  bool NativeCallQueue::runBatch() {
+    std::size_t count = 0;
+    while (count < MaxBatch) {
+      const auto call = pop();
+      if (!call) {
+        break;
+      }
+      run_callback(*call);
+      delete call;
+      ++count;
+    }
+    stats.run += count;
+    ++stats.batches;
+    if (count == MaxBatch) {
+      return true;
+    }
+    scheduled.store(false);
+    // producers which pushed since the last pop may have seen scheduled still set, their
+    // calls are left to this source then
+    return !empty() && !scheduled.exchange(true);
+  }
+}
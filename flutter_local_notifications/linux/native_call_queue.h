@@ -0,0 +1,85 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_NATIVE_CALL_QUEUE_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_NATIVE_CALL_QUEUE_H_
+
+#include <glib.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+
+namespace flutter_local_notifications {
+  // A call of the native API, made on any thread.
+  struct NativeCall {
+    enum class Operation : std::uint8_t {
+      Show,
+      Update,
+      Schedule,
+      Cancel,
+    };
+
+    Operation operation;
+    std::int64_t id;
+    std::optional<std::string> title;
+    std::optional<std::string> body;
+    std::string payload;
+    // in microseconds of real time, for Operation::Schedule
+    gint64 fireTime = 0;
+
+    std::atomic<NativeCall*> next{ nullptr };
+  };
+
+  // Queue of NativeCalls with any number of producer threads, which push without locks,
+  // and the main context as consumer. The first call pushed after the queue ran empty
+  // adds an idle source to the main context, which runs the calls queued meanwhile in
+  // batches of up to MaxBatch, so that a burst of calls costs one wakeup.
+  class NativeCallQueue {
+  public:
+    using RunCallback = std::function<void(NativeCall& call)>;
+
+    // calls run by an iteration of the main context, the rest waits for the next one
+    static constexpr std::size_t MaxBatch = 256;
+
+    struct Stats {
+      std::atomic<std::uint64_t> pushed{ 0 };
+      // written by the main context only
+      std::uint64_t run = 0;
+      std::uint64_t batches = 0;
+    };
+
+    explicit NativeCallQueue(RunCallback run);
+    ~NativeCallQueue();
+
+    NativeCallQueue(const NativeCallQueue&) = delete;
+    NativeCallQueue& operator=(const NativeCallQueue&) = delete;
+
+    // Thread-safe, the queue takes ownership of call.
+    void push(NativeCall* call);
+
+    const Stats& getStats() const {
+      return stats;
+    }
+
+  private:
+    RunCallback run_callback;
+    // Intrusive queue of Dmitry Vyukov: producers exchange head and then link the previous
+    // head to their call, the consumer follows next from tail. stub keeps it non-empty.
+    NativeCall stub;
+    std::atomic<NativeCall*> head;
+    NativeCall* tail;
+    // set while the idle source is added or about to be
+    std::atomic<bool> scheduled{ false };
+    Stats stats;
+
+    void link(NativeCall* call);
+    // Returns the oldest call, null if the queue is empty or its oldest call is still being
+    // linked by its producer, which then finds scheduled unset.
+    NativeCall* pop();
+    bool empty() const;
+    // Returns whether calls remain to be run.
+    bool runBatch();
+  };
+}
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_NATIVE_CALL_QUEUE_H_
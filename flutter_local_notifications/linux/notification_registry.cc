@@ -0,0 +1,177 @@
+#include "notification_registry.h"
+
+#include <string_view>
+#include <utility>
+
+namespace flutter_local_notifications {
+  bool IdSet::insert(std::int64_t id) {
+    if (!indices.emplace(id, ids.size()).second) {
+      return false;
+    }
+    ids.push_back(id);
+    return true;
+  }
+
+  bool IdSet::erase(std::int64_t id) {
+    const auto iter = indices.find(id);
+    if (iter == indices.end()) {
+      return false;
+    }
+    const auto index = iter->second;
+    indices.erase(iter);
+    const auto last = ids.back();
+    ids.pop_back();
+    if (index != ids.size()) {
+      ids[index] = last;
+      indices[last] = index;
+    }
+    return true;
+  }
+
+  NotificationRegistry::Entry* NotificationRegistry::find(std::int64_t id) {
+    const auto iter = entries.find(id);
+    return iter == entries.end() ? nullptr : &iter->second;
+  }
+
+  const NotificationRegistry::Entry* NotificationRegistry::find(std::int64_t id) const {
+    const auto iter = entries.find(id);
+    return iter == entries.end() ? nullptr : &iter->second;
+  }
+
+  NotificationRegistry::Entry& NotificationRegistry::setContent(std::int64_t id, const char* title, const char* body, const char* payload) {
+    auto& entry = entries[id];
+    // interned first, so that unchanged strings are not released in between
+    const auto titleId = string_pool.intern(title ? title : "");
+    const auto bodyId = string_pool.intern(body ? body : "");
+    const auto payloadId = string_pool.intern(payload ? payload : "");
+    releaseContent(entry);
+    entry.title = titleId;
+    entry.body = bodyId;
+    entry.payload = payloadId;
+    entry.digest = ContentDigest(title, body, payload);
+    return entry;
+  }
+
+  void NotificationRegistry::setGroup(Entry& entry, const char* group) {
+    const auto groupId = string_pool.intern(group ? group : "");
+    string_pool.release(entry.group);
+    entry.group = groupId;
+  }
+
+  NotificationRegistry::Entry& NotificationRegistry::markShown(std::int64_t id) {
+    auto& entry = entries[id];
+    entry.shown = true;
+    entry.queued = false;
+    shown.insert(id);
+    return entry;
+  }
+
+  NotificationRegistry::Entry& NotificationRegistry::markPending(std::int64_t id, GObjectPtr<GIcon> icon, std::string_view buttons,
+    gint64 nextFireTime, gint64 repeatInterval) {
+    auto& entry = entries[id];
+    const auto buttonsId = string_pool.intern(buttons);
+    releasePending(entry);
+    entry.pending = true;
+    entry.buttons = buttonsId;
+    entry.icon = std::move(icon);
+    entry.nextFireTime = nextFireTime;
+    entry.repeatInterval = repeatInterval;
+    entry.recurrence.reset();
+    entry.followsSystemTimeZone = false;
+    entry.catchUpFires = 0;
+    pending.insert(id);
+    return entry;
+  }
+
+  void NotificationRegistry::markFired(std::int64_t id) {
+    const auto iter = entries.find(id);
+    if (iter == entries.end()) {
+      return;
+    }
+    auto& entry = iter->second;
+    entry.pending = false;
+    releasePending(entry);
+    entry.nextFireTime = 0;
+    entry.repeatInterval = 0;
+    entry.recurrence.reset();
+    entry.followsSystemTimeZone = false;
+    pending.erase(id);
+    eraseIfWithdrawn(iter);
+  }
+
+  void NotificationRegistry::markDismissed(std::int64_t id) {
+    const auto iter = entries.find(id);
+    if (iter == entries.end()) {
+      return;
+    }
+    iter->second.shown = false;
+    shown.erase(id);
+    eraseIfWithdrawn(iter);
+  }
+
+  void NotificationRegistry::markQueued(std::int64_t id) {
+    const auto iter = entries.find(id);
+    if (iter != entries.end()) {
+      iter->second.queued = true;
+    }
+  }
+
+  void NotificationRegistry::markDropped(std::int64_t id) {
+    const auto iter = entries.find(id);
+    if (iter == entries.end()) {
+      return;
+    }
+    iter->second.queued = false;
+    eraseIfWithdrawn(iter);
+  }
+
+  void NotificationRegistry::withdraw(std::int64_t id) {
+    const auto iter = entries.find(id);
+    if (iter != entries.end()) {
+      releasePending(iter->second);
+      releaseContent(iter->second);
+      entries.erase(iter);
+    }
+    shown.erase(id);
+    pending.erase(id);
+  }
+
+  void NotificationRegistry::clear() {
+    entries.clear();
+    string_pool.clear();
+    shown = IdSet();
+    pending = IdSet();
+  }
+
+  void NotificationRegistry::eraseIfWithdrawn(std::unordered_map<std::int64_t, Entry>::iterator iter) {
+    if (iter->second.state() == State::Withdrawn) {
+      releaseContent(iter->second);
+      entries.erase(iter);
+    }
+  }
+
+  void NotificationRegistry::releasePending(Entry& entry) {
+    string_pool.release(std::exchange(entry.buttons, 0));
+    entry.icon.reset();
+  }
+
+  void NotificationRegistry::releaseContent(Entry& entry) {
+    string_pool.release(std::exchange(entry.title, 0));
+    string_pool.release(std::exchange(entry.body, 0));
+    string_pool.release(std::exchange(entry.payload, 0));
+    string_pool.release(std::exchange(entry.group, 0));
+  }
+
+  std::uint64_t ContentDigest(const char* title, const char* body, const char* payload) {
+    // FNV-1a, fields are separated by their terminating null character
+    std::uint64_t hash = 14695981039346656037ull;
+    for (const auto field : { title, body, payload }) {
+      const std::string_view value = field ? field : "";
+      for (const auto c : value) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+      }
+      hash *= 1099511628211ull;
+    }
+    return hash;
+  }
+}
@@ -0,0 +1,198 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_NOTIFICATION_REGISTRY_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_NOTIFICATION_REGISTRY_H_
+
+#include <gio/gio.h>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "admission_queue.h"
+#include "gobject_ptr.h"
+#include "misfire_coalescer.h"
+#include "recurrence.h"
+#include "string_pool.h"
+
+namespace flutter_local_notifications {
+  // Set of ids which supports O(1) insertion and removal, and iteration in O(size).
+  class IdSet {
+  public:
+    bool insert(std::int64_t id);
+    bool erase(std::int64_t id);
+
+    bool contains(std::int64_t id) const {
+      return indices.find(id) != indices.end();
+    }
+
+    std::size_t size() const {
+      return ids.size();
+    }
+
+    std::vector<std::int64_t>::const_iterator begin() const {
+      return ids.begin();
+    }
+
+    std::vector<std::int64_t>::const_iterator end() const {
+      return ids.end();
+    }
+
+  private:
+    std::vector<std::int64_t> ids;
+    // Key: id, Value: index in ids
+    std::unordered_map<std::int64_t, std::size_t> indices;
+  };
+
+  // Tracks every notification of the plugin by id, whether it is shown or pending.
+  // Shown and pending notifications are indexed separately, so that querying or cancelling
+  // them is O(k) of the matched notifications.
+  class NotificationRegistry {
+  public:
+    enum class State {
+      // Not known to the registry, either never created or withdrawn.
+      Withdrawn,
+      Shown,
+      // Pending and fires once.
+      Scheduled,
+      // Pending and fires repeatedly, may also be shown.
+      Repeating,
+      // Waiting in the AdmissionQueue to be shown, its content is kept until it is sent
+      // or dropped.
+      Queued,
+    };
+
+    // Pending notifications are kept as their content only, their GNotification is built
+    // once they fire. Strings are interned in strings() and the icon is shared with
+    // IconCache, so a pending entry takes about 150 bytes with its node in the map, plus
+    // the strings it does not share with others, see BM_PendingFootprint.
+    struct Entry {
+      bool shown = false;
+      bool pending = false;
+      // see State::Queued
+      bool queued = false;
+      NotificationPriority priority = NotificationPriority::Normal;
+      MisfirePolicy misfirePolicy = MisfirePolicy::FireOnce;
+      // set if the notification was scheduled in the system time zone, whose wall clock
+      // time it keeps when the system time zone changes
+      bool followsSystemTimeZone = false;
+      // occurrences caught up in a row with MisfirePolicy::FireAll
+      std::uint32_t catchUpFires = 0;
+      // in microseconds, 0 if the notification fires only once
+      gint64 repeatInterval = 0;
+      // absolute deadline of pending notification, in microseconds of real time
+      gint64 nextFireTime = 0;
+      // set if the notification repeats by a rule in local time, in which case deadlines
+      // follow it instead of repeatInterval
+      std::optional<Recurrence> recurrence;
+      // digest of title, body and payload, see ContentDigest
+      std::uint64_t digest = 0;
+      StringPool::Id title = 0;
+      StringPool::Id body = 0;
+      StringPool::Id payload = 0;
+      // see ActiveSet
+      StringPool::Id group = 0;
+      // label and payload of every button of the pending notification, each followed by a
+      // null character, see EncodeButtons
+      StringPool::Id buttons = 0;
+      // icon of the pending notification, null if it uses the default icon
+      GObjectPtr<GIcon> icon;
+
+      State state() const {
+        if (pending) {
+          return repeatInterval > 0 ? State::Repeating : State::Scheduled;
+        }
+        if (shown) {
+          return State::Shown;
+        }
+        return queued ? State::Queued : State::Withdrawn;
+      }
+    };
+
+    Entry* find(std::int64_t id);
+    const Entry* find(std::int64_t id) const;
+
+    State stateOf(std::int64_t id) const {
+      const auto entry = find(id);
+      return entry ? entry->state() : State::Withdrawn;
+    }
+
+    // Records content of a notification, creating its entry if needed.
+    Entry& setContent(std::int64_t id, const char* title, const char* body, const char* payload);
+
+    // group of null is the one of notifications without a group.
+    void setGroup(Entry& entry, const char* group);
+
+    Entry& markShown(std::int64_t id);
+    // buttons are encoded by EncodeButtons.
+    Entry& markPending(std::int64_t id, GObjectPtr<GIcon> icon, std::string_view buttons, gint64 nextFireTime, gint64 repeatInterval);
+    // Drops the pending state after the notification fired for the last time.
+    void markFired(std::int64_t id);
+    // Drops the shown state, the entry is removed if it is not pending either.
+    void markDismissed(std::int64_t id);
+    // Keeps the content of an existing entry while the AdmissionQueue holds it back.
+    void markQueued(std::int64_t id);
+    // Drops the queued state once the AdmissionQueue dropped the notification, the entry
+    // is removed if it is neither shown nor pending.
+    void markDropped(std::int64_t id);
+    // Removes the entry.
+    void withdraw(std::int64_t id);
+    void clear();
+
+    const IdSet& shownIds() const {
+      return shown;
+    }
+
+    const IdSet& pendingIds() const {
+      return pending;
+    }
+
+    std::size_t size() const {
+      return entries.size();
+    }
+
+    // Strings of the entries by their ids.
+    const StringPool& strings() const {
+      return string_pool;
+    }
+
+  private:
+    std::unordered_map<std::int64_t, Entry> entries;
+    StringPool string_pool;
+    IdSet shown;
+    IdSet pending;
+
+    void eraseIfWithdrawn(std::unordered_map<std::int64_t, Entry>::iterator iter);
+    void releasePending(Entry& entry);
+    void releaseContent(Entry& entry);
+  };
+
+  std::uint64_t ContentDigest(const char* title, const char* body, const char* payload);
+
+  // Encodes label and payload of buttons as one string, each followed by a null character.
+  template <typename Buttons>
+  std::string EncodeButtons(const Buttons& buttons) {
+    std::string encoded;
+    for (const auto& button : buttons) {
+      for (const auto field : { button.label, button.payload }) {
+        encoded.append(field ? field : "");
+        encoded.push_back('\0');
+      }
+    }
+    return encoded;
+  }
+
+  // Calls callback with label and payload of every button encoded by EncodeButtons.
+  template <typename Callback>
+  void ForEachButton(const std::string& encoded, Callback&& callback) {
+    for (std::size_t offset = 0; offset < encoded.size();) {
+      const auto label = encoded.data() + offset;
+      const auto payload = label + std::char_traits<char>::length(label) + 1;
+      callback(label, payload);
+      offset = payload + std::char_traits<char>::length(payload) + 1 - encoded.data();
+    }
+  }
+}
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_NOTIFICATION_REGISTRY_H_
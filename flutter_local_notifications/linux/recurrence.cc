@@ -0,0 +1,216 @@
+#include "recurrence.h"
+
+#include <algorithm>
+
+namespace flutter_local_notifications {
+  namespace {
+    using Frequency = RecurrenceRule::Frequency;
+
+    // Bounds the search of a monthly rule for a month which has its day, e.g. the 31st
+    // or the 5th Monday, which some months lack.
+    inline constexpr int MaxMonthsSearched = 48;
+
+    gint64 FloorDiv(gint64 a, gint64 b) {
+      return a / b - (a % b < 0);
+    }
+
+    gint64 CeilDiv(gint64 a, gint64 b) {
+      return -FloorDiv(-a, b);
+    }
+
+    guint8 WeekdayBit(gint weekday) {
+      return static_cast<guint8>(1u << (weekday - 1));
+    }
+  }
+
+  Recurrence::Recurrence(const RecurrenceRule& rule, GTimeZone* timeZone, GDateTime* start)
+    : rule(rule), time_zone(timeZone) {
+    g_autoptr(GDateTime) local = g_date_time_to_timezone(start, timeZone);
+    start_day = DaysFromCivil({ g_date_time_get_year(local), g_date_time_get_month(local), g_date_time_get_day_of_month(local) });
+    start_time_of_day = g_date_time_get_hour(local) * 3600 + g_date_time_get_minute(local) * 60 + g_date_time_get_second(local);
+    normalize();
+  }
+
+  Recurrence::Recurrence(const RecurrenceRule& rule, GTimeZone* timeZone, gint64 startDay, gint32 startTimeOfDay)
+    : rule(rule), time_zone(timeZone), start_day(startDay),
+      start_time_of_day(std::clamp<gint32>(startTimeOfDay, 0, SecondsPerDay - 1)) {
+    normalize();
+  }
+
+  void Recurrence::normalize() {
+    rule.interval = std::max<guint16>(rule.interval, 1);
+    rule.endOfDay = std::clamp<gint32>(rule.endOfDay, 0, SecondsPerDay - 1);
+    if (rule.frequency == Frequency::Weekly && rule.weekdays == 0) {
+      rule.weekdays = WeekdayBit(WeekdayOfDays(start_day));
+    }
+  }
+
+  std::optional<gint64> Recurrence::next(gint64 after) const {
+    if (rule.until != 0 && after >= rule.until) {
+      return std::nullopt;
+    }
+    auto day = std::max(FloorDiv(ToLocalSeconds(time_zone, after), SecondsPerDay), start_day);
+    // only the day of after may have no occurrence left, the next day found has one
+    for (int attempt = 0; attempt < 2; ++attempt, ++day) {
+      const auto found = nextDay(day);
+      if (!found) {
+        return std::nullopt;
+      }
+      day = *found;
+      if (const auto occurrence = nextOnDay(day, after)) {
+        if (rule.until != 0 && *occurrence > rule.until) {
+          return std::nullopt;
+        }
+        return occurrence;
+      }
+    }
+    return std::nullopt;
+  }
+
+  gint64 Recurrence::period() const {
+    gint64 unit;
+    switch (rule.frequency) {
+    case Frequency::Minutely:
+      unit = G_TIME_SPAN_MINUTE;
+      break;
+    case Frequency::Hourly:
+      unit = G_TIME_SPAN_HOUR;
+      break;
+    case Frequency::Weekly:
+      unit = 7 * G_TIME_SPAN_DAY;
+      break;
+    case Frequency::Monthly:
+      unit = 30 * G_TIME_SPAN_DAY;
+      break;
+    default:
+      unit = G_TIME_SPAN_DAY;
+      break;
+    }
+    return rule.interval * unit;
+  }
+
+  bool Recurrence::matchesWeekday(gint64 day) const {
+    return rule.weekdays == 0 || (rule.weekdays & WeekdayBit(WeekdayOfDays(day)));
+  }
+
+  std::optional<gint64> Recurrence::nextDay(gint64 day) const {
+    switch (rule.frequency) {
+    case Frequency::Weekly:
+      return nextDayOfWeeklyRule(day);
+    case Frequency::Monthly:
+      return nextDayOfMonthlyRule(day);
+    case Frequency::Daily:
+      // days on the grid of the start
+      day = start_day + CeilDiv(day - start_day, rule.interval) * rule.interval;
+      for (int i = 0; i < 7; ++i, day += rule.interval) {
+        if (matchesWeekday(day)) {
+          return day;
+        }
+      }
+      // the grid never meets weekdays, e.g. every 7 days of a weekday not in them
+      return std::nullopt;
+    default:
+      for (int i = 0; i < 7; ++i, ++day) {
+        if (matchesWeekday(day)) {
+          return day;
+        }
+      }
+      return std::nullopt;
+    }
+  }
+
+  std::optional<gint64> Recurrence::nextDayOfWeeklyRule(gint64 day) const {
+    // weeks start on Monday
+    const auto firstMonday = start_day - (WeekdayOfDays(start_day) - 1);
+    auto week = FloorDiv(day - firstMonday, 7);
+    auto fromWeekday = WeekdayOfDays(day);
+    if (week % rule.interval != 0) {
+      week = CeilDiv(week, rule.interval) * rule.interval;
+      fromWeekday = 1;
+    }
+    for (int i = 0; i < 2; ++i) {
+      for (auto weekday = fromWeekday; weekday <= 7; ++weekday) {
+        if (rule.weekdays & WeekdayBit(weekday)) {
+          return firstMonday + week * 7 + weekday - 1;
+        }
+      }
+      week += rule.interval;
+      fromWeekday = 1;
+    }
+    return std::nullopt;
+  }
+
+  std::optional<gint64> Recurrence::nextDayOfMonthlyRule(gint64 day) const {
+    const auto startDate = CivilFromDays(start_day);
+    const auto date = CivilFromDays(day);
+    const auto startMonth = startDate.year * gint64{ 12 } + startDate.month - 1;
+    auto month = date.year * gint64{ 12 } + date.month - 1 - startMonth;
+    gint fromDay = date.day;
+    if (month % rule.interval != 0) {
+      month = CeilDiv(month, rule.interval) * rule.interval;
+      fromDay = 1;
+    }
+    for (int i = 0; i < MaxMonthsSearched; ++i, month += rule.interval, fromDay = 1) {
+      const auto absoluteMonth = startMonth + month;
+      const auto year = static_cast<gint>(FloorDiv(absoluteMonth, 12));
+      const auto monthOfYear = static_cast<gint>(absoluteMonth - year * gint64{ 12 }) + 1;
+      if (const auto found = dayOfMonth(year, monthOfYear, fromDay)) {
+        return DaysFromCivil({ year, monthOfYear, *found });
+      }
+    }
+    return std::nullopt;
+  }
+
+  std::optional<gint> Recurrence::dayOfMonth(gint year, gint month, gint fromDay) const {
+    const auto length = DaysInMonth(year, month);
+    if (rule.weekdays == 0) {
+      const auto day = CivilFromDays(start_day).day;
+      return day >= fromDay && day <= length ? std::optional{ day } : std::nullopt;
+    }
+
+    const auto firstWeekday = WeekdayOfDays(DaysFromCivil({ year, month, 1 }));
+    std::optional<gint> result;
+    for (gint weekday = 1; weekday <= 7; ++weekday) {
+      if (!(rule.weekdays & WeekdayBit(weekday))) {
+        continue;
+      }
+      const auto first = 1 + (weekday - firstWeekday + 7) % 7;
+      gint day;
+      if (rule.weekOfMonth > 0) {
+        day = first + (rule.weekOfMonth - 1) * 7;
+      } else if (rule.weekOfMonth < 0) {
+        day = first + (length - first) / 7 * 7;
+      } else {
+        day = first + static_cast<gint>(CeilDiv(std::max(fromDay - first, 0), 7)) * 7;
+      }
+      if (day >= fromDay && day <= length && (!result || day < *result)) {
+        result = day;
+      }
+    }
+    return result;
+  }
+
+  std::optional<gint64> Recurrence::nextOnDay(gint64 day, gint64 after) const {
+    const auto midnight = day * SecondsPerDay;
+    if (!isSubDaily()) {
+      const auto occurrence = FromLocalSeconds(time_zone, midnight + start_time_of_day);
+      return occurrence > after ? std::optional{ occurrence } : std::nullopt;
+    }
+
+    const gint64 step = rule.interval * (rule.frequency == Frequency::Minutely ? 60 : 3600);
+    // first time of the grid which is not before the wall clock time of after
+    gint64 timeOfDay = start_time_of_day;
+    const auto afterTimeOfDay = ToLocalSeconds(time_zone, after) - midnight;
+    if (afterTimeOfDay > timeOfDay) {
+      timeOfDay += CeilDiv(afterTimeOfDay - timeOfDay, step) * step;
+    }
+    // a time repeated by a transition may resolve to before after, and is then skipped
+    for (; timeOfDay <= rule.endOfDay; timeOfDay += step) {
+      const auto occurrence = FromLocalSeconds(time_zone, midnight + timeOfDay);
+      if (occurrence > after) {
+        return occurrence;
+      }
+    }
+    return std::nullopt;
+  }
+}
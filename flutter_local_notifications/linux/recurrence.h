@@ -0,0 +1,105 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_RECURRENCE_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_RECURRENCE_H_
+
+#include <glib.h>
+#include <optional>
+
+#include "local_time.h"
+
+namespace flutter_local_notifications {
+  // How a notification repeats, a subset of the RRULE of iCalendar.
+  struct RecurrenceRule {
+    // Same order as LinuxRecurrenceFrequency on Dart side.
+    enum class Frequency : guint8 {
+      Minutely,
+      Hourly,
+      Daily,
+      Weekly,
+      Monthly,
+    };
+
+    Frequency frequency = Frequency::Daily;
+    // occurrences are every interval minutes, hours, days, weeks or months
+    guint16 interval = 1;
+    // bit d - 1 is set for weekday d, from 1 (Monday) to 7 (Sunday), 0 for every weekday;
+    // weekly rules default to the weekday of the start
+    guint8 weekdays = 0;
+    // 1 to 5 for the nth and -1 for the last of weekdays in the month, 0 for all of them;
+    // monthly rules without weekdays repeat on the day of month of the start
+    gint8 weekOfMonth = 0;
+    // last time of day of minutely and hourly rules, in seconds, which restart every day
+    // at the time of day of the start
+    gint32 endOfDay = SecondsPerDay - 1;
+    // in microseconds of real time, 0 if the rule never ends
+    gint64 until = 0;
+  };
+
+  // A RecurrenceRule anchored at its start in a time zone. Occurrences are computed in
+  // local time, so that they keep their wall clock time across daylight saving time
+  // transitions, and the next one is found in O(1) amortized time by jumping to the
+  // first day which may have one, instead of walking the occurrences in between.
+  class Recurrence {
+  public:
+    // start is the first possible occurrence. timeZone must outlive the recurrence, and
+    // is usually owned by TimeZoneCache.
+    Recurrence(const RecurrenceRule& rule, GTimeZone* timeZone, GDateTime* start);
+    // startDay is in days since 1970-01-01 of the zone, startTimeOfDay in seconds, as
+    // returned by getStartDay and getStartTimeOfDay.
+    Recurrence(const RecurrenceRule& rule, GTimeZone* timeZone, gint64 startDay, gint32 startTimeOfDay);
+
+    // Returns the first occurrence after time in microseconds of real time, or nullopt
+    // if the rule has ended by then.
+    std::optional<gint64> next(gint64 after) const;
+
+    // Average time between occurrences in microseconds, for those which need a fixed
+    // interval, like the schedule journal.
+    gint64 period() const;
+
+    const RecurrenceRule& getRule() const {
+      return rule;
+    }
+
+    GTimeZone* getTimeZone() const {
+      return time_zone;
+    }
+
+    // Keeps the start day and time of day, so that occurrences follow the wall clock of
+    // timeZone from then on.
+    void setTimeZone(GTimeZone* timeZone) {
+      time_zone = timeZone;
+    }
+
+    gint64 getStartDay() const {
+      return start_day;
+    }
+
+    gint32 getStartTimeOfDay() const {
+      return start_time_of_day;
+    }
+
+  private:
+    RecurrenceRule rule;
+    GTimeZone* time_zone;
+    // in days since 1970-01-01 of the zone
+    gint64 start_day;
+    // in seconds
+    gint32 start_time_of_day;
+
+    bool isSubDaily() const {
+      return rule.frequency == RecurrenceRule::Frequency::Minutely || rule.frequency == RecurrenceRule::Frequency::Hourly;
+    }
+
+    void normalize();
+    bool matchesWeekday(gint64 day) const;
+    // first day not before day which has occurrences
+    std::optional<gint64> nextDay(gint64 day) const;
+    std::optional<gint64> nextDayOfWeeklyRule(gint64 day) const;
+    std::optional<gint64> nextDayOfMonthlyRule(gint64 day) const;
+    // first day of month not before fromDay which has an occurrence
+    std::optional<gint> dayOfMonth(gint year, gint month, gint fromDay) const;
+    // first occurrence on day after time
+    std::optional<gint64> nextOnDay(gint64 day, gint64 after) const;
+  };
+}
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_RECURRENCE_H_
@@ -0,0 +1,330 @@
+#include "schedule_store.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace flutter_local_notifications {
+  namespace {
+    inline constexpr char JournalMagic[] = { 'F', 'L', 'N', 'J' };
+    inline constexpr std::uint32_t JournalVersion = 1;
+    inline constexpr std::size_t HeaderSize = sizeof(JournalMagic) + sizeof(JournalVersion);
+    inline constexpr std::size_t RecordHeaderSize = sizeof(std::uint8_t) + sizeof(std::int64_t);
+    inline constexpr std::size_t ScheduleRecordFixedSize = RecordHeaderSize + sizeof(gint64) * 2 + sizeof(std::uint32_t);
+
+    // Journals with fewer records are never compacted.
+    inline constexpr std::size_t CompactionThreshold = 4096;
+
+    template <typename T>
+    void Put(std::string& buffer, T value) {
+      buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    template <typename T>
+    T Get(const char* data) {
+      T value;
+      std::memcpy(&value, data, sizeof(value));
+      return value;
+    }
+
+    std::string Header() {
+      std::string header(JournalMagic, sizeof(JournalMagic));
+      Put(header, JournalVersion);
+      return header;
+    }
+
+    bool WriteAll(int fd, const char* data, std::size_t size) {
+      while (size > 0) {
+        const auto written = write(fd, data, size);
+        if (written < 0) {
+          if (errno == EINTR) {
+            continue;
+          }
+          return false;
+        }
+        data += written;
+        size -= written;
+      }
+      return true;
+    }
+  }
+
+  ScheduleStore::ScheduleStore(std::string path)
+    : path(std::move(path)), time_zone_path(this->path + ".timezone"), fd(-1), codec(fl_standard_message_codec_new()),
+      record_count(0) {
+  }
+
+  ScheduleStore::~ScheduleStore() {
+    if (fd >= 0) {
+      close(fd);
+    }
+    g_object_unref(codec);
+  }
+
+  std::size_t ScheduleStore::parse(const char* data, std::size_t size, LiveRecordMap& liveRecords, std::size_t& recordCount) {
+    if (size < HeaderSize || std::memcmp(data, JournalMagic, sizeof(JournalMagic)) != 0 ||
+      Get<std::uint32_t>(data + sizeof(JournalMagic)) != JournalVersion) {
+      return 0;
+    }
+
+    std::size_t offset = HeaderSize;
+    while (offset + RecordHeaderSize <= size) {
+      const auto op = static_cast<Op>(Get<std::uint8_t>(data + offset));
+      const auto id = Get<std::int64_t>(data + offset + sizeof(std::uint8_t));
+      std::size_t recordSize = RecordHeaderSize;
+      switch (op) {
+      case Op::Schedule:
+        if (offset + ScheduleRecordFixedSize > size) {
+          return offset;
+        }
+        recordSize = ScheduleRecordFixedSize + Get<std::uint32_t>(data + offset + ScheduleRecordFixedSize - sizeof(std::uint32_t));
+        if (offset + recordSize > size) {
+          return offset;
+        }
+        liveRecords.insert_or_assign(id, offset);
+        break;
+      case Op::Cancel:
+        liveRecords.erase(id);
+        break;
+      case Op::CancelAll:
+        liveRecords.clear();
+        break;
+      default:
+        // corrupted, ignore the rest of journal
+        return offset;
+      }
+      offset += recordSize;
+      ++recordCount;
+    }
+    return offset;
+  }
+
+  std::size_t ScheduleStore::replay(const ReplayCallback& callback) {
+    g_autoptr(GError) error = nullptr;
+    g_autoptr(GMappedFile) file = g_mapped_file_new(path.data(), FALSE, &error);
+    if (!file) {
+      // nothing has been recorded yet
+      return 0;
+    }
+
+    const auto data = g_mapped_file_get_contents(file);
+    const auto size = g_mapped_file_get_length(file);
+    LiveRecordMap liveRecords;
+    std::size_t recordCount = 0;
+    const auto validSize = parse(data, size, liveRecords, recordCount);
+
+    live.clear();
+    live.reserve(liveRecords.size());
+    for (const auto [id, offset] : liveRecords) {
+      const auto record = data + offset + RecordHeaderSize;
+      const auto deadline = Get<gint64>(record);
+      const auto repeatInterval = Get<gint64>(record + sizeof(gint64));
+      const auto argumentsLength = Get<std::uint32_t>(record + sizeof(gint64) * 2);
+      g_autoptr(GBytes) argumentsBytes = g_bytes_new_static(data + offset + ScheduleRecordFixedSize, argumentsLength);
+      g_autoptr(FlValue) arguments = fl_message_codec_decode_message(FL_MESSAGE_CODEC(codec), argumentsBytes, nullptr);
+      if (!arguments) {
+        continue;
+      }
+      live.emplace(id);
+      callback(id, deadline, repeatInterval, arguments);
+    }
+    record_count = recordCount;
+
+    if (validSize != size) {
+      g_warning("Schedule journal %s is corrupted after offset %" G_GSIZE_FORMAT ", discarding the rest", path.data(), validSize);
+      compact();
+    } else {
+      compactIfNeeded();
+    }
+    return live.size();
+  }
+
+  void ScheduleStore::recordSchedule(std::int64_t id, gint64 deadline, gint64 repeatInterval, FlValue* arguments) {
+    g_autoptr(GError) error = nullptr;
+    g_autoptr(GBytes) encoded = fl_message_codec_encode_message(FL_MESSAGE_CODEC(codec), arguments, &error);
+    if (!encoded) {
+      g_warning("Failed to encode schedule %" G_GINT64_FORMAT ": %s", id, error->message);
+      return;
+    }
+    gsize encodedSize;
+    const auto encodedData = g_bytes_get_data(encoded, &encodedSize);
+    append(ScheduleRecord(id, deadline, repeatInterval, encodedData, encodedSize));
+    live.emplace(id);
+    compactIfNeeded();
+  }
+
+  std::string ScheduleStore::ScheduleRecord(std::int64_t id, gint64 deadline, gint64 repeatInterval, const void* arguments,
+    std::size_t argumentsSize) {
+    std::string record;
+    record.reserve(ScheduleRecordFixedSize + argumentsSize);
+    Put(record, static_cast<std::uint8_t>(Op::Schedule));
+    Put(record, id);
+    Put(record, deadline);
+    Put(record, repeatInterval);
+    Put(record, static_cast<std::uint32_t>(argumentsSize));
+    record.append(static_cast<const char*>(arguments), argumentsSize);
+    return record;
+  }
+
+  void ScheduleStore::recordMovedToTimeZone(const std::vector<std::pair<std::int64_t, gint64>>& deadlines, const char* timeZoneName) {
+    if (!deadlines.empty()) {
+      g_autoptr(GMappedFile) file = g_mapped_file_new(path.data(), FALSE, nullptr);
+      if (file) {
+        // the records of all schedules are found in one pass over the journal
+        const auto data = g_mapped_file_get_contents(file);
+        LiveRecordMap liveRecords;
+        std::size_t unused = 0;
+        parse(data, g_mapped_file_get_length(file), liveRecords, unused);
+        for (const auto& [id, deadline] : deadlines) {
+          const auto iter = liveRecords.find(id);
+          if (iter == liveRecords.end() || live.find(id) == live.end()) {
+            continue;
+          }
+          const auto record = data + iter->second + RecordHeaderSize;
+          const auto repeatInterval = Get<gint64>(record + sizeof(gint64));
+          const auto argumentsLength = Get<std::uint32_t>(record + sizeof(gint64) * 2);
+          g_autoptr(GBytes) argumentsBytes = g_bytes_new_static(data + iter->second + ScheduleRecordFixedSize, argumentsLength);
+          g_autoptr(FlValue) arguments = fl_message_codec_decode_message(FL_MESSAGE_CODEC(codec), argumentsBytes, nullptr);
+          if (!arguments || fl_value_get_type(arguments) != FL_VALUE_TYPE_MAP) {
+            continue;
+          }
+          // the wall clock time in scheduledDateTime is kept
+          fl_value_set_string_take(arguments, "timeZoneName", fl_value_new_string(timeZoneName));
+          g_autoptr(GBytes) encoded = fl_message_codec_encode_message(FL_MESSAGE_CODEC(codec), arguments, nullptr);
+          if (!encoded) {
+            continue;
+          }
+          gsize encodedSize;
+          const auto encodedData = g_bytes_get_data(encoded, &encodedSize);
+          append(ScheduleRecord(id, deadline, repeatInterval, encodedData, encodedSize));
+        }
+      }
+      compactIfNeeded();
+    }
+    recordTimeZone(timeZoneName);
+  }
+
+  std::string ScheduleStore::readTimeZone() const {
+    g_autofree gchar* contents = nullptr;
+    if (!g_file_get_contents(time_zone_path.data(), &contents, nullptr, nullptr)) {
+      return {};
+    }
+    return contents;
+  }
+
+  void ScheduleStore::recordTimeZone(const char* timeZoneName) {
+    if (readTimeZone() == timeZoneName) {
+      return;
+    }
+    g_autofree gchar* directory = g_path_get_dirname(time_zone_path.data());
+    g_mkdir_with_parents(directory, 0700);
+    g_autoptr(GError) error = nullptr;
+    if (!g_file_set_contents(time_zone_path.data(), timeZoneName, -1, &error)) {
+      g_warning("Failed to record time zone in %s: %s", time_zone_path.data(), error->message);
+    }
+  }
+
+  void ScheduleStore::recordCancel(std::int64_t id) {
+    if (!live.erase(id)) {
+      return;
+    }
+    std::string record;
+    Put(record, static_cast<std::uint8_t>(Op::Cancel));
+    Put(record, id);
+    append(record);
+    compactIfNeeded();
+  }
+
+  void ScheduleStore::recordCancelAll() {
+    live.clear();
+    // nothing survives a cancel all, start over instead of appending to the journal
+    compact();
+  }
+
+  void ScheduleStore::compact() {
+    if (live.empty() && !g_file_test(path.data(), G_FILE_TEST_EXISTS)) {
+      // nothing has been recorded yet
+      return;
+    }
+
+    std::string content = Header();
+    std::size_t recordCount = 0;
+    {
+      g_autoptr(GMappedFile) file = g_mapped_file_new(path.data(), FALSE, nullptr);
+      if (file && !live.empty()) {
+        const auto data = g_mapped_file_get_contents(file);
+        LiveRecordMap liveRecords;
+        std::size_t unused = 0;
+        parse(data, g_mapped_file_get_length(file), liveRecords, unused);
+        for (const auto [id, offset] : liveRecords) {
+          if (live.find(id) == live.end()) {
+            continue;
+          }
+          const auto recordSize = ScheduleRecordFixedSize + Get<std::uint32_t>(data + offset + ScheduleRecordFixedSize - sizeof(std::uint32_t));
+          content.append(data + offset, recordSize);
+          ++recordCount;
+        }
+      }
+    }
+
+    g_autofree gchar* directory = g_path_get_dirname(path.data());
+    g_mkdir_with_parents(directory, 0700);
+    // replaces the journal atomically
+    g_autoptr(GError) error = nullptr;
+    if (!g_file_set_contents(path.data(), content.data(), content.size(), &error)) {
+      g_warning("Failed to compact schedule journal %s: %s", path.data(), error->message);
+      return;
+    }
+    if (fd >= 0) {
+      close(std::exchange(fd, -1));
+    }
+    record_count = recordCount;
+  }
+
+  bool ScheduleStore::openForAppend() {
+    if (fd >= 0) {
+      return true;
+    }
+    g_autofree gchar* directory = g_path_get_dirname(path.data());
+    g_mkdir_with_parents(directory, 0700);
+    fd = open(path.data(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0) {
+      g_warning("Failed to open schedule journal %s: %s", path.data(), std::strerror(errno));
+      return false;
+    }
+    if (lseek(fd, 0, SEEK_END) == 0) {
+      const auto header = Header();
+      WriteAll(fd, header.data(), header.size());
+    }
+    return true;
+  }
+
+  void ScheduleStore::append(const std::string& record) {
+    if (!openForAppend()) {
+      return;
+    }
+    if (!WriteAll(fd, record.data(), record.size())) {
+      g_warning("Failed to write schedule journal %s: %s", path.data(), std::strerror(errno));
+      return;
+    }
+    ++record_count;
+  }
+
+  void ScheduleStore::compactIfNeeded() {
+    if (record_count > CompactionThreshold && record_count > live.size() * 2) {
+      compact();
+    }
+  }
+
+  std::string DefaultScheduleStorePath(const char* applicationId) {
+    if (!applicationId) {
+      applicationId = g_get_prgname();
+    }
+    g_autofree gchar* path = g_build_filename(g_get_user_data_dir(), applicationId ? applicationId : "flutter_local_notifications",
+      "flutter_local_notifications", "schedules.journal", nullptr);
+    return path;
+  }
+}
@@ -0,0 +1,95 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_SCHEDULE_STORE_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_SCHEDULE_STORE_H_
+
+#include <flutter_linux/flutter_linux.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace flutter_local_notifications {
+  // Append-only journal of scheduled notifications, so that they survive restarts of the
+  // application.
+  //
+  // The journal starts with a header, followed by records of the form
+  //   op: u8, id: i64
+  // where op is one of Op, and Op::Schedule records continue with
+  //   deadline: i64, repeatInterval: i64, argumentsLength: u32, arguments: u8[argumentsLength]
+  // arguments are the arguments of the method call which scheduled the notification, encoded
+  // with the standard message codec. All values are in host byte order.
+  //
+  // The journal is read through a memory mapping and rewritten with only live records once
+  // most of its records are obsolete.
+  //
+  // The system time zone which schedules follow is kept next to the journal, so that a
+  // change of the zone while the application was not running is noticed.
+  class ScheduleStore {
+  public:
+    using ReplayCallback = std::function<void(std::int64_t id, gint64 deadline, gint64 repeatInterval, FlValue* arguments)>;
+
+    explicit ScheduleStore(std::string path);
+    ~ScheduleStore();
+
+    ScheduleStore(const ScheduleStore&) = delete;
+    ScheduleStore& operator=(const ScheduleStore&) = delete;
+
+    // Calls callback with every schedule which has not been cancelled in one pass over the
+    // journal, returns the number of replayed schedules.
+    std::size_t replay(const ReplayCallback& callback);
+
+    void recordSchedule(std::int64_t id, gint64 deadline, gint64 repeatInterval, FlValue* arguments);
+    void recordCancel(std::int64_t id);
+    void recordCancelAll();
+    // Records schedules which have been moved to the system time zone timeZoneName, with
+    // their new deadline, and timeZoneName as the zone followed by schedules. Their
+    // arguments are recorded again with timeZoneName as their time zone, so that they are
+    // restored in it.
+    void recordMovedToTimeZone(const std::vector<std::pair<std::int64_t, gint64>>& deadlines, const char* timeZoneName);
+
+    // Returns the system time zone recorded by recordTimeZone, or an empty string if none.
+    std::string readTimeZone() const;
+    void recordTimeZone(const char* timeZoneName);
+
+    // Rewrites the journal with only live records.
+    void compact();
+
+    const std::string& getPath() const {
+      return path;
+    }
+
+  private:
+    enum class Op : std::uint8_t {
+      Schedule = 1,
+      Cancel = 2,
+      CancelAll = 3,
+    };
+
+    std::string path;
+    std::string time_zone_path;
+    int fd;
+    FlStandardMessageCodec* codec;
+
+    std::unordered_set<std::int64_t> live;
+    std::size_t record_count;
+
+    // Key: notification id, Value: offset of its latest Op::Schedule record
+    using LiveRecordMap = std::unordered_map<std::int64_t, std::size_t>;
+    // Parses journal content, returns the size of the valid part of it.
+    static std::size_t parse(const char* data, std::size_t size, LiveRecordMap& liveRecords, std::size_t& recordCount);
+
+    static std::string ScheduleRecord(std::int64_t id, gint64 deadline, gint64 repeatInterval, const void* arguments, std::size_t argumentsSize);
+
+    bool openForAppend();
+    void append(const std::string& record);
+    void compactIfNeeded();
+  };
+
+  // Returns the default location of the journal for the application with the given id.
+  std::string DefaultScheduleStorePath(const char* applicationId);
+}
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_SCHEDULE_STORE_H_
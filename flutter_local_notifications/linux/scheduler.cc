@@ -0,0 +1,250 @@
+#include "scheduler.h"
+
+#include <glib-unix.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <limits>
+#include <utility>
+
+namespace flutter_local_notifications {
+  Scheduler::Scheduler(FireCallback onFire, ReanchorCallback onReanchor, const Clock& clock, bool manual)
+    : on_fire(std::move(onFire)), on_reanchor(std::move(onReanchor)), clock(clock), manual(manual),
+      timer_fd(manual ? -1 : timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC)),
+      source_id(0), armed_deadline(0), dispatching(false) {
+    if (manual) {
+      return;
+    }
+    if (timer_fd >= 0) {
+      source_id = g_unix_fd_add(timer_fd, G_IO_IN, [](gint, GIOCondition, gpointer p) -> gboolean {
+        static_cast<Scheduler*>(p)->onTimerFdReadable();
+        return G_SOURCE_CONTINUE;
+      }, this);
+    } else {
+      g_warning("timerfd is not available, scheduled notifications will not follow changes of system clock");
+    }
+  }
+
+  Scheduler::~Scheduler() {
+    if (source_id) {
+      g_source_remove(source_id);
+    }
+    if (timer_fd >= 0) {
+      close(timer_fd);
+    }
+  }
+
+  void Scheduler::schedule(std::int64_t id, gint64 deadline) {
+    const auto iter = indices.find(id);
+    if (iter != indices.end()) {
+      const auto index = iter->second;
+      const auto oldDeadline = heap[index].deadline;
+      heap[index].deadline = deadline;
+      if (deadline < oldDeadline) {
+        siftUp(index);
+      } else {
+        siftDown(index);
+      }
+    } else {
+      heap.push_back(Entry{ deadline, id });
+      indices.emplace(id, heap.size() - 1);
+      siftUp(heap.size() - 1);
+    }
+    rearm();
+  }
+
+  bool Scheduler::cancel(std::int64_t id) {
+    const auto iter = indices.find(id);
+    if (iter == indices.end()) {
+      return false;
+    }
+    removeAt(iter->second);
+    rearm();
+    return true;
+  }
+
+  void Scheduler::cancelAll() {
+    heap.clear();
+    indices.clear();
+    rearm();
+  }
+
+  void Scheduler::reanchorAll() {
+    reanchorAll(on_reanchor);
+  }
+
+  void Scheduler::reanchorAll(const ReanchorCallback& reanchor) {
+    const auto now = clock.now();
+    for (auto& entry : heap) {
+      entry.deadline = reanchor(entry.id, entry.deadline, now);
+    }
+    for (auto i = heap.size() / 2; i > 0; --i) {
+      siftDown(i - 1);
+    }
+    rearm();
+  }
+
+  std::optional<gint64> Scheduler::deadlineOf(std::int64_t id) const {
+    const auto iter = indices.find(id);
+    if (iter == indices.end()) {
+      return std::nullopt;
+    }
+    return heap[iter->second].deadline;
+  }
+
+  void Scheduler::place(std::size_t index, Entry entry) {
+    heap[index] = entry;
+    indices[entry.id] = index;
+  }
+
+  void Scheduler::siftUp(std::size_t index) {
+    const auto entry = heap[index];
+    while (index > 0) {
+      const auto parent = (index - 1) / 2;
+      if (heap[parent].deadline <= entry.deadline) {
+        break;
+      }
+      place(index, heap[parent]);
+      index = parent;
+    }
+    place(index, entry);
+  }
+
+  void Scheduler::siftDown(std::size_t index) {
+    const auto entry = heap[index];
+    const auto size = heap.size();
+    while (true) {
+      auto child = index * 2 + 1;
+      if (child >= size) {
+        break;
+      }
+      if (child + 1 < size && heap[child + 1].deadline < heap[child].deadline) {
+        ++child;
+      }
+      if (entry.deadline <= heap[child].deadline) {
+        break;
+      }
+      place(index, heap[child]);
+      index = child;
+    }
+    place(index, entry);
+  }
+
+  void Scheduler::removeAt(std::size_t index) {
+    assert(index < heap.size());
+    indices.erase(heap[index].id);
+    const auto last = heap.back();
+    heap.pop_back();
+    if (index == heap.size()) {
+      return;
+    }
+    const auto removedDeadline = heap[index].deadline;
+    place(index, last);
+    if (last.deadline < removedDeadline) {
+      siftUp(index);
+    } else {
+      siftDown(index);
+    }
+  }
+
+  void Scheduler::rearm() {
+    if (dispatching || manual) {
+      // dispatch will rearm after all expired tasks are handled, and manual schedulers
+      // are never armed
+      return;
+    }
+    if (timer_fd >= 0) {
+      armTimerFd();
+      return;
+    }
+    if (heap.empty()) {
+      if (source_id) {
+        g_source_remove(std::exchange(source_id, 0));
+      }
+      return;
+    }
+
+    const auto deadline = heap.front().deadline;
+    if (source_id) {
+      if (deadline == armed_deadline) {
+        return;
+      }
+      g_source_remove(std::exchange(source_id, 0));
+    }
+
+    const auto delay = deadline - clock.now();
+    // round up, so that the task never fires before its deadline
+    const auto delayMs = delay > 0 ? (delay + 999) / 1000 : 0;
+    armed_deadline = deadline;
+    source_id = g_timeout_add_full(G_PRIORITY_DEFAULT,
+      static_cast<guint>(std::min<gint64>(delayMs, std::numeric_limits<guint>::max())),
+      [](gpointer p) -> gboolean {
+        const auto self = static_cast<Scheduler*>(p);
+        self->source_id = 0;
+        self->dispatch();
+        return G_SOURCE_REMOVE;
+      }, this, nullptr);
+  }
+
+  void Scheduler::armTimerFd() {
+    itimerspec spec{};
+    if (!heap.empty()) {
+      const auto deadline = std::max<gint64>(heap.front().deadline, 1);
+      spec.it_value.tv_sec = deadline / G_USEC_PER_SEC;
+      spec.it_value.tv_nsec = deadline % G_USEC_PER_SEC * 1000;
+    }
+    // an all-zero it_value disarms the timer
+    if (timerfd_settime(timer_fd, TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET, &spec, nullptr) != 0) {
+      g_warning("Failed to arm scheduler timer: %s", g_strerror(errno));
+    }
+  }
+
+  void Scheduler::onTimerFdReadable() {
+    std::uint64_t expirations;
+    if (read(timer_fd, &expirations, sizeof(expirations)) < 0) {
+      if (errno == ECANCELED) {
+        // the realtime clock has been set, deadlines of repeating tasks may be far away now
+        reanchorAll();
+      }
+      // EAGAIN if the timer has been rearmed since it became readable
+      return;
+    }
+    dispatch();
+  }
+
+  void Scheduler::dispatch() {
+    const auto now = clock.now();
+    dispatching = true;
+    while (!heap.empty() && heap.front().deadline <= now) {
+      const auto [deadline, id] = heap.front();
+      removeAt(0);
+      const auto next = on_fire(id, deadline);
+      // the callback may have rescheduled or cancelled the task by itself
+      if (next && !contains(id)) {
+        heap.push_back(Entry{ *next, id });
+        indices.emplace(id, heap.size() - 1);
+        siftUp(heap.size() - 1);
+      }
+    }
+    dispatching = false;
+    rearm();
+  }
+
+  gint64 NextPeriodicDeadline(gint64 anchor, gint64 interval, gint64 now) {
+    assert(interval > 0);
+    if (anchor > now) {
+      return anchor;
+    }
+    return anchor + ((now - anchor) / interval + 1) * interval;
+  }
+
+  gint64 ReanchorPeriodicDeadline(gint64 deadline, gint64 interval, gint64 now) {
+    assert(interval > 0);
+    if (deadline <= now) {
+      return deadline;
+    }
+    return deadline - (deadline - now - 1) / interval * interval;
+  }
+}
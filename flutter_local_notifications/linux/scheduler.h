@@ -0,0 +1,114 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_SCHEDULER_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_SCHEDULER_H_
+
+#include <glib.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "clock.h"
+
+namespace flutter_local_notifications {
+  // Keeps every scheduled task in an indexed binary min-heap keyed by its absolute
+  // deadline (microseconds of real time, see g_get_real_time), and arms exactly one
+  // GLib source for the earliest deadline.
+  // schedule, cancel and firing a task are O(log n).
+  //
+  // The source is a CLOCK_REALTIME timerfd armed with the absolute deadline, so that tasks
+  // fire on their wall-clock deadline regardless of how long they have been waiting, and
+  // changes of the system clock are noticed, see ReanchorCallback.
+  //
+  // A manual scheduler arms no source, its due tasks fire only when fireDue is called,
+  // which lets a simulation drive it with a VirtualClock as fast as it can.
+  class Scheduler {
+  public:
+    // Invoked once the deadline of a task has passed. Returns the next deadline of the
+    // task if it repeats, or std::nullopt to drop it.
+    using FireCallback = std::function<std::optional<gint64>(std::int64_t id, gint64 deadline)>;
+    // Invoked for every task when the system clock has been changed discontinuously,
+    // returns the new deadline of the task.
+    using ReanchorCallback = std::function<gint64(std::int64_t id, gint64 deadline, gint64 now)>;
+
+    Scheduler(FireCallback onFire, ReanchorCallback onReanchor, const Clock& clock, bool manual = false);
+    ~Scheduler();
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    // Schedules id at deadline, replacing the previous deadline if id is already scheduled.
+    void schedule(std::int64_t id, gint64 deadline);
+    bool cancel(std::int64_t id);
+    void cancelAll();
+
+    // Recomputes the deadline of every task with the ReanchorCallback in one pass, and
+    // restores the heap order in O(n).
+    void reanchorAll();
+    // Like reanchorAll, with reanchor instead of the ReanchorCallback, for other reasons
+    // to move deadlines in bulk, like a change of the system time zone.
+    void reanchorAll(const ReanchorCallback& reanchor);
+
+    bool contains(std::int64_t id) const {
+      return indices.find(id) != indices.end();
+    }
+
+    std::optional<gint64> deadlineOf(std::int64_t id) const;
+
+    std::optional<gint64> nextDeadline() const {
+      return heap.empty() ? std::nullopt : std::optional{ heap.front().deadline };
+    }
+
+    // Fires every task whose deadline has passed by the time of clock.
+    void fireDue() {
+      dispatch();
+    }
+
+    std::size_t size() const {
+      return heap.size();
+    }
+
+  private:
+    struct Entry {
+      gint64 deadline;
+      std::int64_t id;
+    };
+
+    FireCallback on_fire;
+    ReanchorCallback on_reanchor;
+    const Clock& clock;
+    const bool manual;
+    std::vector<Entry> heap;
+    // Key: task id, Value: index in heap
+    std::unordered_map<std::int64_t, std::size_t> indices;
+
+    // -1 if timerfd is not available, in which case a GLib timeout is used, which cannot
+    // tell clock changes
+    int timer_fd;
+    guint source_id;
+    gint64 armed_deadline;
+    bool dispatching;
+
+    void place(std::size_t index, Entry entry);
+    void siftUp(std::size_t index);
+    void siftDown(std::size_t index);
+    void removeAt(std::size_t index);
+
+    void rearm();
+    void armTimerFd();
+    void onTimerFdReadable();
+    void dispatch();
+  };
+
+  // Returns the first deadline after now of a task which started at anchor and repeats
+  // every interval microseconds, skipping occurrences which have been missed.
+  gint64 NextPeriodicDeadline(gint64 anchor, gint64 interval, gint64 now);
+
+  // Returns the earliest deadline after now of a task which repeats every interval
+  // microseconds and is due at deadline, used after the clock has been set back.
+  // Deadlines which have passed are kept, so that the task fires at once.
+  gint64 ReanchorPeriodicDeadline(gint64 deadline, gint64 interval, gint64 now);
+}
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_SCHEDULER_H_
@@ -0,0 +1,181 @@
+#include "scheduler_helper_client.h"
+
+#include <utility>
+
+#include "scheduler_helper_protocol.h"
+
+namespace flutter_local_notifications {
+  namespace {
+    // Returns the path of the executable of the process, empty if it is not known.
+    std::string ExecutablePath() {
+      g_autofree gchar* path = g_file_read_link("/proc/self/exe", nullptr);
+      return path ? path : "";
+    }
+  }
+
+  SchedulerHelperClient::SchedulerHelperClient(const std::string& application, std::string appName, std::string desktopEntry,
+    SelectedCallback onSelected, FiredCallback onFired, AttachedCallback onAttached)
+    : bus_name(SchedulerHelperBusName(application.empty() ? ExecutablePath() : application)),
+      app_name(std::move(appName)), desktop_entry(std::move(desktopEntry)),
+      on_selected(std::move(onSelected)), on_fired(std::move(onFired)), on_attached(std::move(onAttached)),
+      cancellable(g_cancellable_new()) {
+    g_autoptr(GError) error = nullptr;
+    connection = g_bus_get_sync(G_BUS_TYPE_SESSION, cancellable, &error);
+    if (!connection) {
+      g_warning("Failed to connect to the session bus, scheduled notifications only fire while the app runs: %s", error->message);
+      return;
+    }
+    selected_subscription = g_dbus_connection_signal_subscribe(connection, bus_name.data(), SchedulerHelperInterface, "Selected",
+      SchedulerHelperObjectPath, nullptr, G_DBUS_SIGNAL_FLAGS_NONE,
+      [](GDBusConnection* connection, const gchar* sender, const gchar* path, const gchar* interface, const gchar* signal,
+        GVariant* parameters, gpointer data) {
+        std::int64_t id;
+        const gchar* payload;
+        gint32 button;
+        g_variant_get(parameters, "(x&si)", &id, &payload, &button);
+        static_cast<SchedulerHelperClient*>(data)->on_selected(id, payload, button);
+      }, this, nullptr);
+  }
+
+  SchedulerHelperClient::~SchedulerHelperClient() {
+    // pending callbacks see the cancellation and do not touch this anymore
+    g_cancellable_cancel(cancellable);
+    if (connection) {
+      if (watch_id) {
+        g_bus_unwatch_name(watch_id);
+      }
+      g_dbus_connection_signal_unsubscribe(connection, selected_subscription);
+      g_object_unref(connection);
+    }
+    g_object_unref(cancellable);
+  }
+
+  void SchedulerHelperClient::attach() {
+    if (!connection || watch_id) {
+      return;
+    }
+    // does not start the helper through D-Bus activation, which knows nothing about it
+    g_autoptr(GVariant) reply = g_dbus_connection_call_sync(connection, bus_name.data(), SchedulerHelperObjectPath,
+      SchedulerHelperInterface, "Attach", nullptr, G_VARIANT_TYPE("(a(xsi))"),
+      G_DBUS_CALL_FLAGS_NO_AUTO_START, -1, cancellable, nullptr);
+    if (reply) {
+      onAttachReply(reply);
+    } else {
+      // left behind by a helper which exited
+      takeFired();
+    }
+    watch_id = g_bus_watch_name_on_connection(connection, bus_name.data(), G_BUS_NAME_WATCHER_FLAGS_NONE,
+      onNameAppeared, onNameVanished, this, nullptr);
+    if (!reply) {
+      spawnHelper();
+    }
+  }
+
+  void SchedulerHelperClient::schedule(std::int64_t id, gint64 deadline, gint64 repeatInterval,
+    const std::optional<Recurrence>& recurrence, const FdoNotification& content) {
+    if (!attached) {
+      return;
+    }
+    call("Schedule", HelperScheduleToVariant(id, deadline, repeatInterval, recurrence, content));
+  }
+
+  void SchedulerHelperClient::cancel(std::int64_t id) {
+    if (!attached) {
+      return;
+    }
+    call("Cancel", g_variant_new("(x)", id));
+  }
+
+  void SchedulerHelperClient::cancelAll() {
+    if (!attached) {
+      return;
+    }
+    call("CancelAll", nullptr);
+  }
+
+  // Once attached, the helper does not fire anymore, so nothing is recorded after the ids are taken.
+  void SchedulerHelperClient::onAttachReply(GVariant* reply) {
+    attached = true;
+    takeFired();
+    g_autoptr(GVariantIter) selections = nullptr;
+    g_variant_get(reply, "(a(xsi))", &selections);
+    std::int64_t id;
+    const gchar* payload;
+    gint32 button;
+    while (g_variant_iter_next(selections, "(x&si)", &id, &payload, &button)) {
+      on_selected(id, payload, button);
+    }
+    on_attached();
+  }
+
+  void SchedulerHelperClient::takeFired() {
+    for (const auto id : TakeHelperFired(bus_name)) {
+      on_fired(id);
+    }
+  }
+
+  void SchedulerHelperClient::spawnHelper() {
+    const auto executable = ExecutablePath();
+    if (spawned || executable.empty()) {
+      return;
+    }
+    // installed into the lib directory of the bundle, next to the plugin
+    g_autofree gchar* directory = g_path_get_dirname(executable.data());
+    g_autofree gchar* path = g_build_filename(directory, "lib", SchedulerHelperExecutable, nullptr);
+    gchar* argv[] = {
+      path,
+      const_cast<gchar*>(bus_name.data()),
+      const_cast<gchar*>(app_name.data()),
+      const_cast<gchar*>(desktop_entry.data()),
+      nullptr,
+    };
+    g_autoptr(GError) error = nullptr;
+    if (!g_spawn_async(nullptr, argv, nullptr, G_SPAWN_DEFAULT, nullptr, nullptr, nullptr, &error)) {
+      g_warning("Failed to start the scheduler helper %s: %s", path, error->message);
+      return;
+    }
+    spawned = true;
+  }
+
+  void SchedulerHelperClient::call(const gchar* method, GVariant* parameters) {
+    g_dbus_connection_call(connection, bus_name.data(), SchedulerHelperObjectPath, SchedulerHelperInterface, method,
+      parameters, nullptr, G_DBUS_CALL_FLAGS_NO_AUTO_START, -1, cancellable,
+      [](GObject* source, GAsyncResult* result, gpointer data) {
+        g_autoptr(GError) error = nullptr;
+        g_autoptr(GVariant) reply = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), result, &error);
+        if (!reply && !g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+          g_warning("Call to the scheduler helper failed: %s", error->message);
+        }
+      }, nullptr);
+  }
+
+  void SchedulerHelperClient::onNameAppeared(GDBusConnection* connection, const gchar* name, const gchar* owner, gpointer data) {
+    const auto self = static_cast<SchedulerHelperClient*>(data);
+    if (self->attached) {
+      return;
+    }
+    g_dbus_connection_call(connection, name, SchedulerHelperObjectPath, SchedulerHelperInterface, "Attach",
+      nullptr, G_VARIANT_TYPE("(a(xsi))"), G_DBUS_CALL_FLAGS_NO_AUTO_START, -1, self->cancellable,
+      [](GObject* source, GAsyncResult* result, gpointer data) {
+        g_autoptr(GError) error = nullptr;
+        g_autoptr(GVariant) reply = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), result, &error);
+        if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+          return;
+        }
+        if (!reply) {
+          g_warning("Failed to attach to the scheduler helper: %s", error->message);
+          return;
+        }
+        static_cast<SchedulerHelperClient*>(data)->onAttachReply(reply);
+      }, self);
+  }
+
+  // The helper only exits by itself while detached, so it has crashed or been killed.
+  void SchedulerHelperClient::onNameVanished(GDBusConnection* connection, const gchar* name, gpointer data) {
+    const auto self = static_cast<SchedulerHelperClient*>(data);
+    if (std::exchange(self->attached, false)) {
+      self->spawned = false;
+      self->spawnHelper();
+    }
+  }
+}
@@ -0,0 +1,77 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_SCHEDULER_HELPER_CLIENT_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_SCHEDULER_HELPER_CLIENT_H_
+
+#include <gio/gio.h>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+
+#include "fdo_backend.h"
+#include "recurrence.h"
+
+namespace flutter_local_notifications {
+  // Mirrors the pending notifications of the plugin to the scheduler helper of the
+  // application, see scheduler_helper_protocol.h, and starts the helper if it is not running.
+  // Calls are asynchronous, and dropped while the helper is not attached.
+  class SchedulerHelperClient {
+  public:
+    // button is the index of the button, -1 for the default action.
+    using SelectedCallback = std::function<void(std::int64_t id, const std::string& payload, gint32 button)>;
+    // Invoked for every notification which fired for the last time while the application
+    // was not running.
+    using FiredCallback = std::function<void(std::int64_t id)>;
+    // Invoked once attached to the helper, which expects every pending notification to be
+    // scheduled again.
+    using AttachedCallback = std::function<void()>;
+
+    // application is the application id, if it is empty the path of the executable is used.
+    SchedulerHelperClient(const std::string& application, std::string appName, std::string desktopEntry,
+      SelectedCallback onSelected, FiredCallback onFired, AttachedCallback onAttached);
+    ~SchedulerHelperClient();
+
+    SchedulerHelperClient(const SchedulerHelperClient&) = delete;
+    SchedulerHelperClient& operator=(const SchedulerHelperClient&) = delete;
+
+    // Attaches to the helper synchronously if it is running, so that notifications which
+    // fired meanwhile are known before pending ones are restored, or starts it otherwise.
+    void attach();
+
+    void schedule(std::int64_t id, gint64 deadline, gint64 repeatInterval, const std::optional<Recurrence>& recurrence,
+      const FdoNotification& content);
+    void cancel(std::int64_t id);
+    void cancelAll();
+
+    bool isAttached() const {
+      return attached;
+    }
+
+  private:
+    const std::string bus_name;
+    const std::string app_name;
+    const std::string desktop_entry;
+    SelectedCallback on_selected;
+    FiredCallback on_fired;
+    AttachedCallback on_attached;
+
+    GCancellable* cancellable;
+    // null if the session bus is not available
+    GDBusConnection* connection = nullptr;
+    guint selected_subscription = 0;
+    guint watch_id = 0;
+    bool attached = false;
+    // the helper is only started again once it has been attached, so that a helper which
+    // fails to start is not restarted forever
+    bool spawned = false;
+
+    void onAttachReply(GVariant* reply);
+    void takeFired();
+    void spawnHelper();
+    void call(const gchar* method, GVariant* parameters);
+
+    static void onNameAppeared(GDBusConnection* connection, const gchar* name, const gchar* owner, gpointer data);
+    static void onNameVanished(GDBusConnection* connection, const gchar* name, gpointer data);
+  };
+}
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_SCHEDULER_HELPER_CLIENT_H_
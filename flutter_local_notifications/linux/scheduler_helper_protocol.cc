@@ -0,0 +1,195 @@
+#include "scheduler_helper_protocol.h"
+
+#include <glib/gstdio.h>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <string_view>
+
+namespace flutter_local_notifications {
+  const char SchedulerHelperIntrospectionXml[] =
+    "<node>"
+    "  <interface name='com.dexterous.FlutterLocalNotifications.Scheduler'>"
+    "    <method name='Attach'>"
+    "      <arg type='a(xsi)' name='selections' direction='out'/>"
+    "    </method>"
+    "    <method name='Schedule'>"
+    "      <arg type='x' name='id' direction='in'/>"
+    "      <arg type='x' name='deadline' direction='in'/>"
+    "      <arg type='x' name='repeatInterval' direction='in'/>"
+    "      <arg type='a{sv}' name='recurrence' direction='in'/>"
+    "      <arg type='a{sv}' name='content' direction='in'/>"
+    "    </method>"
+    "    <method name='Cancel'>"
+    "      <arg type='x' name='id' direction='in'/>"
+    "    </method>"
+    "    <method name='CancelAll'/>"
+    "    <signal name='Selected'>"
+    "      <arg type='x' name='id'/>"
+    "      <arg type='s' name='payload'/>"
+    "      <arg type='i' name='button'/>"
+    "    </signal>"
+    "  </interface>"
+    "</node>";
+
+  std::string SchedulerHelperBusName(const std::string& application) {
+    // application ids may contain characters which bus names may not, e.g. '-'
+    const auto hash = std::hash<std::string_view>{}(application);
+    g_autofree gchar* name = g_strdup_printf("%s.App_%016" G_GINT64_MODIFIER "x", SchedulerHelperInterface, static_cast<guint64>(hash));
+    return name;
+  }
+
+  namespace {
+    // One decimal id per line, named after the bus name so that each application has its own.
+    std::string FiredPath(const std::string& busName) {
+      g_autofree gchar* name = g_strconcat(busName.data(), ".fired", nullptr);
+      g_autofree gchar* path = g_build_filename(g_get_user_data_dir(), "flutter_local_notifications", name, nullptr);
+      return path;
+    }
+  }
+
+  void RecordHelperFired(const std::string& busName, std::int64_t id) {
+    const auto path = FiredPath(busName);
+    g_autofree gchar* directory = g_path_get_dirname(path.data());
+    if (g_mkdir_with_parents(directory, 0700) != 0) {
+      g_warning("Failed to create %s: %s", directory, g_strerror(errno));
+      return;
+    }
+    g_autofree gchar* line = g_strdup_printf("%" G_GINT64_FORMAT "\n", id);
+    g_autoptr(GFile) file = g_file_new_for_path(path.data());
+    g_autoptr(GError) error = nullptr;
+    g_autoptr(GFileOutputStream) stream = g_file_append_to(file, G_FILE_CREATE_PRIVATE, nullptr, &error);
+    if (!stream || !g_output_stream_write_all(G_OUTPUT_STREAM(stream), line, std::strlen(line), nullptr, nullptr, &error)) {
+      g_warning("Failed to record fired notification %" G_GINT64_FORMAT " in %s: %s", id, path.data(), error->message);
+    }
+  }
+
+  std::vector<std::int64_t> TakeHelperFired(const std::string& busName) {
+    const auto path = FiredPath(busName);
+    g_autofree gchar* contents = nullptr;
+    if (!g_file_get_contents(path.data(), &contents, nullptr, nullptr)) {
+      return {};
+    }
+    g_remove(path.data());
+
+    std::vector<std::int64_t> ids;
+    g_auto(GStrv) lines = g_strsplit(contents, "\n", -1);
+    // the last part is not terminated, it is empty unless the helper was killed while writing
+    for (auto line = lines; line[0] && line[1]; ++line) {
+      gint64 id;
+      if (g_ascii_string_to_signed(*line, 10, G_MININT64, G_MAXINT64, &id, nullptr)) {
+        ids.push_back(id);
+      }
+    }
+    return ids;
+  }
+
+  GVariant* HelperScheduleToVariant(std::int64_t id, gint64 deadline, gint64 repeatInterval,
+    const std::optional<Recurrence>& recurrence, const FdoNotification& notification) {
+    GVariantBuilder recurrenceBuilder;
+    g_variant_builder_init(&recurrenceBuilder, G_VARIANT_TYPE("a{sv}"));
+#if GLIB_CHECK_VERSION(2, 58, 0)
+    if (recurrence) {
+      const auto& rule = recurrence->getRule();
+      g_variant_builder_add(&recurrenceBuilder, "{sv}", "timeZone", g_variant_new_string(g_time_zone_get_identifier(recurrence->getTimeZone())));
+      g_variant_builder_add(&recurrenceBuilder, "{sv}", "startDay", g_variant_new_int64(recurrence->getStartDay()));
+      g_variant_builder_add(&recurrenceBuilder, "{sv}", "startTimeOfDay", g_variant_new_int32(recurrence->getStartTimeOfDay()));
+      g_variant_builder_add(&recurrenceBuilder, "{sv}", "frequency", g_variant_new_byte(static_cast<guint8>(rule.frequency)));
+      g_variant_builder_add(&recurrenceBuilder, "{sv}", "interval", g_variant_new_uint16(rule.interval));
+      g_variant_builder_add(&recurrenceBuilder, "{sv}", "weekdays", g_variant_new_byte(rule.weekdays));
+      g_variant_builder_add(&recurrenceBuilder, "{sv}", "weekOfMonth", g_variant_new_int16(rule.weekOfMonth));
+      g_variant_builder_add(&recurrenceBuilder, "{sv}", "endOfDay", g_variant_new_int32(rule.endOfDay));
+      g_variant_builder_add(&recurrenceBuilder, "{sv}", "until", g_variant_new_int64(rule.until));
+    }
+#endif
+
+    GVariantBuilder content;
+    g_variant_builder_init(&content, G_VARIANT_TYPE("a{sv}"));
+    g_variant_builder_add(&content, "{sv}", "summary", g_variant_new_string(notification.summary.data()));
+    g_variant_builder_add(&content, "{sv}", "body", g_variant_new_string(notification.body.data()));
+    g_variant_builder_add(&content, "{sv}", "payload", g_variant_new_string(notification.payload.data()));
+    g_variant_builder_add(&content, "{sv}", "priority", g_variant_new_int32(static_cast<gint32>(notification.priority)));
+    if (notification.icon) {
+      if (g_autoptr(GVariant) icon = g_icon_serialize(notification.icon.get())) {
+        g_variant_builder_add(&content, "{sv}", "icon", icon);
+      }
+    }
+    if (!notification.buttons.empty()) {
+      GVariantBuilder buttons;
+      g_variant_builder_init(&buttons, G_VARIANT_TYPE("a(ss)"));
+      for (const auto& button : notification.buttons) {
+        g_variant_builder_add(&buttons, "(ss)", button.label.data(), button.payload.data());
+      }
+      g_variant_builder_add(&content, "{sv}", "buttons", g_variant_builder_end(&buttons));
+    }
+
+    return g_variant_new("(xxxa{sv}a{sv})", id, deadline, repeatInterval, &recurrenceBuilder, &content);
+  }
+
+  bool HelperScheduleFromVariant(GVariant* parameters, TimeZoneCache& timeZones, HelperSchedule& schedule) {
+    if (!g_variant_is_of_type(parameters, G_VARIANT_TYPE("(xxxa{sv}a{sv})"))) {
+      return false;
+    }
+    g_autoptr(GVariant) recurrenceValue = nullptr;
+    g_autoptr(GVariant) contentValue = nullptr;
+    g_variant_get(parameters, "(xxx@a{sv}@a{sv})", &schedule.id, &schedule.deadline, &schedule.repeatInterval,
+      &recurrenceValue, &contentValue);
+
+    g_auto(GVariantDict) recurrence;
+    g_variant_dict_init(&recurrence, recurrenceValue);
+    const gchar* timeZone;
+    if (g_variant_dict_lookup(&recurrence, "timeZone", "&s", &timeZone)) {
+      RecurrenceRule rule;
+      gint64 startDay = 0;
+      gint32 startTimeOfDay = 0;
+      guint8 frequency = 0;
+      if (!g_variant_dict_lookup(&recurrence, "startDay", "x", &startDay)
+          || !g_variant_dict_lookup(&recurrence, "startTimeOfDay", "i", &startTimeOfDay)
+          || !g_variant_dict_lookup(&recurrence, "frequency", "y", &frequency)
+          || frequency > static_cast<guint8>(RecurrenceRule::Frequency::Monthly)) {
+        return false;
+      }
+      rule.frequency = static_cast<RecurrenceRule::Frequency>(frequency);
+      g_variant_dict_lookup(&recurrence, "interval", "q", &rule.interval);
+      g_variant_dict_lookup(&recurrence, "weekdays", "y", &rule.weekdays);
+      gint16 weekOfMonth = 0;
+      if (g_variant_dict_lookup(&recurrence, "weekOfMonth", "n", &weekOfMonth)) {
+        rule.weekOfMonth = static_cast<gint8>(weekOfMonth);
+      }
+      g_variant_dict_lookup(&recurrence, "endOfDay", "i", &rule.endOfDay);
+      g_variant_dict_lookup(&recurrence, "until", "x", &rule.until);
+      schedule.recurrence.emplace(rule, timeZones.get(timeZone), startDay, startTimeOfDay);
+    }
+
+    auto& notification = schedule.content;
+    g_auto(GVariantDict) content;
+    g_variant_dict_init(&content, contentValue);
+    const gchar* value;
+    if (g_variant_dict_lookup(&content, "summary", "&s", &value)) {
+      notification.summary = value;
+    }
+    if (g_variant_dict_lookup(&content, "body", "&s", &value)) {
+      notification.body = value;
+    }
+    if (g_variant_dict_lookup(&content, "payload", "&s", &value)) {
+      notification.payload = value;
+    }
+    gint32 priority;
+    if (g_variant_dict_lookup(&content, "priority", "i", &priority)) {
+      notification.priority = static_cast<NotificationPriority>(priority);
+    }
+    if (g_autoptr(GVariant) icon = g_variant_dict_lookup_value(&content, "icon", nullptr)) {
+      notification.icon.reset(g_icon_deserialize(icon));
+    }
+    if (g_autoptr(GVariant) buttons = g_variant_dict_lookup_value(&content, "buttons", G_VARIANT_TYPE("a(ss)"))) {
+      GVariantIter iter;
+      g_variant_iter_init(&iter, buttons);
+      const gchar* label;
+      const gchar* payload;
+      while (g_variant_iter_next(&iter, "(&s&s)", &label, &payload)) {
+        notification.buttons.push_back({ label, payload });
+      }
+    }
+    return true;
+  }
+}
@@ -0,0 +1,64 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_SCHEDULER_HELPER_PROTOCOL_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_SCHEDULER_HELPER_PROTOCOL_H_
+
+#include <gio/gio.h>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "fdo_backend.h"
+#include "recurrence.h"
+
+// D-Bus interface between the plugin and the scheduler helper, an executable which fires
+// the scheduled notifications of an application while it is not running.
+//
+// The plugin attaches to the helper and mirrors its pending notifications to it. The helper
+// keeps them without firing while the D-Bus connection of the plugin which attached last is
+// alive, and fires them itself through org.freedesktop.Notifications once it is gone.
+// Selections of notifications sent by the helper are signalled to the attached plugin, or
+// kept until the application, which the helper launches, attaches again. Notifications
+// which the helper fired for the last time are recorded in a file, which the plugin takes
+// once it attaches, so that they are not lost if the helper exits before.
+//
+// Only processes of the user of the helper may attach, and only the plugin attached last
+// may change the schedules. The application launched is the executable of the process
+// which attached, as told by the bus.
+namespace flutter_local_notifications {
+  inline constexpr const char SchedulerHelperObjectPath[] = "/com/dexterous/FlutterLocalNotifications/Scheduler";
+  inline constexpr const char SchedulerHelperInterface[] = "com.dexterous.FlutterLocalNotifications.Scheduler";
+  inline constexpr const char SchedulerHelperExecutable[] = "flutter_local_notifications_scheduler";
+
+  // Introspection data of SchedulerHelperInterface.
+  extern const char SchedulerHelperIntrospectionXml[];
+
+  // Name owned by the helper of the application, which is identified by its application id
+  // or, without one, by the path of its executable.
+  std::string SchedulerHelperBusName(const std::string& application);
+
+  // Records that the helper owning busName fired id for the last time.
+  void RecordHelperFired(const std::string& busName, std::int64_t id);
+  // Returns the notifications recorded by RecordHelperFired and forgets them.
+  std::vector<std::int64_t> TakeHelperFired(const std::string& busName);
+
+  // A notification pending in the helper. Recurrences refer to a time zone which the
+  // decoder provides, so that it outlives them.
+  struct HelperSchedule {
+    std::int64_t id;
+    // in microseconds of real time
+    gint64 deadline;
+    // in microseconds, 0 if the notification fires once
+    gint64 repeatInterval;
+    std::optional<Recurrence> recurrence;
+    FdoNotification content;
+  };
+
+  // Arguments of the Schedule method, of type (xxxa{sv}a{sv}).
+  GVariant* HelperScheduleToVariant(std::int64_t id, gint64 deadline, gint64 repeatInterval,
+    const std::optional<Recurrence>& recurrence, const FdoNotification& content);
+  // The time zone of the recurrence of schedule is taken from timeZones. Returns false if
+  // parameters are malformed.
+  bool HelperScheduleFromVariant(GVariant* parameters, TimeZoneCache& timeZones, HelperSchedule& schedule);
+}
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_SCHEDULER_HELPER_PROTOCOL_H_
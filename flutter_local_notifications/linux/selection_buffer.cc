@@ -0,0 +1,80 @@
+#include "selection_buffer.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace flutter_local_notifications {
+  SelectionBuffer::SelectionBuffer(std::size_t capacity, DeliverCallback deliver)
+    : deliver(std::move(deliver)), ring(std::max<std::size_t>(capacity, 1)) {
+  }
+
+  SelectionBuffer::~SelectionBuffer() {
+    if (idle_source_id) {
+      g_source_remove(idle_source_id);
+    }
+  }
+
+  void SelectionBuffer::push(std::int64_t id, const char* payload, gint32 button) {
+    ++stats.received;
+    if (count == ring.size()) {
+      // overwrite the oldest selection
+      head = (head + 1) % ring.size();
+      --count;
+      ++stats.dropped;
+    }
+    auto& selection = ring[(head + count) % ring.size()];
+    selection.id = id;
+    // reuses the storage of the selection overwritten
+    selection.payload.assign(payload ? payload : "");
+    selection.button = button;
+    ++count;
+    arm();
+  }
+
+  void SelectionBuffer::setListening(bool value) {
+    listening = value;
+    if (!listening && idle_source_id) {
+      g_source_remove(std::exchange(idle_source_id, 0));
+    }
+    arm();
+  }
+
+  void SelectionBuffer::arm() {
+    if (idle_source_id || !listening || count == 0) {
+      return;
+    }
+    idle_source_id = g_idle_add_full(G_PRIORITY_DEFAULT, [](gpointer p) -> gboolean {
+      const auto self = static_cast<SelectionBuffer*>(p);
+      self->idle_source_id = 0;
+      self->flush();
+      return G_SOURCE_REMOVE;
+    }, this, nullptr);
+  }
+
+  void SelectionBuffer::flush() {
+    if (count == 0) {
+      return;
+    }
+    std::vector<std::int64_t> ids;
+    std::vector<std::int32_t> buttons;
+    ids.reserve(count);
+    buttons.reserve(count);
+    g_autoptr(FlValue) payloads = fl_value_new_list();
+    for (std::size_t i = 0; i < count; ++i) {
+      const auto& selection = ring[(head + i) % ring.size()];
+      ids.push_back(selection.id);
+      buttons.push_back(selection.button);
+      fl_value_append_take(payloads, fl_value_new_string(selection.payload.data()));
+    }
+    stats.delivered += count;
+    ++stats.batches;
+    head = 0;
+    count = 0;
+
+    g_autoptr(FlValue) batch = fl_value_new_map();
+    fl_value_set_string_take(batch, "ids", fl_value_new_int64_list(ids.data(), ids.size()));
+    fl_value_set_string(batch, "payloads", payloads);
+    fl_value_set_string_take(batch, "buttons", fl_value_new_int32_list(buttons.data(), buttons.size()));
+    deliver(batch);
+  }
+}
@@ -0,0 +1,70 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_SELECTION_BUFFER_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_SELECTION_BUFFER_H_
+
+#include <flutter_linux/flutter_linux.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace flutter_local_notifications {
+  // A notification, or one of its buttons, activated by the user.
+  struct Selection {
+    std::int64_t id;
+    std::string payload;
+    // index of the button, -1 for the notification itself
+    gint32 button;
+  };
+
+  // Buffers selections until they can be delivered, and delivers the ones received in the
+  // same main loop iteration together. Selections received while not listening are kept,
+  // the oldest ones are dropped once capacity is reached.
+  class SelectionBuffer {
+  public:
+    // batch is a map of the lists "ids", "payloads" and "buttons", with one element per
+    // selection in order of arrival.
+    using DeliverCallback = std::function<void(FlValue* batch)>;
+
+    struct Stats {
+      std::uint64_t received;
+      std::uint64_t delivered;
+      std::uint64_t dropped;
+      std::uint64_t batches;
+    };
+
+    SelectionBuffer(std::size_t capacity, DeliverCallback deliver);
+    ~SelectionBuffer();
+
+    SelectionBuffer(const SelectionBuffer&) = delete;
+    SelectionBuffer& operator=(const SelectionBuffer&) = delete;
+
+    void push(std::int64_t id, const char* payload, gint32 button);
+    // Selections are delivered from the main loop while listening.
+    void setListening(bool value);
+
+    std::size_t size() const {
+      return count;
+    }
+
+    const Stats& getStats() const {
+      return stats;
+    }
+
+  private:
+    DeliverCallback deliver;
+    bool listening = false;
+    Stats stats = {};
+
+    // ring of selections, the oldest one is at head
+    std::vector<Selection> ring;
+    std::size_t head = 0;
+    std::size_t count = 0;
+    guint idle_source_id = 0;
+
+    void arm();
+    void flush();
+  };
+}
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_SELECTION_BUFFER_H_
@@ -0,0 +1,14 @@
+#include "simulation.h"
+
+namespace flutter_local_notifications {
+  std::size_t Simulation::advance(Scheduler& scheduler, gint64 until) {
+    const auto firesBefore = fires.size();
+    for (auto next = scheduler.nextDeadline(); next && *next <= until; next = scheduler.nextDeadline()) {
+      // deadlines in the past fire at the current time, like late timers do
+      clock.advanceTo(*next);
+      scheduler.fireDue();
+    }
+    clock.advanceTo(until);
+    return fires.size() - firesBefore;
+  }
+}
@@ -0,0 +1,72 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_SIMULATION_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_SIMULATION_H_
+
+#include <glib.h>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "clock.h"
+#include "scheduler.h"
+
+namespace flutter_local_notifications {
+  // Runs a manual Scheduler on virtual time, and records every fire instead of sending
+  // notifications, so that months of schedules can be checked in seconds.
+  class Simulation {
+  public:
+    struct Fire {
+      std::int64_t id;
+      // deadline the notification was scheduled for
+      gint64 intended;
+      // virtual time the notification was fired at
+      gint64 actual;
+    };
+
+    explicit Simulation(gint64 startTime) : clock(startTime) {
+    }
+
+    VirtualClock& getClock() {
+      return clock;
+    }
+
+    // Moves virtual time to until, firing every task of scheduler which is due meanwhile
+    // in deadline order. Returns the number of fires.
+    std::size_t advance(Scheduler& scheduler, gint64 until);
+
+    // Moves virtual time to until without firing anything, as if the system was suspended
+    // meanwhile.
+    void suspend(gint64 until) {
+      clock.advanceTo(until);
+    }
+
+    void recordFire(std::int64_t id, gint64 intended) {
+      fires.push_back(Fire{ id, intended, clock.now() });
+    }
+
+    void recordSend() {
+      ++sent;
+    }
+
+    // Number of fires recorded and not taken yet.
+    std::size_t recordedFires() const {
+      return fires.size();
+    }
+
+    // Fires recorded since the last call.
+    std::vector<Fire> takeFires() {
+      return std::exchange(fires, {});
+    }
+
+    std::uint64_t getSent() const {
+      return sent;
+    }
+
+  private:
+    VirtualClock clock;
+    std::vector<Fire> fires;
+    std::uint64_t sent = 0;
+  };
+}
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_SIMULATION_H_
@@ -0,0 +1,54 @@
+#include "sleep_monitor.h"
+
+#include <utility>
+
+namespace flutter_local_notifications {
+  namespace {
+    inline constexpr const char BusName[] = "org.freedesktop.login1";
+    inline constexpr const char ObjectPath[] = "/org/freedesktop/login1";
+    inline constexpr const char InterfaceName[] = "org.freedesktop.login1.Manager";
+  }
+
+  SleepMonitor::SleepMonitor(ResumeCallback onResume)
+    : on_resume(std::move(onResume)), cancellable(g_cancellable_new()) {
+    g_bus_get(G_BUS_TYPE_SYSTEM, cancellable, onBusReady, this);
+  }
+
+  SleepMonitor::~SleepMonitor() {
+    // pending callbacks see the cancellation and do not touch this anymore
+    g_cancellable_cancel(cancellable);
+    if (connection) {
+      g_dbus_connection_signal_unsubscribe(connection, subscription);
+      g_object_unref(connection);
+    }
+    g_object_unref(cancellable);
+  }
+
+  void SleepMonitor::onBusReady(GObject* source, GAsyncResult* result, gpointer data) {
+    g_autoptr(GError) error = nullptr;
+    const auto connection = g_bus_get_finish(result, &error);
+    if (!connection) {
+      if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        g_debug("Failed to connect to system bus, resumes from suspend will not be noticed: %s", error->message);
+      }
+      return;
+    }
+
+    const auto self = static_cast<SleepMonitor*>(data);
+    self->connection = connection;
+    self->subscription = g_dbus_connection_signal_subscribe(connection, BusName, InterfaceName, "PrepareForSleep",
+      ObjectPath, nullptr, G_DBUS_SIGNAL_FLAGS_NONE, onSignal, self, nullptr);
+  }
+
+  void SleepMonitor::onSignal(GDBusConnection* connection, const gchar* sender, const gchar* path, const gchar* interface,
+    const gchar* signal, GVariant* parameters, gpointer data) {
+    if (!g_variant_is_of_type(parameters, G_VARIANT_TYPE("(b)"))) {
+      return;
+    }
+    gboolean sleeping;
+    g_variant_get(parameters, "(b)", &sleeping);
+    if (!sleeping) {
+      static_cast<SleepMonitor*>(data)->on_resume();
+    }
+  }
+}
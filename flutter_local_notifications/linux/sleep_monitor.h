@@ -0,0 +1,39 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_SLEEP_MONITOR_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_SLEEP_MONITOR_H_
+
+#include <gio/gio.h>
+#include <functional>
+
+namespace flutter_local_notifications {
+  // Reports resumes from suspend, which logind announces with PrepareForSleep(false) on the
+  // system bus. Tests can stand in for logind with a stub owning org.freedesktop.login1 on
+  // a private bus, which DBUS_SYSTEM_BUS_ADDRESS points to.
+  class SleepMonitor {
+  public:
+    using ResumeCallback = std::function<void()>;
+
+    explicit SleepMonitor(ResumeCallback onResume);
+    ~SleepMonitor();
+
+    SleepMonitor(const SleepMonitor&) = delete;
+    SleepMonitor& operator=(const SleepMonitor&) = delete;
+
+    // Whether the system bus is connected, from then on resumes are reported.
+    bool isConnected() const {
+      return connection != nullptr;
+    }
+
+  private:
+    ResumeCallback on_resume;
+    GCancellable* cancellable;
+    // null until the bus is connected
+    GDBusConnection* connection = nullptr;
+    guint subscription = 0;
+
+    static void onBusReady(GObject* source, GAsyncResult* result, gpointer data);
+    static void onSignal(GDBusConnection* connection, const gchar* sender, const gchar* path, const gchar* interface,
+      const gchar* signal, GVariant* parameters, gpointer data);
+  };
+}
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_SLEEP_MONITOR_H_
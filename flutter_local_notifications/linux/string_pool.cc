@@ -0,0 +1,54 @@
+#include "string_pool.h"
+
+#include <cassert>
+
+namespace flutter_local_notifications {
+  StringPool::Id StringPool::intern(std::string_view value) {
+    if (value.empty()) {
+      return 0;
+    }
+    if (const auto iter = ids.find(value); iter != ids.end()) {
+      ++slots[iter->second - 1].references;
+      return iter->second;
+    }
+    Id id;
+    if (free_ids.empty()) {
+      slots.emplace_back();
+      id = static_cast<Id>(slots.size());
+    } else {
+      id = free_ids.back();
+      free_ids.pop_back();
+    }
+    auto& slot = slots[id - 1];
+    slot.value.assign(value);
+    slot.references = 1;
+    ids.emplace(slot.value, id);
+    return id;
+  }
+
+  void StringPool::release(Id id) {
+    if (id == 0) {
+      return;
+    }
+    auto& slot = slots[id - 1];
+    assert(slot.references > 0);
+    if (--slot.references > 0) {
+      return;
+    }
+    ids.erase(slot.value);
+    // gives the memory back, as the next string may be a lot shorter
+    std::string().swap(slot.value);
+    free_ids.push_back(id);
+  }
+
+  void StringPool::clear() {
+    slots.clear();
+    free_ids.clear();
+    ids.clear();
+  }
+
+  const std::string& StringPool::get(Id id) const {
+    static const std::string empty;
+    return id == 0 ? empty : slots[id - 1].value;
+  }
+}
@@ -0,0 +1,54 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_STRING_POOL_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_STRING_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace flutter_local_notifications {
+  // Interns strings by reference count, so that content shared by many notifications, e.g.
+  // the title of reminders scheduled for every day, is stored once. Strings are kept in
+  // slots allocated in chunks, which do not move and are reused once released.
+  class StringPool {
+  public:
+    // 0 stands for the empty string, which is not stored.
+    using Id = std::uint32_t;
+
+    StringPool() = default;
+
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    // Returns the id of value, with one more reference.
+    Id intern(std::string_view value);
+    // Drops a reference of id, the string is released with the last one.
+    void release(Id id);
+    void clear();
+
+    // The string stays valid until id is released for the last time.
+    const std::string& get(Id id) const;
+
+    // distinct strings stored
+    std::size_t size() const {
+      return ids.size();
+    }
+
+  private:
+    struct Slot {
+      std::string value;
+      std::uint32_t references = 0;
+    };
+
+    // id - 1 is the index of the slot
+    std::deque<Slot> slots;
+    std::vector<Id> free_ids;
+    // keys refer to the value of their slot
+    std::unordered_map<std::string_view, Id> ids;
+  };
+}
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_STRING_POOL_H_
@@ -0,0 +1,96 @@
+#include <gio/gio.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "../admission_queue.h"
+
+namespace {
+  using flutter_local_notifications::AdmissionQueue;
+  using Priority = AdmissionQueue::Priority;
+
+  struct Fixture {
+    std::vector<std::int64_t> sent;
+    std::vector<std::int64_t> dropped;
+    AdmissionQueue queue;
+
+    // Sends the first notification at once, then one every 10 ms.
+    Fixture()
+      : queue([this](std::int64_t id, GNotification*) { sent.push_back(id); },
+        [this](std::int64_t id) { dropped.push_back(id); }, AdmissionQueue::Config{ 100, 1, 16 }) {
+    }
+
+    void submit(std::int64_t id, Priority priority) {
+      g_autoptr(GNotification) notification = g_notification_new("Title");
+      queue.submit(id, notification, priority);
+    }
+
+    // Runs the main loop until count notifications have been sent.
+    void drainUntil(std::size_t count) {
+      while (sent.size() < count) {
+        g_main_context_iteration(nullptr, TRUE);
+      }
+    }
+  };
+
+  void TestUrgentResubmissionBypassesBacklog() {
+    Fixture fixture;
+    fixture.submit(1, Priority::Normal);
+    fixture.submit(2, Priority::Low);
+    fixture.submit(3, Priority::Normal);
+    fixture.submit(4, Priority::Low);
+    g_assert_cmpuint(fixture.sent.size(), ==, 1);
+
+    // an update of 4 which became urgent
+    fixture.submit(4, Priority::Urgent);
+    g_assert_cmpuint(fixture.sent.size(), ==, 2);
+    g_assert_cmpint(fixture.sent.back(), ==, 4);
+    g_assert_false(fixture.queue.contains(4));
+    g_assert_cmpuint(fixture.queue.depth(), ==, 2);
+
+    // the former place of 4 is skipped
+    fixture.drainUntil(4);
+    g_assert_cmpint(fixture.sent[2], ==, 3);
+    g_assert_cmpint(fixture.sent[3], ==, 2);
+    for (auto i = 0; i < 5; ++i) {
+      g_main_context_iteration(nullptr, FALSE);
+    }
+    g_assert_cmpuint(fixture.sent.size(), ==, 4);
+    g_assert_cmpuint(fixture.queue.getStats().deferred, ==, 3);
+  }
+
+  void TestResubmissionMovesToItsPriority() {
+    Fixture fixture;
+    fixture.submit(1, Priority::Normal);
+    fixture.submit(2, Priority::Normal);
+    fixture.submit(3, Priority::Low);
+
+    fixture.submit(3, Priority::High);
+    g_assert_true(fixture.queue.contains(3));
+    fixture.drainUntil(3);
+    g_assert_cmpint(fixture.sent[1], ==, 3);
+    g_assert_cmpint(fixture.sent[2], ==, 2);
+  }
+
+  void TestResubmissionWithSamePriorityKeepsItsPlace() {
+    Fixture fixture;
+    fixture.submit(1, Priority::Normal);
+    fixture.submit(2, Priority::Normal);
+    fixture.submit(3, Priority::Normal);
+
+    fixture.submit(2, Priority::Normal);
+    g_assert_cmpuint(fixture.queue.depth(), ==, 2);
+    fixture.drainUntil(3);
+    g_assert_cmpint(fixture.sent[1], ==, 2);
+    g_assert_cmpint(fixture.sent[2], ==, 3);
+    g_assert_true(fixture.dropped.empty());
+  }
+}
+
+int main(int argc, char** argv) {
+  g_test_init(&argc, &argv, nullptr);
+  g_test_add_func("/admission_queue/urgent_resubmission_bypasses_backlog", TestUrgentResubmissionBypassesBacklog);
+  g_test_add_func("/admission_queue/resubmission_moves_to_its_priority", TestResubmissionMovesToItsPriority);
+  g_test_add_func("/admission_queue/resubmission_with_same_priority_keeps_its_place", TestResubmissionWithSamePriorityKeepsItsPlace);
+  return g_test_run();
+}
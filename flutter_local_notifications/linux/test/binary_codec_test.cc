@@ -0,0 +1,141 @@
+#include <flutter_linux/flutter_linux.h>
+
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../binary_codec.h"
+
+namespace {
+  using flutter_local_notifications::BinaryMessage;
+  using flutter_local_notifications::BinaryOperation;
+  using flutter_local_notifications::BinaryReply;
+  using flutter_local_notifications::IconSource;
+  using flutter_local_notifications::ReadBinaryMessage;
+
+  using Bytes = std::vector<guint8>;
+
+  // Messages written by binary_codec.dart, see the file for the calls which wrote them.
+  const std::unordered_map<std::string, Bytes>& Goldens() {
+    static const auto goldens = []() {
+      std::unordered_map<std::string, Bytes> result;
+      g_autofree gchar* contents = nullptr;
+      g_autoptr(GError) error = nullptr;
+      g_file_get_contents(FLUTTER_LOCAL_NOTIFICATIONS_BINARY_CODEC_GOLDENS, &contents, nullptr, &error);
+      g_assert_no_error(error);
+      g_auto(GStrv) lines = g_strsplit(contents, "\n", -1);
+      for (auto line = lines; *line; ++line) {
+        const auto separator = std::strchr(*line, ':');
+        if (**line == '#' || !separator) {
+          continue;
+        }
+        Bytes bytes;
+        for (auto digit = separator + 1; *digit; ++digit) {
+          if (g_ascii_isspace(*digit)) {
+            continue;
+          }
+          g_assert_true(g_ascii_isxdigit(digit[0]) && g_ascii_isxdigit(digit[1]));
+          bytes.push_back(g_ascii_xdigit_value(digit[0]) << 4 | g_ascii_xdigit_value(digit[1]));
+          ++digit;
+        }
+        result.emplace(std::string(*line, separator), std::move(bytes));
+      }
+      return result;
+    }();
+    return goldens;
+  }
+
+  BinaryMessage Read(const char* name) {
+    const auto& bytes = Goldens().at(name);
+    BinaryMessage message = {};
+    g_assert_true(ReadBinaryMessage(bytes.data(), bytes.size(), message));
+    return message;
+  }
+
+  void TestReadCancel() {
+    const auto message = Read("cancel");
+    g_assert_true(message.operation == BinaryOperation::Cancel);
+    g_assert_cmpint(message.id, ==, 0x01020304);
+  }
+
+  void TestReadShowWithoutDetails() {
+    const auto message = Read("showWithoutDetails");
+    g_assert_true(message.operation == BinaryOperation::Show);
+    g_assert_cmpint(message.id, ==, 1);
+    g_assert_cmpstr(message.title, ==, "Hi");
+    g_assert_cmpstr(message.body, ==, "Yo");
+    g_assert_cmpstr(message.payload, ==, "");
+    g_assert_false(message.details.iconSource.has_value());
+    g_assert_false(message.details.priority.has_value());
+    g_assert_false(message.details.misfirePolicy.has_value());
+    g_assert_null(message.details.groupKey);
+    g_assert_true(message.details.buttons.empty());
+  }
+
+  void TestReadShowWithDetails() {
+    const auto message = Read("showWithDetails");
+    g_assert_cmpint(message.id, ==, -1);
+    g_assert_null(message.title);
+    g_assert_null(message.body);
+    g_assert_cmpstr(message.payload, ==, "p");
+    const auto& details = message.details;
+    g_assert_true(details.iconSource == IconSource::Theme);
+    g_assert_true(details.icon == "x");
+    g_assert_cmpint(*details.priority, ==, 2);
+    g_assert_cmpint(*details.misfirePolicy, ==, 2);
+    g_assert_cmpstr(details.groupKey, ==, "g");
+    g_assert_cmpuint(details.buttons.size(), ==, 1);
+    g_assert_cmpstr(details.buttons[0].label, ==, "OK");
+    g_assert_cmpstr(details.buttons[0].payload, ==, "ok");
+  }
+
+  void TestReadShowWithBytesIcon() {
+    const auto message = Read("showWithBytesIcon");
+    g_assert_true(message.details.iconSource == IconSource::Bytes);
+    g_assert_true(message.details.icon == std::string_view("\x00\xff", 2));
+  }
+
+  void TestReadZonedSchedule() {
+    const auto daily = Read("zonedScheduleDaily");
+    g_assert_true(daily.operation == BinaryOperation::ZonedSchedule);
+    g_assert_cmpint(daily.id, ==, 2);
+    g_assert_cmpstr(daily.timeZoneName, ==, "UTC");
+    g_assert_cmpstr(daily.scheduledDateTime, ==, "2030-01-01T09:30:00");
+    g_assert_cmpint(daily.matchDateTimeComponents, ==, 0);
+
+    const auto once = Read("zonedScheduleOnce");
+    g_assert_cmpint(once.matchDateTimeComponents, ==, -1);
+  }
+
+  // Every message cut short by a byte is malformed, rather than read past its end.
+  void TestRejectTruncated() {
+    for (const auto& [name, bytes] : Goldens()) {
+      if (name == "errorReply") {
+        continue;
+      }
+      BinaryMessage message = {};
+      g_assert_false(ReadBinaryMessage(bytes.data(), bytes.size() - 1, message));
+    }
+  }
+
+  void TestWriteErrorReply() {
+    g_autoptr(FlMethodResponse) response = FL_METHOD_RESPONSE(fl_method_error_response_new("code", "message", nullptr));
+    g_autoptr(FlValue) reply = BinaryReply(response);
+    const auto& expected = Goldens().at("errorReply");
+    g_assert_cmpmem(fl_value_get_uint8_list(reply), fl_value_get_length(reply), expected.data(), expected.size());
+  }
+}
+
+int main(int argc, char** argv) {
+  g_test_init(&argc, &argv, nullptr);
+  g_test_add_func("/binary_codec/read_cancel", TestReadCancel);
+  g_test_add_func("/binary_codec/read_show_without_details", TestReadShowWithoutDetails);
+  g_test_add_func("/binary_codec/read_show_with_details", TestReadShowWithDetails);
+  g_test_add_func("/binary_codec/read_show_with_bytes_icon", TestReadShowWithBytesIcon);
+  g_test_add_func("/binary_codec/read_zoned_schedule", TestReadZonedSchedule);
+  g_test_add_func("/binary_codec/reject_truncated", TestRejectTruncated);
+  g_test_add_func("/binary_codec/write_error_reply", TestWriteErrorReply);
+  return g_test_run();
+}
@@ -0,0 +1,189 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_TEST_FAKE_NOTIFICATION_SERVER_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_TEST_FAKE_NOTIFICATION_SERVER_H_
+
+#include <gio/gio.h>
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Stub of org.freedesktop.Notifications on a bus of GTestDBus, which records the calls it
+// receives and emits the signals of the specification when told to.
+class FakeNotificationServer {
+public:
+  struct Notification {
+    guint32 replacesId;
+    std::string summary;
+    std::string body;
+    std::vector<std::string> actions;
+  };
+
+  // Owns the name on a connection of its own, so that signals reach the session bus
+  // connection of the process like those of a real server.
+  explicit FakeNotificationServer(GTestDBus* bus) {
+    g_autoptr(GError) error = nullptr;
+    connection = g_dbus_connection_new_for_address_sync(g_test_dbus_get_bus_address(bus),
+      static_cast<GDBusConnectionFlags>(G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT | G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION),
+      nullptr, nullptr, &error);
+    g_assert_no_error(error);
+
+    g_autoptr(GDBusNodeInfo) nodeInfo = g_dbus_node_info_new_for_xml(IntrospectionXml, &error);
+    g_assert_no_error(error);
+    static const GDBusInterfaceVTable vtable = {
+      [](GDBusConnection* connection, const gchar* sender, const gchar* path, const gchar* interface,
+        const gchar* method, GVariant* parameters, GDBusMethodInvocation* invocation, gpointer data) {
+        static_cast<FakeNotificationServer*>(data)->handleMethod(method, parameters, invocation);
+      },
+    };
+    registration_id = g_dbus_connection_register_object(connection, ObjectPath, nodeInfo->interfaces[0], &vtable, this,
+      nullptr, &error);
+    g_assert_no_error(error);
+
+    g_autoptr(GVariant) reply = g_dbus_connection_call_sync(connection, "org.freedesktop.DBus", "/org/freedesktop/DBus",
+      "org.freedesktop.DBus", "RequestName", g_variant_new("(su)", Name, 0u), G_VARIANT_TYPE("(u)"),
+      G_DBUS_CALL_FLAGS_NONE, -1, nullptr, &error);
+    g_assert_no_error(error);
+  }
+
+  ~FakeNotificationServer() {
+    for (const auto invocation : held) {
+      g_object_unref(invocation);
+    }
+    g_dbus_connection_unregister_object(connection, registration_id);
+    g_dbus_connection_close_sync(connection, nullptr, nullptr);
+    g_object_unref(connection);
+  }
+
+  FakeNotificationServer(const FakeNotificationServer&) = delete;
+  FakeNotificationServer& operator=(const FakeNotificationServer&) = delete;
+
+  // Notify calls received, in order.
+  std::vector<Notification> notifications;
+  // ids passed to CloseNotification, in order.
+  std::vector<guint32> closed;
+  // Notify calls are answered by releaseReplies only while set, so that they stay in flight.
+  bool holdReplies = false;
+
+  void releaseReplies() {
+    for (const auto invocation : std::exchange(held, {})) {
+      replyToNotify(invocation);
+    }
+  }
+
+  void emitClosed(guint32 id, guint32 reason) {
+    emit("NotificationClosed", g_variant_new("(uu)", id, reason));
+  }
+
+  void emitActionInvoked(guint32 id, const gchar* key) {
+    emit("ActionInvoked", g_variant_new("(us)", id, key));
+  }
+
+  // Runs the default main context until the calls sent on client so far have been received.
+  void sync(GDBusConnection* client) const {
+    auto done = false;
+    g_dbus_connection_call(client, Name, ObjectPath, Name, "GetCapabilities", nullptr, nullptr, G_DBUS_CALL_FLAGS_NONE, -1,
+      nullptr, [](GObject* source, GAsyncResult* result, gpointer data) {
+        g_autoptr(GVariant) reply = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), result, nullptr);
+        *static_cast<bool*>(data) = true;
+      }, &done);
+    while (!done) {
+      g_main_context_iteration(nullptr, TRUE);
+    }
+  }
+
+  // Runs the default main context until count Notify calls have been received.
+  void waitForNotifications(std::size_t count) const {
+    while (notifications.size() < count) {
+      g_main_context_iteration(nullptr, TRUE);
+    }
+  }
+
+private:
+  static constexpr const char Name[] = "org.freedesktop.Notifications";
+  static constexpr const char ObjectPath[] = "/org/freedesktop/Notifications";
+  static constexpr const char IntrospectionXml[] =
+    "<node>"
+    "  <interface name='org.freedesktop.Notifications'>"
+    "    <method name='GetCapabilities'>"
+    "      <arg type='as' name='capabilities' direction='out'/>"
+    "    </method>"
+    "    <method name='Notify'>"
+    "      <arg type='s' name='app_name' direction='in'/>"
+    "      <arg type='u' name='replaces_id' direction='in'/>"
+    "      <arg type='s' name='app_icon' direction='in'/>"
+    "      <arg type='s' name='summary' direction='in'/>"
+    "      <arg type='s' name='body' direction='in'/>"
+    "      <arg type='as' name='actions' direction='in'/>"
+    "      <arg type='a{sv}' name='hints' direction='in'/>"
+    "      <arg type='i' name='expire_timeout' direction='in'/>"
+    "      <arg type='u' name='id' direction='out'/>"
+    "    </method>"
+    "    <method name='CloseNotification'>"
+    "      <arg type='u' name='id' direction='in'/>"
+    "    </method>"
+    "    <signal name='NotificationClosed'>"
+    "      <arg type='u' name='id'/>"
+    "      <arg type='u' name='reason'/>"
+    "    </signal>"
+    "    <signal name='ActionInvoked'>"
+    "      <arg type='u' name='id'/>"
+    "      <arg type='s' name='action_key'/>"
+    "    </signal>"
+    "  </interface>"
+    "</node>";
+
+  GDBusConnection* connection;
+  guint registration_id;
+  guint32 last_id = 0;
+  std::vector<GDBusMethodInvocation*> held;
+
+  void handleMethod(std::string_view method, GVariant* parameters, GDBusMethodInvocation* invocation) {
+    if (method == "GetCapabilities") {
+      const gchar* capabilities[] = { "actions", "body" };
+      g_dbus_method_invocation_return_value(invocation,
+        g_variant_new("(@as)", g_variant_new_strv(capabilities, G_N_ELEMENTS(capabilities))));
+    } else if (method == "Notify") {
+      Notification notification;
+      const gchar* summary;
+      const gchar* body;
+      g_autoptr(GVariantIter) actions = nullptr;
+      g_variant_get(parameters, "(&su&s&s&sasa{sv}i)", nullptr, &notification.replacesId, nullptr, &summary, &body, &actions,
+        nullptr, nullptr);
+      notification.summary = summary;
+      notification.body = body;
+      const gchar* action;
+      while (g_variant_iter_next(actions, "&s", &action)) {
+        notification.actions.emplace_back(action);
+      }
+      notifications.push_back(std::move(notification));
+      if (holdReplies) {
+        held.push_back(invocation);
+      } else {
+        replyToNotify(invocation);
+      }
+    } else if (method == "CloseNotification") {
+      guint32 id;
+      g_variant_get(parameters, "(u)", &id);
+      closed.push_back(id);
+      g_dbus_method_invocation_return_value(invocation, nullptr);
+    }
+  }
+
+  // Keeps the id the notification replaces, as servers do while it is still shown.
+  void replyToNotify(GDBusMethodInvocation* invocation) {
+    guint32 replacesId;
+    g_variant_get(g_dbus_method_invocation_get_parameters(invocation), "(&su&s&s&sasa{sv}i)", nullptr, &replacesId, nullptr,
+      nullptr, nullptr, nullptr, nullptr, nullptr);
+    g_dbus_method_invocation_return_value(invocation, g_variant_new("(u)", replacesId ? replacesId : ++last_id));
+  }
+
+  void emit(const gchar* signal, GVariant* parameters) {
+    g_autoptr(GError) error = nullptr;
+    g_dbus_connection_emit_signal(connection, nullptr, ObjectPath, Name, signal, parameters, &error);
+    g_assert_no_error(error);
+    g_dbus_connection_flush_sync(connection, nullptr, &error);
+  }
+};
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_TEST_FAKE_NOTIFICATION_SERVER_H_
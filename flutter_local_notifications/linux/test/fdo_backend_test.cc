@@ -0,0 +1,167 @@
+#include <gio/gio.h>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../fdo_backend.h"
+#include "fake_notification_server.h"
+
+namespace {
+  using flutter_local_notifications::FdoNotification;
+  using flutter_local_notifications::FdoNotificationBackend;
+
+  // Runs the default main context until done returns true.
+  template <typename Predicate>
+  void IterateUntil(Predicate done) {
+    while (!done()) {
+      g_main_context_iteration(nullptr, TRUE);
+    }
+  }
+
+  FdoNotification Content(const char* summary) {
+    FdoNotification content;
+    content.summary = summary;
+    return content;
+  }
+
+  struct TestBus {
+    GTestDBus* bus;
+
+    TestBus() : bus(g_test_dbus_new(G_TEST_DBUS_NONE)) {
+      g_test_dbus_up(bus);
+    }
+
+    ~TestBus() {
+      g_test_dbus_down(bus);
+      g_object_unref(bus);
+    }
+  };
+
+  // A backend connected to the session bus of a private bus, on which a stub server runs.
+  struct Fixture {
+    struct Action {
+      std::int64_t id;
+      std::string payload;
+      gint32 button;
+    };
+
+    TestBus bus;
+    FakeNotificationServer server{ bus.bus };
+    std::vector<Action> actions;
+    std::vector<std::pair<std::int64_t, guint32>> closed;
+    FdoNotificationBackend backend{ "Test", "", [this](std::int64_t id, const std::string& payload, gint32 button) {
+      actions.push_back({ id, payload, button });
+    }, [this](std::int64_t id, guint32 reason) {
+      closed.emplace_back(id, reason);
+    } };
+
+    // Waits until the calls sent by the backend so far have been received by the server.
+    void sync() {
+      g_autoptr(GDBusConnection) session = g_bus_get_sync(G_BUS_TYPE_SESSION, nullptr, nullptr);
+      server.sync(session);
+    }
+
+    void waitForReplies() {
+      IterateUntil([this]() { return backend.inFlight() == 0; });
+    }
+  };
+
+  void TestUpdateReplacesTheServerId() {
+    Fixture fixture;
+    fixture.backend.notify(1, Content("first"));
+    fixture.server.waitForNotifications(1);
+    g_assert_cmpuint(fixture.server.notifications[0].replacesId, ==, 0);
+    fixture.waitForReplies();
+
+    fixture.backend.notify(1, Content("second"));
+    fixture.backend.notify(2, Content("other"));
+    fixture.server.waitForNotifications(3);
+    g_assert_cmpstr(fixture.server.notifications[1].summary.data(), ==, "second");
+    g_assert_cmpuint(fixture.server.notifications[1].replacesId, ==, 1);
+    g_assert_cmpuint(fixture.server.notifications[2].replacesId, ==, 0);
+  }
+
+  // Updates sent while the server id is not known yet would show a second notification.
+  void TestUpdateWaitsForNotifyInFlight() {
+    Fixture fixture;
+    fixture.server.holdReplies = true;
+    fixture.backend.notify(1, Content("first"));
+    fixture.server.waitForNotifications(1);
+
+    fixture.backend.notify(1, Content("second"));
+    fixture.backend.notify(1, Content("third"));
+    fixture.sync();
+    g_assert_cmpuint(fixture.server.notifications.size(), ==, 1);
+
+    // only the last update is sent, in place of the first
+    fixture.server.holdReplies = false;
+    fixture.server.releaseReplies();
+    fixture.server.waitForNotifications(2);
+    g_assert_cmpstr(fixture.server.notifications[1].summary.data(), ==, "third");
+    g_assert_cmpuint(fixture.server.notifications[1].replacesId, ==, 1);
+    fixture.waitForReplies();
+    fixture.sync();
+    g_assert_cmpuint(fixture.server.notifications.size(), ==, 2);
+  }
+
+  void TestCloseWaitsForNotifyInFlight() {
+    Fixture fixture;
+    fixture.server.holdReplies = true;
+    fixture.backend.notify(1, Content("first"));
+    fixture.server.waitForNotifications(1);
+    fixture.backend.close(1);
+
+    fixture.server.releaseReplies();
+    IterateUntil([&fixture]() { return !fixture.server.closed.empty(); });
+    g_assert_cmpuint(fixture.server.closed[0], ==, 1);
+    g_assert_cmpuint(fixture.server.notifications.size(), ==, 1);
+  }
+
+  // Signals refer to server ids, which are mapped back to the ids of the plugin.
+  void TestSignalsAreMappedToIds() {
+    Fixture fixture;
+    auto content = Content("summary");
+    content.payload = "default payload";
+    content.buttons.push_back({ "OK", "button payload" });
+    fixture.backend.notify(7, content);
+    fixture.server.waitForNotifications(1);
+    fixture.waitForReplies();
+    const std::vector<std::string> actions = { "default", "", "button-0", "OK" };
+    g_assert_true(fixture.server.notifications[0].actions == actions);
+
+    fixture.server.emitActionInvoked(1, "default");
+    fixture.server.emitActionInvoked(1, "button-0");
+    // of notifications which are not the backend's
+    fixture.server.emitActionInvoked(2, "default");
+    fixture.server.emitClosed(2, 1);
+    fixture.server.emitClosed(1, 2);
+    IterateUntil([&fixture]() { return !fixture.closed.empty(); });
+
+    g_assert_cmpuint(fixture.actions.size(), ==, 2);
+    g_assert_cmpint(fixture.actions[0].id, ==, 7);
+    g_assert_cmpstr(fixture.actions[0].payload.data(), ==, "default payload");
+    g_assert_cmpint(fixture.actions[0].button, ==, -1);
+    g_assert_cmpint(fixture.actions[1].id, ==, 7);
+    g_assert_cmpstr(fixture.actions[1].payload.data(), ==, "button payload");
+    g_assert_cmpint(fixture.actions[1].button, ==, 0);
+    g_assert_cmpuint(fixture.closed.size(), ==, 1);
+    g_assert_cmpint(fixture.closed[0].first, ==, 7);
+    g_assert_cmpuint(fixture.closed[0].second, ==, 2);
+
+    // the id is forgotten once closed, so that a new notification gets a new server id
+    fixture.backend.notify(7, content);
+    fixture.server.waitForNotifications(2);
+    g_assert_cmpuint(fixture.server.notifications[1].replacesId, ==, 0);
+  }
+}
+
+int main(int argc, char** argv) {
+  g_test_init(&argc, &argv, nullptr);
+  g_test_add_func("/fdo_backend/update_replaces_the_server_id", TestUpdateReplacesTheServerId);
+  g_test_add_func("/fdo_backend/update_waits_for_notify_in_flight", TestUpdateWaitsForNotifyInFlight);
+  g_test_add_func("/fdo_backend/close_waits_for_notify_in_flight", TestCloseWaitsForNotifyInFlight);
+  g_test_add_func("/fdo_backend/signals_are_mapped_to_ids", TestSignalsAreMappedToIds);
+  return g_test_run();
+}
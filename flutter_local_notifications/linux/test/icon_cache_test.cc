@@ -0,0 +1,125 @@
+#include <gdk-pixbuf/gdk-pixbuf.h>
+#include <gio/gio.h>
+
+#include <string_view>
+
+#include "../icon_cache.h"
+
+namespace {
+  using flutter_local_notifications::IconCache;
+  using flutter_local_notifications::IconDecoder;
+  using flutter_local_notifications::IconSource;
+
+  inline constexpr int IconSize = 64;
+
+  // A png picture of size by size pixels.
+  GBytes* Picture(int size) {
+    g_autoptr(GdkPixbuf) pixbuf = gdk_pixbuf_new(GDK_COLORSPACE_RGB, FALSE, 8, size, size);
+    gdk_pixbuf_fill(pixbuf, 0x336699ff);
+    gchar* buffer;
+    gsize bufferSize;
+    g_autoptr(GError) error = nullptr;
+    gdk_pixbuf_save_to_buffer(pixbuf, &buffer, &bufferSize, "png", &error, nullptr);
+    g_assert_no_error(error);
+    return g_bytes_new_take(buffer, bufferSize);
+  }
+
+  std::string_view Content(GBytes* bytes) {
+    gsize size;
+    const auto data = g_bytes_get_data(bytes, &size);
+    return std::string_view(static_cast<const char*>(data), size);
+  }
+
+  struct Ready {
+    bool called = false;
+    GIcon* icon = nullptr;
+    GIcon* decoded = nullptr;
+
+    ~Ready() {
+      g_clear_object(&icon);
+      g_clear_object(&decoded);
+    }
+
+    IconCache::ReadyCallback callback() {
+      return [this](GIcon* readyIcon, GIcon* readyDecoded) {
+        called = true;
+        icon = G_ICON(g_object_ref(readyIcon));
+        decoded = G_ICON(g_object_ref(readyDecoded));
+      };
+    }
+
+    void wait() const {
+      while (!called) {
+        g_main_context_iteration(nullptr, TRUE);
+      }
+    }
+  };
+
+  // A picture larger than the icon size is returned as is at once, and downscaled later.
+  void TestGetDoesNotWaitForTheDecoder() {
+    IconDecoder decoder(IconSize);
+    IconCache cache(4, decoder);
+    g_autoptr(GBytes) picture = Picture(IconSize * 8);
+    Ready ready;
+    auto decoding = false;
+    g_autoptr(GIcon) icon = cache.get(IconSource::Bytes, Content(picture), ready.callback(), &decoding);
+    g_assert_true(decoding);
+    g_assert_true(g_bytes_equal(g_bytes_icon_get_bytes(G_BYTES_ICON(icon)), picture));
+
+    ready.wait();
+    g_assert_true(ready.icon == icon);
+    g_assert_true(ready.decoded != icon);
+    g_assert_cmpuint(g_bytes_get_size(g_bytes_icon_get_bytes(G_BYTES_ICON(ready.decoded))), <, g_bytes_get_size(picture));
+
+    // decoded icons are returned from then on, without waiters
+    Ready again;
+    g_autoptr(GIcon) cached = cache.get(IconSource::Bytes, Content(picture), again.callback(), &decoding);
+    g_assert_false(decoding);
+    g_assert_true(cached == ready.decoded);
+    g_assert_false(again.called);
+  }
+
+  void TestSmallPictureIsKeptAsIs() {
+    IconDecoder decoder(IconSize);
+    IconCache cache(4, decoder);
+    g_autoptr(GBytes) picture = Picture(IconSize / 2);
+    Ready ready;
+    g_autoptr(GIcon) icon = cache.get(IconSource::Bytes, Content(picture), ready.callback());
+    ready.wait();
+    g_assert_true(ready.decoded == icon);
+  }
+
+  void TestThemeIconsAreNotDecoded() {
+    IconDecoder decoder(IconSize);
+    IconCache cache(4, decoder);
+    Ready ready;
+    auto decoding = true;
+    g_autoptr(GIcon) icon = cache.get(IconSource::Theme, "dialog-information", ready.callback(), &decoding);
+    g_assert_true(G_IS_THEMED_ICON(icon));
+    g_assert_false(decoding);
+    g_assert_false(ready.called);
+  }
+
+  // Waiters are not left hanging by an icon evicted before it is decoded.
+  void TestEvictedIconIsReadyAsIs() {
+    IconDecoder decoder(IconSize);
+    IconCache cache(1, decoder);
+    g_autoptr(GBytes) picture = Picture(IconSize * 8);
+    Ready ready;
+    g_autoptr(GIcon) icon = cache.get(IconSource::Bytes, Content(picture), ready.callback());
+    g_autoptr(GIcon) other = cache.get(IconSource::Theme, "dialog-information");
+    g_assert_true(ready.called);
+    g_assert_true(ready.icon == icon);
+    g_assert_true(ready.decoded == icon);
+    g_assert_cmpuint(cache.size(), ==, 1);
+  }
+}
+
+int main(int argc, char** argv) {
+  g_test_init(&argc, &argv, nullptr);
+  g_test_add_func("/icon_cache/get_does_not_wait_for_the_decoder", TestGetDoesNotWaitForTheDecoder);
+  g_test_add_func("/icon_cache/small_picture_is_kept_as_is", TestSmallPictureIsKeptAsIs);
+  g_test_add_func("/icon_cache/theme_icons_are_not_decoded", TestThemeIconsAreNotDecoded);
+  g_test_add_func("/icon_cache/evicted_icon_is_ready_as_is", TestEvictedIconIsReadyAsIs);
+  return g_test_run();
+}
@@ -0,0 +1,155 @@
+#include <gio/gio.h>
+#include <signal.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../scheduler_helper_client.h"
+#include "../scheduler_helper_protocol.h"
+#include "fake_notification_server.h"
+
+namespace {
+  using flutter_local_notifications::FdoNotification;
+  using flutter_local_notifications::SchedulerHelperBusName;
+  using flutter_local_notifications::SchedulerHelperClient;
+  using flutter_local_notifications::SchedulerHelperInterface;
+  using flutter_local_notifications::SchedulerHelperObjectPath;
+
+  inline constexpr const char Application[] = "com.example.SchedulerHelperTest";
+  inline constexpr const char AppName[] = "Scheduler helper test";
+
+  // A client as the plugin creates it, which records the notifications the helper fired.
+  std::unique_ptr<SchedulerHelperClient> NewClient(std::vector<std::int64_t>& fired) {
+    return std::make_unique<SchedulerHelperClient>(Application, AppName, "",
+      [](std::int64_t id, const std::string& payload, gint32 button) {}, [&fired](std::int64_t id) {
+        fired.push_back(id);
+      }, []() {});
+  }
+
+  // Runs the default main context until done is set.
+  void IterateUntil(const bool& done) {
+    while (!done) {
+      g_main_context_iteration(nullptr, TRUE);
+    }
+  }
+
+  // Starts the helper of Application the way the plugin does, and waits until it owns its name.
+  GPid SpawnHelper(GDBusConnection* connection, bool& exited) {
+    auto busName = SchedulerHelperBusName(Application);
+    gchar* argv[] = {
+      const_cast<gchar*>(FLUTTER_LOCAL_NOTIFICATIONS_SCHEDULER_PATH),
+      busName.data(),
+      const_cast<gchar*>(AppName),
+      const_cast<gchar*>(""),
+      nullptr,
+    };
+    GPid pid;
+    g_autoptr(GError) error = nullptr;
+    g_spawn_async(nullptr, argv, nullptr, G_SPAWN_DO_NOT_REAP_CHILD, nullptr, nullptr, &pid, &error);
+    g_assert_no_error(error);
+    g_child_watch_add(pid, [](GPid pid, gint status, gpointer data) {
+      g_spawn_close_pid(pid);
+      *static_cast<bool*>(data) = true;
+    }, &exited);
+
+    auto owned = false;
+    const auto watch = g_bus_watch_name_on_connection(connection, busName.data(), G_BUS_NAME_WATCHER_FLAGS_NONE,
+      [](GDBusConnection* connection, const gchar* name, const gchar* owner, gpointer data) {
+        *static_cast<bool*>(data) = true;
+      }, nullptr, &owned, nullptr);
+    IterateUntil(owned);
+    g_bus_unwatch_name(watch);
+    return pid;
+  }
+
+  // A one-shot which the helper fires after the app exited, and which is dismissed before
+  // the app starts again, must not be restored by the app although the helper exited.
+  void TestFiredIsKeptAfterHelperExits() {
+    g_autoptr(GTestDBus) bus = g_test_dbus_new(G_TEST_DBUS_NONE);
+    g_test_dbus_up(bus);
+    {
+      FakeNotificationServer server(bus);
+      std::vector<std::int64_t> fired;
+      auto exited = false;
+      {
+        g_autoptr(GDBusConnection) session = g_bus_get_sync(G_BUS_TYPE_SESSION, nullptr, nullptr);
+        SpawnHelper(session, exited);
+        const auto client = NewClient(fired);
+        client->attach();
+        g_assert_true(client->isAttached());
+        FdoNotification content;
+        content.summary = "Reminder";
+        client->schedule(1, g_get_real_time() + 100 * 1000, 0, std::nullopt, content);
+        // answered once the helper has handled the calls sent before
+        g_autoptr(GVariant) reply = g_dbus_connection_call_sync(session, SchedulerHelperBusName(Application).data(),
+          SchedulerHelperObjectPath, "org.freedesktop.DBus.Peer", "Ping", nullptr, nullptr, G_DBUS_CALL_FLAGS_NONE, -1,
+          nullptr, nullptr);
+        g_assert_nonnull(reply);
+        // the app exits
+        g_dbus_connection_close_sync(session, nullptr, nullptr);
+      }
+
+      server.waitForNotifications(1);
+      g_assert_cmpstr(server.notifications[0].summary.data(), ==, "Reminder");
+      // dismissed, after which the helper has nothing left to do
+      server.emitClosed(1, 2);
+      IterateUntil(exited);
+      g_assert_true(fired.empty());
+
+      // the app starts again, and the helper it starts is not installed next to the test
+      for (auto restart = 0; restart < 2; ++restart) {
+        const auto client = NewClient(fired);
+        g_test_expect_message(nullptr, G_LOG_LEVEL_WARNING, "Failed to start the scheduler helper*");
+        client->attach();
+        g_test_assert_expected_messages();
+      }
+      // and only the first start took it
+      g_assert_cmpuint(fired.size(), ==, 1);
+      g_assert_cmpint(fired[0], ==, 1);
+    }
+    g_test_dbus_down(bus);
+  }
+
+  // Only the plugin attached last may change the schedules of the helper.
+  void TestRejectsCallsOfOtherPeers() {
+    g_autoptr(GTestDBus) bus = g_test_dbus_new(G_TEST_DBUS_NONE);
+    g_test_dbus_up(bus);
+    {
+      FakeNotificationServer server(bus);
+      std::vector<std::int64_t> fired;
+      auto exited = false;
+      g_autoptr(GDBusConnection) session = g_bus_get_sync(G_BUS_TYPE_SESSION, nullptr, nullptr);
+      const auto pid = SpawnHelper(session, exited);
+      const auto client = NewClient(fired);
+      client->attach();
+      g_assert_true(client->isAttached());
+
+      g_autoptr(GError) error = nullptr;
+      g_autoptr(GDBusConnection) other = g_dbus_connection_new_for_address_sync(g_test_dbus_get_bus_address(bus),
+        static_cast<GDBusConnectionFlags>(G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT | G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION),
+        nullptr, nullptr, &error);
+      g_assert_no_error(error);
+      g_autoptr(GVariant) reply = g_dbus_connection_call_sync(other, SchedulerHelperBusName(Application).data(),
+        SchedulerHelperObjectPath, SchedulerHelperInterface, "CancelAll", nullptr, nullptr, G_DBUS_CALL_FLAGS_NONE, -1, nullptr,
+        &error);
+      g_assert_null(reply);
+      g_assert_error(error, G_DBUS_ERROR, G_DBUS_ERROR_ACCESS_DENIED);
+
+      kill(pid, SIGTERM);
+      IterateUntil(exited);
+      g_dbus_connection_close_sync(other, nullptr, nullptr);
+      g_dbus_connection_close_sync(session, nullptr, nullptr);
+    }
+    g_test_dbus_down(bus);
+  }
+}
+
+int main(int argc, char** argv) {
+  // the helper records fired notifications in the data directory, which it inherits
+  g_test_init(&argc, &argv, G_TEST_OPTION_ISOLATE_DIRS, nullptr);
+  g_test_add_func("/scheduler_helper/fired_is_kept_after_helper_exits", TestFiredIsKeptAfterHelperExits);
+  g_test_add_func("/scheduler_helper/rejects_calls_of_other_peers", TestRejectsCallsOfOtherPeers);
+  return g_test_run();
+}
@@ -0,0 +1,81 @@
+#include <gio/gio.h>
+
+#include "../sleep_monitor.h"
+
+namespace {
+  using flutter_local_notifications::SleepMonitor;
+
+  // Stands in for logind on a bus of GTestDBus, which becomes the system bus of the process.
+  class FakeLogind {
+  public:
+    explicit FakeLogind(GTestDBus* bus) {
+      g_autoptr(GError) error = nullptr;
+      connection = g_dbus_connection_new_for_address_sync(g_test_dbus_get_bus_address(bus),
+        static_cast<GDBusConnectionFlags>(G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT | G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION),
+        nullptr, nullptr, &error);
+      g_assert_no_error(error);
+      g_autoptr(GVariant) reply = g_dbus_connection_call_sync(connection, "org.freedesktop.DBus", "/org/freedesktop/DBus",
+        "org.freedesktop.DBus", "RequestName", g_variant_new("(su)", "org.freedesktop.login1", 0u), G_VARIANT_TYPE("(u)"),
+        G_DBUS_CALL_FLAGS_NONE, -1, nullptr, &error);
+      g_assert_no_error(error);
+    }
+
+    ~FakeLogind() {
+      g_dbus_connection_close_sync(connection, nullptr, nullptr);
+      g_object_unref(connection);
+    }
+
+    FakeLogind(const FakeLogind&) = delete;
+    FakeLogind& operator=(const FakeLogind&) = delete;
+
+    void emitPrepareForSleep(gboolean start) {
+      g_autoptr(GError) error = nullptr;
+      g_dbus_connection_emit_signal(connection, nullptr, "/org/freedesktop/login1", "org.freedesktop.login1.Manager",
+        "PrepareForSleep", g_variant_new("(b)", start), &error);
+      g_assert_no_error(error);
+      g_dbus_connection_flush_sync(connection, nullptr, &error);
+    }
+
+  private:
+    GDBusConnection* connection;
+  };
+
+  void TestReportsResume() {
+    g_autoptr(GTestDBus) bus = g_test_dbus_new(G_TEST_DBUS_NONE);
+    g_test_dbus_up(bus);
+    g_setenv("DBUS_SYSTEM_BUS_ADDRESS", g_test_dbus_get_bus_address(bus), TRUE);
+    {
+      FakeLogind logind(bus);
+      auto resumes = 0;
+      SleepMonitor monitor([&resumes]() {
+        ++resumes;
+      });
+      while (!monitor.isConnected()) {
+        g_main_context_iteration(nullptr, TRUE);
+      }
+      // the bus has handled the subscription of the monitor once it answers a later call
+      g_autoptr(GDBusConnection) system = g_bus_get_sync(G_BUS_TYPE_SYSTEM, nullptr, nullptr);
+      g_autoptr(GVariant) id = g_dbus_connection_call_sync(system, "org.freedesktop.DBus", "/org/freedesktop/DBus",
+        "org.freedesktop.DBus", "GetId", nullptr, G_VARIANT_TYPE("(s)"), G_DBUS_CALL_FLAGS_NONE, -1, nullptr, nullptr);
+      g_assert_nonnull(id);
+
+      // going to sleep is not a resume, and arrives before the resume
+      logind.emitPrepareForSleep(TRUE);
+      logind.emitPrepareForSleep(FALSE);
+      while (resumes == 0) {
+        g_main_context_iteration(nullptr, TRUE);
+      }
+      g_assert_cmpint(resumes, ==, 1);
+
+      // closed here, as the bus going away would terminate the process otherwise
+      g_dbus_connection_close_sync(system, nullptr, nullptr);
+    }
+    g_test_dbus_down(bus);
+  }
+}
+
+int main(int argc, char** argv) {
+  g_test_init(&argc, &argv, nullptr);
+  g_test_add_func("/sleep_monitor/reports_resume", TestReportsResume);
+  return g_test_run();
+}
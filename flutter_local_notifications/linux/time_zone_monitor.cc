@@ -0,0 +1,128 @@
+#include "time_zone_monitor.h"
+
+#include <cstring>
+#include <string_view>
+#include <utility>
+
+namespace flutter_local_notifications {
+  namespace {
+    inline constexpr const char LocalTimePath[] = "/etc/localtime";
+    // Debian and derivatives also name the zone here, in case /etc/localtime is a copy
+    inline constexpr const char TimeZonePath[] = "/etc/timezone";
+    inline constexpr const char BusName[] = "org.freedesktop.timedate1";
+    inline constexpr const char ObjectPath[] = "/org/freedesktop/timedate1";
+    inline constexpr const char InterfaceName[] = "org.freedesktop.timedate1";
+    // /etc/localtime is usually replaced by a rename, which is reported as several events
+    inline constexpr guint CheckDelayMs = 100;
+
+    std::string_view StripPrefix(std::string_view value, std::string_view prefix) {
+      return value.substr(0, prefix.size()) == prefix ? value.substr(prefix.size()) : value;
+    }
+  }
+
+  std::string SystemTimeZoneName() {
+    g_autofree gchar* target = g_file_read_link(LocalTimePath, nullptr);
+    if (target) {
+      // like /usr/share/zoneinfo/Europe/Berlin, or relative to /etc
+      if (const auto zoneInfo = std::strstr(target, "zoneinfo/")) {
+        std::string_view name(zoneInfo + std::strlen("zoneinfo/"));
+        name = StripPrefix(StripPrefix(name, "posix/"), "right/");
+        return std::string(name);
+      }
+    }
+    g_autofree gchar* contents = nullptr;
+    if (g_file_get_contents(TimeZonePath, &contents, nullptr, nullptr)) {
+      return g_strstrip(contents);
+    }
+    return {};
+  }
+
+  TimeZoneMonitor::TimeZoneMonitor(ChangeCallback onChange)
+    : on_change(std::move(onChange)), name(SystemTimeZoneName()), cancellable(g_cancellable_new()) {
+    g_autoptr(GFile) file = g_file_new_for_path(LocalTimePath);
+    g_autoptr(GError) error = nullptr;
+    file_monitor = g_file_monitor_file(file, G_FILE_MONITOR_WATCH_MOVES, cancellable, &error);
+    if (file_monitor) {
+      g_signal_connect(file_monitor, "changed", G_CALLBACK(onFileChanged), this);
+    } else {
+      g_debug("Failed to monitor %s: %s", LocalTimePath, error->message);
+    }
+    g_bus_get(G_BUS_TYPE_SYSTEM, cancellable, onBusReady, this);
+  }
+
+  TimeZoneMonitor::~TimeZoneMonitor() {
+    // pending callbacks see the cancellation and do not touch this anymore
+    g_cancellable_cancel(cancellable);
+    if (check_source) {
+      g_source_remove(check_source);
+    }
+    if (file_monitor) {
+      g_signal_handlers_disconnect_by_data(file_monitor, this);
+      g_object_unref(file_monitor);
+    }
+    if (connection) {
+      g_dbus_connection_signal_unsubscribe(connection, subscription);
+      g_object_unref(connection);
+    }
+    g_object_unref(cancellable);
+  }
+
+  void TimeZoneMonitor::scheduleCheck() {
+    if (check_source) {
+      return;
+    }
+    check_source = g_timeout_add(CheckDelayMs, [](gpointer data) -> gboolean {
+      const auto self = static_cast<TimeZoneMonitor*>(data);
+      self->check_source = 0;
+      self->check();
+      return G_SOURCE_REMOVE;
+    }, this);
+  }
+
+  void TimeZoneMonitor::check() {
+    auto current = SystemTimeZoneName();
+    // empty while /etc/localtime is being replaced
+    if (current.empty() || current == name) {
+      return;
+    }
+    name = std::move(current);
+    on_change(name);
+  }
+
+  void TimeZoneMonitor::onFileChanged(GFileMonitor* monitor, GFile* file, GFile* otherFile, GFileMonitorEvent event, gpointer data) {
+    if (event != G_FILE_MONITOR_EVENT_ATTRIBUTE_CHANGED) {
+      static_cast<TimeZoneMonitor*>(data)->scheduleCheck();
+    }
+  }
+
+  void TimeZoneMonitor::onBusReady(GObject* source, GAsyncResult* result, gpointer data) {
+    g_autoptr(GError) error = nullptr;
+    const auto connection = g_bus_get_finish(result, &error);
+    if (!connection) {
+      if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        g_debug("Failed to connect to system bus, only %s is monitored for time zone changes: %s", LocalTimePath, error->message);
+      }
+      return;
+    }
+
+    const auto self = static_cast<TimeZoneMonitor*>(data);
+    self->connection = connection;
+    self->subscription = g_dbus_connection_signal_subscribe(connection, BusName, "org.freedesktop.DBus.Properties",
+      "PropertiesChanged", ObjectPath, InterfaceName, G_DBUS_SIGNAL_FLAGS_NONE, onSignal, self, nullptr);
+  }
+
+  void TimeZoneMonitor::onSignal(GDBusConnection* connection, const gchar* sender, const gchar* path, const gchar* interface,
+    const gchar* signal, GVariant* parameters, gpointer data) {
+    if (!g_variant_is_of_type(parameters, G_VARIANT_TYPE("(sa{sv}as)"))) {
+      return;
+    }
+    g_autoptr(GVariant) changed = g_variant_get_child_value(parameters, 1);
+    g_autoptr(GVariant) value = g_variant_lookup_value(changed, "Timezone", nullptr);
+    g_autoptr(GVariant) invalidated = g_variant_get_child_value(parameters, 2);
+    g_autofree const gchar** invalidatedNames = g_variant_get_strv(invalidated, nullptr);
+    if (value || g_strv_contains(invalidatedNames, "Timezone")) {
+      // timedated has already replaced /etc/localtime by then
+      static_cast<TimeZoneMonitor*>(data)->scheduleCheck();
+    }
+  }
+}
@@ -0,0 +1,53 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_TIME_ZONE_MONITOR_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_TIME_ZONE_MONITOR_H_
+
+#include <gio/gio.h>
+#include <functional>
+#include <string>
+
+namespace flutter_local_notifications {
+  // Returns the tzdata identifier of the system time zone, like "Europe/Berlin", or an
+  // empty string if it is not known.
+  std::string SystemTimeZoneName();
+
+  // Reports changes of the system time zone, which are noticed by a monitor of
+  // /etc/localtime and by timedated announcing its Timezone property on the system bus.
+  // Both usually see the same change, so they only make the monitor check the zone a bit
+  // later, and the change is reported once.
+  class TimeZoneMonitor {
+  public:
+    using ChangeCallback = std::function<void(const std::string& name)>;
+
+    explicit TimeZoneMonitor(ChangeCallback onChange);
+    ~TimeZoneMonitor();
+
+    TimeZoneMonitor(const TimeZoneMonitor&) = delete;
+    TimeZoneMonitor& operator=(const TimeZoneMonitor&) = delete;
+
+    // last name reported, or the one of the zone when the monitor was created
+    const std::string& getName() const {
+      return name;
+    }
+
+  private:
+    ChangeCallback on_change;
+    std::string name;
+    GCancellable* cancellable;
+    // null if /etc/localtime cannot be monitored
+    GFileMonitor* file_monitor;
+    // null until the bus is connected
+    GDBusConnection* connection = nullptr;
+    guint subscription = 0;
+    guint check_source = 0;
+
+    void scheduleCheck();
+    void check();
+
+    static void onFileChanged(GFileMonitor* monitor, GFile* file, GFile* otherFile, GFileMonitorEvent event, gpointer data);
+    static void onBusReady(GObject* source, GAsyncResult* result, gpointer data);
+    static void onSignal(GDBusConnection* connection, const gchar* sender, const gchar* path, const gchar* interface,
+      const gchar* signal, GVariant* parameters, gpointer data);
+  };
+}
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_TIME_ZONE_MONITOR_H_
@@ -0,0 +1,105 @@
+#include "trace_buffer.h"
+
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+
+namespace flutter_local_notifications {
+  namespace {
+    inline constexpr const char Category[] = "flutter_local_notifications";
+
+    void AppendJsonString(std::string& json, std::string_view value) {
+      json.push_back('"');
+      for (const auto c : value) {
+        if (c == '"' || c == '\\') {
+          json.push_back('\\');
+          json.push_back(c);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+          char escaped[7];
+          std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+          json.append(escaped);
+        } else {
+          json.push_back(c);
+        }
+      }
+      json.push_back('"');
+    }
+  }
+
+  TraceBuffer::TraceBuffer(std::size_t capacity) : ring(std::max<std::size_t>(capacity, 1)) {
+  }
+
+  void TraceBuffer::complete(std::string_view name, std::int64_t id, gint64 start, gint64 deadline) {
+    const auto end = g_get_monotonic_time();
+    auto& event = append();
+    event.time = start;
+    event.duration = end - start;
+    event.id = id;
+    event.deadline = deadline;
+    event.name = intern(name);
+    event.phase = TraceEvent::Phase::Complete;
+  }
+
+  void TraceBuffer::instant(std::string_view name, std::int64_t id, gint64 deadline) {
+    auto& event = append();
+    event.time = g_get_monotonic_time();
+    event.duration = 0;
+    event.id = id;
+    event.deadline = deadline;
+    event.name = intern(name);
+    event.phase = TraceEvent::Phase::Instant;
+  }
+
+  const char* TraceBuffer::intern(std::string_view name) {
+    auto iter = names.find(name);
+    if (iter == names.end()) {
+      // null terminated, as names are exported through const char*
+      iter = names.emplace(name_storage.emplace_back(name)).first;
+    }
+    return iter->data();
+  }
+
+  TraceEvent& TraceBuffer::append() {
+    if (count == ring.size()) {
+      // overwrite the oldest event
+      head = (head + 1) % ring.size();
+      --count;
+      ++dropped;
+    }
+    ++count;
+    return ring[(head + count - 1) % ring.size()];
+  }
+
+  std::string TraceBuffer::toChromeTraceJson() const {
+    // events are recorded by the main thread, whose id is the one of the process
+    const auto pid = std::to_string(getpid());
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    json.reserve(json.size() + count * 160);
+    for (std::size_t i = 0; i < count; ++i) {
+      const auto& event = ring[(head + i) % ring.size()];
+      if (i > 0) {
+        json.push_back(',');
+      }
+      json.append("\n{\"name\":");
+      AppendJsonString(json, event.name);
+      json.append(",\"cat\":\"").append(Category).append("\",\"ph\":\"").push_back(static_cast<char>(event.phase));
+      json.append("\",\"ts\":").append(std::to_string(event.time));
+      if (event.phase == TraceEvent::Phase::Complete) {
+        json.append(",\"dur\":").append(std::to_string(event.duration));
+      } else {
+        json.append(",\"s\":\"t\"");
+      }
+      json.append(",\"pid\":").append(pid).append(",\"tid\":").append(pid);
+      json.append(",\"args\":{");
+      if (event.id != NoId) {
+        json.append("\"id\":").append(std::to_string(event.id));
+      }
+      if (event.deadline != 0) {
+        json.append(event.id != NoId ? "," : "").append("\"deadline\":").append(std::to_string(event.deadline));
+      }
+      json.append("}}");
+    }
+    json.append("\n],\"otherData\":{\"droppedEvents\":\"").append(std::to_string(dropped)).append("\"}}\n");
+    return json;
+  }
+}
@@ -0,0 +1,106 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_TRACE_BUFFER_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_TRACE_BUFFER_H_
+
+#include <glib.h>
+#include <cstddef>
+#include <deque>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace flutter_local_notifications {
+  // Lifecycle event of a notification, see TraceBuffer.
+  struct TraceEvent {
+    enum class Phase : char {
+      // has a duration, like a method call from its begin to its end
+      Complete = 'X',
+      Instant = 'i',
+    };
+
+    // in microseconds of monotonic time, see g_get_monotonic_time
+    gint64 time;
+    // in microseconds, for Phase::Complete
+    gint64 duration;
+    // TraceBuffer::NoId if the event is not about a notification
+    std::int64_t id;
+    // deadline the event is about in microseconds of real time, 0 if none
+    gint64 deadline;
+    // owned by the TraceBuffer
+    const char* name;
+    Phase phase;
+  };
+
+  // Ring of the last capacity TraceEvents, which overwrites the oldest event once it is
+  // full. Events are exported in the JSON format of Chrome's trace viewer, which Perfetto
+  // loads as well. Their timestamps are from the monotonic clock like the ones of Flutter's
+  // timeline, so that both line up when loaded together.
+  class TraceBuffer {
+  public:
+    static constexpr std::int64_t NoId = std::numeric_limits<std::int64_t>::min();
+
+    explicit TraceBuffer(std::size_t capacity);
+
+    TraceBuffer(const TraceBuffer&) = delete;
+    TraceBuffer& operator=(const TraceBuffer&) = delete;
+
+    void complete(std::string_view name, std::int64_t id, gint64 start, gint64 deadline = 0);
+    void instant(std::string_view name, std::int64_t id, gint64 deadline = 0);
+
+    // Returns the events from oldest to newest as a Chrome trace JSON object.
+    std::string toChromeTraceJson() const;
+
+    std::size_t size() const {
+      return count;
+    }
+
+    // events overwritten since the buffer was created
+    std::uint64_t getDropped() const {
+      return dropped;
+    }
+
+  private:
+    // the oldest event is at head
+    std::vector<TraceEvent> ring;
+    std::size_t head = 0;
+    std::size_t count = 0;
+    std::uint64_t dropped = 0;
+    // names of events, which are mostly the few method names. They are looked up by view, so
+    // that recording an event with a known name does not allocate, and refer to name_storage,
+    // whose elements never move.
+    std::unordered_set<std::string_view> names;
+    std::deque<std::string> name_storage;
+
+    const char* intern(std::string_view name);
+    TraceEvent& append();
+  };
+
+  // Records the time from its construction to its destruction as a TraceEvent, if it has a
+  // buffer.
+  class TraceScope {
+  public:
+    TraceScope(TraceBuffer* buffer, std::string_view name, std::int64_t id = TraceBuffer::NoId, gint64 deadline = 0)
+      : buffer(buffer), name(name), id(id), deadline(deadline), start(buffer ? g_get_monotonic_time() : 0) {
+    }
+
+    ~TraceScope() {
+      if (buffer) {
+        buffer->complete(name, id, start, deadline);
+      }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+  private:
+    TraceBuffer* buffer;
+    std::string_view name;
+    std::int64_t id;
+    gint64 deadline;
+    gint64 start;
+  };
+}
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_TRACE_BUFFER_H_
@@ -0,0 +1,196 @@
+#include "update_coalescer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace flutter_local_notifications {
+  namespace {
+    inline constexpr std::uint64_t FnvOffsetBasis = 14695981039346656037ull;
+    inline constexpr std::uint64_t FnvPrime = 1099511628211ull;
+
+    std::uint64_t HashBytes(std::uint64_t hash, const void* data, std::size_t size) {
+      const auto bytes = static_cast<const unsigned char*>(data);
+      for (std::size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * FnvPrime;
+      }
+      return hash;
+    }
+
+    template <typename T>
+    std::uint64_t HashScalar(std::uint64_t hash, T value) {
+      return HashBytes(hash, &value, sizeof(value));
+    }
+
+    // FNV-1a, prefixed with the type and length of each value so that nested values
+    // cannot collide by concatenation
+    std::uint64_t HashValue(std::uint64_t hash, FlValue* value) {
+      const auto type = fl_value_get_type(value);
+      hash = HashScalar(hash, static_cast<int>(type));
+      switch (type) {
+      case FL_VALUE_TYPE_BOOL:
+        return HashScalar(hash, fl_value_get_bool(value));
+      case FL_VALUE_TYPE_INT:
+        return HashScalar(hash, fl_value_get_int(value));
+      case FL_VALUE_TYPE_FLOAT:
+        return HashScalar(hash, fl_value_get_float(value));
+      case FL_VALUE_TYPE_STRING: {
+        const auto string = fl_value_get_string(value);
+        const auto length = std::strlen(string);
+        return HashBytes(HashScalar(hash, length), string, length);
+      }
+      case FL_VALUE_TYPE_UINT8_LIST:
+        return HashBytes(HashScalar(hash, fl_value_get_length(value)), fl_value_get_uint8_list(value), fl_value_get_length(value));
+      case FL_VALUE_TYPE_INT32_LIST:
+        return HashBytes(HashScalar(hash, fl_value_get_length(value)), fl_value_get_int32_list(value), fl_value_get_length(value) * sizeof(int32_t));
+      case FL_VALUE_TYPE_INT64_LIST:
+        return HashBytes(HashScalar(hash, fl_value_get_length(value)), fl_value_get_int64_list(value), fl_value_get_length(value) * sizeof(int64_t));
+      case FL_VALUE_TYPE_FLOAT_LIST:
+        return HashBytes(HashScalar(hash, fl_value_get_length(value)), fl_value_get_float_list(value), fl_value_get_length(value) * sizeof(double));
+      case FL_VALUE_TYPE_LIST:
+        hash = HashScalar(hash, fl_value_get_length(value));
+        for (std::size_t i = 0, size = fl_value_get_length(value); i < size; ++i) {
+          hash = HashValue(hash, fl_value_get_list_value(value, i));
+        }
+        return hash;
+      case FL_VALUE_TYPE_MAP:
+        hash = HashScalar(hash, fl_value_get_length(value));
+        for (std::size_t i = 0, size = fl_value_get_length(value); i < size; ++i) {
+          hash = HashValue(hash, fl_value_get_map_key(value, i));
+          hash = HashValue(hash, fl_value_get_map_value(value, i));
+        }
+        return hash;
+      default:
+        return hash;
+      }
+    }
+  }
+
+  std::uint64_t ValueDigest(FlValue* value) {
+    return HashValue(FnvOffsetBasis, value);
+  }
+
+  UpdateCoalescer::UpdateCoalescer(SendCallback send, gint64 window) : send(std::move(send)), window(window) {
+  }
+
+  UpdateCoalescer::~UpdateCoalescer() {
+    if (timer_source_id) {
+      g_source_remove(timer_source_id);
+    }
+    clear();
+  }
+
+  void UpdateCoalescer::setWindow(gint64 newWindow) {
+    window = newWindow;
+    // due times depend on window
+    decltype(deadlines) rebuilt;
+    for (const auto& [id, slot] : slots) {
+      if (slot.held) {
+        rebuilt.emplace(slot.lastSent + window, id);
+      }
+    }
+    deadlines.swap(rebuilt);
+    if (timer_source_id) {
+      g_source_remove(std::exchange(timer_source_id, 0));
+    }
+    flush();
+  }
+
+  void UpdateCoalescer::submit(std::int64_t id, FlValue* arguments) {
+    ++stats.received;
+    const auto digest = ValueDigest(arguments);
+    const auto now = g_get_monotonic_time();
+    const auto [iter, inserted] = slots.try_emplace(id);
+    auto& slot = iter->second;
+    if (inserted) {
+      dispatch(id, slot, arguments, digest, now);
+      return;
+    }
+
+    if (slot.held) {
+      ++stats.coalesced;
+      dropHeld(slot);
+    }
+    if (digest == slot.sentDigest) {
+      ++stats.unchanged;
+      return;
+    }
+    if (now - slot.lastSent >= window) {
+      dispatch(id, slot, arguments, digest, now);
+      return;
+    }
+    slot.held = fl_value_ref(arguments);
+    slot.heldDigest = digest;
+    ++held_count;
+    deadlines.emplace(slot.lastSent + window, id);
+    arm();
+  }
+
+  void UpdateCoalescer::remove(std::int64_t id) {
+    const auto iter = slots.find(id);
+    if (iter == slots.end()) {
+      return;
+    }
+    // its deadline is left stale
+    dropHeld(iter->second);
+    slots.erase(iter);
+  }
+
+  void UpdateCoalescer::clear() {
+    for (auto& [id, slot] : slots) {
+      dropHeld(slot);
+    }
+    slots.clear();
+    deadlines = decltype(deadlines)();
+  }
+
+  void UpdateCoalescer::dispatch(std::int64_t id, Slot& slot, FlValue* arguments, std::uint64_t digest, gint64 now) {
+    slot.lastSent = now;
+    slot.sentDigest = digest;
+    ++stats.sent;
+    // may call back into remove or submit, so slot must not be used afterwards
+    send(id, arguments);
+  }
+
+  void UpdateCoalescer::dropHeld(Slot& slot) {
+    if (slot.held) {
+      fl_value_unref(slot.held);
+      slot.held = nullptr;
+      --held_count;
+    }
+  }
+
+  void UpdateCoalescer::arm() {
+    if (timer_source_id || deadlines.empty()) {
+      return;
+    }
+    const auto delay = std::max<gint64>(deadlines.top().first - g_get_monotonic_time(), 0);
+    timer_source_id = g_timeout_add_full(G_PRIORITY_DEFAULT, static_cast<guint>((delay + 999) / 1000), [](gpointer p) -> gboolean {
+      const auto self = static_cast<UpdateCoalescer*>(p);
+      self->timer_source_id = 0;
+      self->flush();
+      return G_SOURCE_REMOVE;
+    }, this, nullptr);
+  }
+
+  void UpdateCoalescer::flush() {
+    const auto now = g_get_monotonic_time();
+    while (!deadlines.empty() && deadlines.top().first <= now) {
+      const auto [due, id] = deadlines.top();
+      deadlines.pop();
+      const auto iter = slots.find(id);
+      if (iter == slots.end() || !iter->second.held || iter->second.lastSent + window != due) {
+        continue;
+      }
+      auto& slot = iter->second;
+      g_autoptr(FlValue) arguments = std::exchange(slot.held, nullptr);
+      --held_count;
+      // changed back to what was last sent while held
+      if (slot.heldDigest == slot.sentDigest) {
+        ++stats.unchanged;
+        continue;
+      }
+      dispatch(id, slot, arguments, slot.heldDigest, now);
+    }
+    arm();
+  }
+}
@@ -0,0 +1,88 @@
+#ifndef FLUTTER_LOCAL_NOTIFICATIONS_UPDATE_COALESCER_H_
+#define FLUTTER_LOCAL_NOTIFICATIONS_UPDATE_COALESCER_H_
+
+#include <flutter_linux/flutter_linux.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace flutter_local_notifications {
+  // Digest of the type and content of value, including the values it contains.
+  std::uint64_t ValueDigest(FlValue* value);
+
+  // Coalesces updates of the same notification, so that each id is sent at most once per
+  // window and only if its arguments have changed since it was last sent.
+  class UpdateCoalescer {
+  public:
+    using SendCallback = std::function<void(std::int64_t id, FlValue* arguments)>;
+
+    struct Stats {
+      std::uint64_t received;
+      std::uint64_t sent;
+      // updates replaced by a later update of the same id before being sent
+      std::uint64_t coalesced;
+      // updates dropped as they were equal to the arguments last sent
+      std::uint64_t unchanged;
+    };
+
+    // window is in microseconds, 0 to only drop unchanged updates.
+    UpdateCoalescer(SendCallback send, gint64 window);
+    ~UpdateCoalescer();
+
+    UpdateCoalescer(const UpdateCoalescer&) = delete;
+    UpdateCoalescer& operator=(const UpdateCoalescer&) = delete;
+
+    void setWindow(gint64 newWindow);
+
+    gint64 getWindow() const {
+      return window;
+    }
+
+    // Sends arguments of id at once if id was last sent at least window ago, otherwise
+    // holds them until then, replacing the update already held.
+    void submit(std::int64_t id, FlValue* arguments);
+    // Forgets id, its held update is dropped and its next update is sent at once.
+    void remove(std::int64_t id);
+    void clear();
+
+    std::size_t heldCount() const {
+      return held_count;
+    }
+
+    const Stats& getStats() const {
+      return stats;
+    }
+
+  private:
+    struct Slot {
+      gint64 lastSent = 0;
+      std::uint64_t sentDigest = 0;
+      // update waiting for the window to pass, null if none
+      FlValue* held = nullptr;
+      std::uint64_t heldDigest = 0;
+    };
+
+    // due time and id of held updates, stale ones are skipped
+    using Deadline = std::pair<gint64, std::int64_t>;
+
+    SendCallback send;
+    gint64 window;
+    Stats stats = {};
+
+    std::unordered_map<std::int64_t, Slot> slots;
+    std::priority_queue<Deadline, std::vector<Deadline>, std::greater<>> deadlines;
+    std::size_t held_count = 0;
+    guint timer_source_id = 0;
+
+    void dispatch(std::int64_t id, Slot& slot, FlValue* arguments, std::uint64_t digest, gint64 now);
+    void dropHeld(Slot& slot);
+    void arm();
+    void flush();
+  };
+}
+
+#endif  // FLUTTER_LOCAL_NOTIFICATIONS_UPDATE_COALESCER_H_
@@ -1,9 +1,11 @@
+import 'dart:io' show File;
 import 'dart:typed_data';
 import 'dart:ui';
 import 'package:flutter/foundation.dart';
 import 'package:flutter/services.dart';
 import 'package:flutter_local_notifications/flutter_local_notifications.dart';
 import 'package:flutter_local_notifications/src/platform_specifics/android/enums.dart';
+import 'package:flutter_local_notifications/src/platform_specifics/linux/binary_codec.dart';
 import 'package:flutter_test/flutter_test.dart';
 import 'package:platform/platform.dart';
 import 'package:timezone/data/latest.dart' as tz;
@@ -2640,6 +2642,440 @@ void main() {
       ]);
     });
   });
+
+  group('Linux', () {
+    const MethodChannel channel =
+        MethodChannel('dexterous.com/flutter/local_notifications');
+    const String binaryChannelName =
+        'dexterous.com/flutter/local_notifications/binary';
+    final List<MethodCall> log = <MethodCall>[];
+    final List<Uint8List> binaryLog = <Uint8List>[];
+    LinuxFlutterLocalNotificationsPlugin linuxPlugin;
+    _RecordingLinuxNotificationNotifier notifier;
+
+    // Fails the second request of each batch, like the plugin does for
+    // invalid requests.
+    List<Object> batchResults(List<dynamic> requests) =>
+        List<Object>.generate(
+            requests.length,
+            (int i) => i == 1
+                ? <String, Object>{
+                    'code': 'invalid_request',
+                    'message': 'request $i is invalid',
+                    'details': null,
+                  }
+                : null);
+
+    setUp(() {
+      flutterLocalNotificationsPlugin = FlutterLocalNotificationsPlugin.private(
+          FakePlatform(operatingSystem: 'linux'));
+      linuxPlugin =
+          flutterLocalNotificationsPlugin.resolvePlatformSpecificImplementation<
+              LinuxFlutterLocalNotificationsPlugin>();
+      notifier = _RecordingLinuxNotificationNotifier();
+      // ignore: always_specify_types
+      channel.setMockMethodCallHandler((methodCall) async {
+        log.add(methodCall);
+        switch (methodCall.method) {
+          case 'showBatch':
+          case 'zonedScheduleBatch':
+          case 'cancelBatch':
+            return batchResults(methodCall.arguments);
+          case 'cancelAll':
+            return Int64List.fromList(<int>[1, 2]);
+          case 'getAdmissionStats':
+            return <String, Object>{
+              'queued': 1,
+              'sent': 2,
+              'deferred': 3,
+              'dropped': 4,
+            };
+          case 'getStats':
+            return <String, Object>{
+              'enabled': true,
+              'dropped': 4,
+              'gauges': <String, Object>{
+                'active': 5,
+                'scheduled': 6,
+                'repeating': 7,
+                'queued': 1,
+                'inFlight': 0,
+              },
+              'methods': <String, Object>{
+                'show': <String, Object>{
+                  'unit': 'ns',
+                  'count': 2,
+                  'sum': 3000,
+                  'max': 2000,
+                  'buckets': <int>[0, 0, 2],
+                },
+              },
+              'send': null,
+              'fireLateness': null,
+            };
+        }
+        return null;
+      });
+      ServicesBinding.instance.defaultBinaryMessenger
+          .setMockMessageHandler(binaryChannelName, (ByteData message) async {
+        binaryLog.add(message.buffer
+            .asUint8List(message.offsetInBytes, message.lengthInBytes));
+        return ByteData(0);
+      });
+    });
+
+    tearDown(() {
+      log.clear();
+      binaryLog.clear();
+      ServicesBinding.instance.defaultBinaryMessenger
+          .setMockMessageHandler(binaryChannelName, null);
+    });
+
+    test('initialize with default parameter values', () async {
+      const InitializationSettings initializationSettings =
+          InitializationSettings(linux: LinuxInitializationSettings());
+      await flutterLocalNotificationsPlugin.initialize(initializationSettings);
+      expect(log, <Matcher>[
+        isMethodCall('initialize', arguments: <String, Object>{
+          'defaultIcon': null,
+          'knownShowingNotifications': null,
+          'admission': null,
+          'backend': LinuxNotificationBackend.gApplication.index,
+          'iconSize': null,
+          'updateCoalescingWindow': null,
+          'schedulerHelper': false,
+          'misfireThreshold': null,
+          'misfireSummary': null,
+          'activeLimit': null,
+          'followSystemTimeZone': true,
+          'traceEventCapacity': null,
+        })
+      ]);
+    });
+
+    test('show with Linux-specific details', () async {
+      await flutterLocalNotificationsPlugin.initialize(InitializationSettings(
+          linux: LinuxInitializationSettings(notificationNotifier: notifier)));
+      const NotificationDetails notificationDetails = NotificationDetails(
+          linux: LinuxNotificationDetails(
+        icon: ThemeLinuxIcon('mail-unread'),
+        buttons: <LinuxNotificationButton>{
+          LinuxNotificationButton(label: 'Reply', payload: 'reply'),
+        },
+        priority: LinuxNotificationPriority.high,
+        misfirePolicy: LinuxMisfirePolicy.skip,
+        groupKey: 'inbox',
+      ));
+      await flutterLocalNotificationsPlugin.show(
+          1, 'notification title', 'notification body', notificationDetails);
+      expect(
+          log.last,
+          isMethodCall('show', arguments: <String, Object>{
+            'id': 1,
+            'title': 'notification title',
+            'body': 'notification body',
+            'payload': '',
+            'platformSpecifics': <String, Object>{
+              'icon': <String, Object>{
+                'icon': 'mail-unread',
+                'iconSource': LinuxIconSource.theme.index,
+              },
+              'buttons': <Map<String, Object>>[
+                <String, Object>{
+                  'buttonLabel': 'Reply',
+                  'payload': 'reply',
+                },
+              ],
+              'priority': LinuxNotificationPriority.high.index,
+              'misfirePolicy': LinuxMisfirePolicy.skip.index,
+              'groupKey': 'inbox',
+            },
+          }));
+      expect(notifier.created, <int>[1]);
+    });
+
+    test('show through the binary channel', () async {
+      await flutterLocalNotificationsPlugin.initialize(
+          const InitializationSettings(
+              linux: LinuxInitializationSettings(useBinaryChannel: true)));
+      await flutterLocalNotificationsPlugin.show(
+          1, 'T', null, null, payload: 'p');
+      expect(log.map((MethodCall c) => c.method), <String>['initialize']);
+      expect(binaryLog, <List<int>>[
+        <int>[
+          1, 1, 0, 0, 0, // show 1
+          1, 0, 0, 0, 84, 0, // 'T'
+          255, 255, 255, 255, // null body
+          1, 0, 0, 0, 112, 0, // 'p'
+          0, 0, // no details and buttons
+        ]
+      ]);
+    });
+
+    test('update', () async {
+      await linuxPlugin.initialize(
+          LinuxInitializationSettings(notificationNotifier: notifier));
+      await linuxPlugin.update(2, 'downloading', '50%', payload: 'download');
+      expect(
+          log.last,
+          isMethodCall('update', arguments: <String, Object>{
+            'id': 2,
+            'title': 'downloading',
+            'body': '50%',
+            'payload': 'download',
+            'platformSpecifics': null,
+          }));
+      expect(notifier.created, <int>[2]);
+    });
+
+    test('showBatch', () async {
+      await linuxPlugin.initialize(
+          LinuxInitializationSettings(notificationNotifier: notifier));
+      final List<PlatformException> errors =
+          await linuxPlugin.showBatch(const <LinuxNotificationRequest>[
+        LinuxNotificationRequest(1, 'first title', 'first body'),
+        LinuxNotificationRequest(2, 'second title', null, payload: 'second'),
+        LinuxNotificationRequest(3, 'third title', 'third body',
+            notificationDetails: LinuxNotificationDetails(groupKey: 'g')),
+      ]);
+      expect(
+          log.last,
+          isMethodCall('showBatch', arguments: <Map<String, Object>>[
+            <String, Object>{
+              'id': 1,
+              'title': 'first title',
+              'body': 'first body',
+              'payload': '',
+              'platformSpecifics': null,
+            },
+            <String, Object>{
+              'id': 2,
+              'title': 'second title',
+              'body': null,
+              'payload': 'second',
+              'platformSpecifics': null,
+            },
+            <String, Object>{
+              'id': 3,
+              'title': 'third title',
+              'body': 'third body',
+              'payload': '',
+              'platformSpecifics': <String, Object>{
+                'icon': null,
+                'buttons': null,
+                'priority': null,
+                'misfirePolicy': null,
+                'groupKey': 'g',
+              },
+            },
+          ]));
+      expect(errors, hasLength(3));
+      expect(errors[0], isNull);
+      expect(errors[1].code, 'invalid_request');
+      expect(errors[1].message, 'request 1 is invalid');
+      expect(errors[2], isNull);
+      expect(notifier.created, <int>[1, 3]);
+    });
+
+    test('zonedScheduleBatch', () async {
+      await linuxPlugin.initialize(
+          LinuxInitializationSettings(notificationNotifier: notifier));
+      tz.initializeTimeZones();
+      tz.setLocalLocation(tz.getLocation('Europe/Berlin'));
+      final tz.TZDateTime scheduledDate =
+          tz.TZDateTime.now(tz.local).add(const Duration(days: 1));
+      final List<PlatformException> errors =
+          await linuxPlugin.zonedScheduleBatch(<LinuxZonedScheduleRequest>[
+        LinuxZonedScheduleRequest(
+            1, 'daily title', 'daily body', scheduledDate,
+            matchDateTimeComponents: DateTimeComponents.time),
+        LinuxZonedScheduleRequest(
+            2, 'once title', 'once body', scheduledDate,
+            payload: 'once'),
+      ]);
+      expect(
+          log.last,
+          isMethodCall('zonedScheduleBatch', arguments: <Map<String, Object>>[
+            <String, Object>{
+              'id': 1,
+              'title': 'daily title',
+              'body': 'daily body',
+              'payload': '',
+              'platformSpecifics': null,
+              'matchDateTimeComponents': DateTimeComponents.time.index,
+              'timeZoneName': 'Europe/Berlin',
+              'scheduledDateTime': _convertDateToISO8601String(scheduledDate),
+            },
+            <String, Object>{
+              'id': 2,
+              'title': 'once title',
+              'body': 'once body',
+              'payload': 'once',
+              'platformSpecifics': null,
+              'timeZoneName': 'Europe/Berlin',
+              'scheduledDateTime': _convertDateToISO8601String(scheduledDate),
+            },
+          ]));
+      expect(errors[0], isNull);
+      expect(errors[1].code, 'invalid_request');
+      expect(notifier.created, <int>[1]);
+    });
+
+    test('cancelBatch', () async {
+      await linuxPlugin.initialize(
+          LinuxInitializationSettings(notificationNotifier: notifier));
+      final List<PlatformException> errors =
+          await linuxPlugin.cancelBatch(<int>[4, 5, 6]);
+      expect(log.last, isMethodCall('cancelBatch', arguments: <int>[4, 5, 6]));
+      expect(errors[0], isNull);
+      expect(errors[1].code, 'invalid_request');
+      expect(errors[2], isNull);
+      expect(notifier.destroyed, <int>[4, 6]);
+    });
+
+    test('cancel', () async {
+      await flutterLocalNotificationsPlugin.cancel(1);
+      expect(log, <Matcher>[isMethodCall('cancel', arguments: 1)]);
+    });
+
+    test('cancel through the binary channel', () async {
+      await flutterLocalNotificationsPlugin.initialize(
+          const InitializationSettings(
+              linux: LinuxInitializationSettings(useBinaryChannel: true)));
+      await flutterLocalNotificationsPlugin.cancel(1);
+      expect(log.map((MethodCall c) => c.method), <String>['initialize']);
+      expect(binaryLog, <List<int>>[
+        <int>[2, 1, 0, 0, 0]
+      ]);
+    });
+
+    test('cancelAll', () async {
+      await linuxPlugin.initialize(
+          LinuxInitializationSettings(notificationNotifier: notifier));
+      await flutterLocalNotificationsPlugin.cancelAll();
+      expect(log.last, isMethodCall('cancelAll', arguments: null));
+      expect(notifier.destroyed, <int>[1, 2]);
+    });
+
+    test('getAdmissionStats', () async {
+      final LinuxAdmissionStats stats = await linuxPlugin.getAdmissionStats();
+      expect(log,
+          <Matcher>[isMethodCall('getAdmissionStats', arguments: null)]);
+      expect(stats.queued, 1);
+      expect(stats.sent, 2);
+      expect(stats.deferred, 3);
+      expect(stats.dropped, 4);
+    });
+
+    test('getStats', () async {
+      final LinuxPluginStats stats = await linuxPlugin.getStats();
+      expect(log, <Matcher>[isMethodCall('getStats', arguments: null)]);
+      expect(stats.enabled, isTrue);
+      expect(stats.activeCount, 5);
+      expect(stats.scheduledCount, 6);
+      expect(stats.repeatingCount, 7);
+      expect(stats.queuedCount, 1);
+      expect(stats.inFlightCount, 0);
+      expect(stats.droppedCount, 4);
+      expect(stats.methods.keys, <String>['show']);
+      final LinuxHistogram show = stats.methods['show'];
+      expect(show.unit, 'ns');
+      expect(show.count, 2);
+      expect(show.mean, 1500);
+      expect(show.max, 2000);
+      expect(show.buckets, <int>[0, 0, 2]);
+      expect(stats.send, isNull);
+      expect(stats.fireLateness, isNull);
+    });
+
+    test('notificationsEvicted destroys the evicted notifications', () async {
+      await linuxPlugin.initialize(
+          LinuxInitializationSettings(notificationNotifier: notifier));
+      await ServicesBinding.instance.defaultBinaryMessenger
+          .handlePlatformMessage(
+              channel.name,
+              channel.codec.encodeMethodCall(MethodCall(
+                  'notificationsEvicted', Int64List.fromList(<int>[7, 8]))),
+              (ByteData reply) {});
+      expect(notifier.destroyed, <int>[7, 8]);
+      expect(notifier.created, isEmpty);
+    });
+
+    test('notificationsEvicted without notification notifier', () async {
+      await linuxPlugin.initialize(const LinuxInitializationSettings());
+      ByteData reply;
+      await ServicesBinding.instance.defaultBinaryMessenger
+          .handlePlatformMessage(
+              channel.name,
+              channel.codec.encodeMethodCall(MethodCall(
+                  'notificationsEvicted', Int64List.fromList(<int>[7, 8]))),
+              (ByteData data) => reply = data);
+      expect(channel.codec.decodeEnvelope(reply), isNull);
+    });
+
+    group('binary codec', () {
+      // Shared with the native tests of linux/binary_codec.cc, so that both
+      // sides agree on the same bytes.
+      final Map<String, List<int>> goldens =
+          _readGoldens('test/fixtures/linux_binary_codec.txt');
+
+      List<int> bytesOf(ByteData message) => message.buffer
+          .asUint8List(message.offsetInBytes, message.lengthInBytes);
+
+      test('encodeCancel', () {
+        expect(bytesOf(encodeCancel(0x01020304)), goldens['cancel']);
+      });
+
+      test('encodeShow without details', () {
+        expect(bytesOf(encodeShow(1, 'Hi', 'Yo', null, null)),
+            goldens['showWithoutDetails']);
+      });
+
+      test('encodeShow with details', () {
+        const LinuxNotificationDetails details = LinuxNotificationDetails(
+          icon: ThemeLinuxIcon('x'),
+          buttons: <LinuxNotificationButton>{
+            LinuxNotificationButton(label: 'OK', payload: 'ok'),
+          },
+          priority: LinuxNotificationPriority.high,
+          misfirePolicy: LinuxMisfirePolicy.skip,
+          groupKey: 'g',
+        );
+        expect(bytesOf(encodeShow(-1, null, null, 'p', details)),
+            goldens['showWithDetails']);
+      });
+
+      test('encodeShow with byte data icon', () {
+        final LinuxNotificationDetails details = LinuxNotificationDetails(
+            icon: ByteDataLinuxIcon(Uint8List.fromList(<int>[0, 255])));
+        expect(bytesOf(encodeShow(1, null, null, '', details)),
+            goldens['showWithBytesIcon']);
+      });
+
+      test('encodeZonedSchedule', () {
+        expect(
+            bytesOf(encodeZonedSchedule(2, null, null, 'p', null, 'UTC',
+                '2030-01-01T09:30:00', DateTimeComponents.time.index)),
+            goldens['zonedScheduleDaily']);
+      });
+
+      test('encodeZonedSchedule without repeating', () {
+        expect(
+            bytesOf(encodeZonedSchedule(
+                2, null, null, 'p', null, 'UTC', '2030-01-01T09:30:00', null)),
+            goldens['zonedScheduleOnce']);
+      });
+
+      test('decodeBinaryReply', () {
+        expect(decodeBinaryReply(ByteData(0)), isNull);
+        final Uint8List reply = Uint8List.fromList(goldens['errorReply']);
+        final PlatformException error =
+            decodeBinaryReply(ByteData.view(reply.buffer));
+        expect(error.code, 'code');
+        expect(error.message, 'message');
+      });
+    });
+  });
 }
 
 String _convertDateToISO8601String(tz.TZDateTime dateTime) {
@@ -2667,3 +3103,35 @@ String _convertDateToISO8601String(tz.TZDateTime dateTime) {
 
   return '${_fourDigits(dateTime.year)}-${_twoDigits(dateTime.month)}-${_twoDigits(dateTime.day)}T${_twoDigits(dateTime.hour)}:${_twoDigits(dateTime.minute)}:${_twoDigits(dateTime.second)}'; // ignore: lines_longer_than_80_chars
 }
+
+/// Reads the named byte strings of a golden file, one `name: hex bytes` per
+/// line, where whitespace within the bytes and lines starting with `#` are
+/// ignored.
+Map<String, List<int>> _readGoldens(String path) {
+  final Map<String, List<int>> goldens = <String, List<int>>{};
+  for (final String line in File(path).readAsLinesSync()) {
+    if (line.trim().isEmpty || line.startsWith('#')) {
+      continue;
+    }
+    final int separator = line.indexOf(':');
+    final String hex =
+        line.substring(separator + 1).replaceAll(RegExp(r'\s'), '');
+    goldens[line.substring(0, separator)] = List<int>.generate(hex.length ~/ 2,
+        (int i) => int.parse(hex.substring(2 * i, 2 * i + 2), radix: 16));
+  }
+  return goldens;
+}
+
+class _RecordingLinuxNotificationNotifier
+    implements LinuxNotificationNotifier {
+  final List<int> created = <int>[];
+  final List<int> destroyed = <int>[];
+
+  @override
+  void onNewNotificationCreated(int notificationId) =>
+      created.add(notificationId);
+
+  @override
+  void onNotificationDestroyed(int notificationId) =>
+      destroyed.add(notificationId);
+}